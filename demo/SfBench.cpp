@@ -0,0 +1,685 @@
+
+// Serialization benchmarks for SF.
+//
+// Usage: sf_bench [--csv] [--filter <text>] [--min-time <ms>]
+//
+// Each case is serialized and deserialized repeatedly, for at least the given time per direction
+// (default 200 ms). Reported figures are per operation, where an operation reads or writes the whole
+// value of the case: elapsed time, archive size, and number of heap allocations. With --csv, results
+// are written as comma separated values with a header row, for regression tracking.
+//
+// Figures are only meaningful from an optimized build, e.g. with -DCMAKE_BUILD_TYPE=Release.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <RCF/RCF.hpp>
+#include <RCF/ByteBuffer.hpp>
+#include <RCF/MemStream.hpp>
+
+#include <SF/IBinaryStream.hpp>
+#include <SF/OBinaryStream.hpp>
+#include <SF/Registry.hpp>
+#include <SF/SerializeParent.hpp>
+#include <SF/boost/any.hpp>
+#include <SF/map.hpp>
+#include <SF/string.hpp>
+#include <SF/vector.hpp>
+
+//------------------------------------------------------------------------------
+// Allocation counting
+
+// Replacing the global allocation functions counts every allocation made by the process, including
+// those made from within RcfLib. Array new and the nothrow forms forward to these by default.
+
+static std::atomic<std::uint64_t> gAllocCount(0);
+
+void * operator new(std::size_t size)
+{
+    gAllocCount.fetch_add(1, std::memory_order_relaxed);
+    void * p = std::malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void * p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+//------------------------------------------------------------------------------
+// Test types
+
+// Each node points back at up to two earlier nodes, so every edge after the first
+// visit is serialized as a back reference and the recursion depth stays at one.
+class GraphNode
+{
+public:
+    GraphNode() : mId(0), mpParent(), mpSibling()
+    {}
+
+    int             mId;
+    std::string     mName;
+    GraphNode *     mpParent;
+    GraphNode *     mpSibling;
+
+    void serialize(SF::Archive & ar)
+    {
+        ar & mId & mName & mpParent & mpSibling;
+    }
+};
+
+typedef std::vector<GraphNode *> Graph;
+
+void makeGraph(Graph & graph, std::size_t nodeCount)
+{
+    graph.resize(nodeCount);
+    for (std::size_t i=0; i<nodeCount; ++i)
+    {
+        GraphNode * pNode = new GraphNode();
+        pNode->mId = static_cast<int>(i);
+        pNode->mName = "node";
+        pNode->mpParent = i > 0 ? graph[(i-1)/2] : NULL;
+        pNode->mpSibling = i > 1 ? graph[(i*7919) % i] : NULL;
+        graph[i] = pNode;
+    }
+}
+
+template<typename T>
+void freePtrs(std::vector<T *> & ptrs)
+{
+    for (std::size_t i=0; i<ptrs.size(); ++i)
+    {
+        delete ptrs[i];
+    }
+    ptrs.clear();
+}
+
+// Polymorphic types, serialized through base class pointers.
+class Shape
+{
+public:
+    Shape() : mX(0), mY(0)
+    {}
+
+    virtual ~Shape()
+    {}
+
+    double mX;
+    double mY;
+
+    void serialize(SF::Archive & ar)
+    {
+        ar & mX & mY;
+    }
+};
+
+class Circle : public Shape
+{
+public:
+    Circle() : mRadius(0)
+    {}
+
+    double mRadius;
+
+    void serialize(SF::Archive & ar)
+    {
+        SF::serializeParent<Shape>(ar, *this);
+        ar & mRadius;
+    }
+};
+
+class Rectangle : public Shape
+{
+public:
+    Rectangle() : mWidth(0), mHeight(0)
+    {}
+
+    double      mWidth;
+    double      mHeight;
+    std::string mLabel;
+
+    void serialize(SF::Archive & ar)
+    {
+        SF::serializeParent<Shape>(ar, *this);
+        ar & mWidth & mHeight & mLabel;
+    }
+};
+
+typedef std::vector<Shape *> Shapes;
+
+void makeShapes(Shapes & shapes, std::size_t count)
+{
+    shapes.resize(count);
+    for (std::size_t i=0; i<count; ++i)
+    {
+        if (i % 2)
+        {
+            Circle * pCircle = new Circle();
+            pCircle->mRadius = static_cast<double>(i);
+            shapes[i] = pCircle;
+        }
+        else
+        {
+            Rectangle * pRect = new Rectangle();
+            pRect->mWidth = static_cast<double>(i);
+            pRect->mHeight = 1.0;
+            pRect->mLabel = "rectangle";
+            shapes[i] = pRect;
+        }
+        shapes[i]->mX = static_cast<double>(i);
+        shapes[i]->mY = -static_cast<double>(i);
+    }
+}
+
+void registerTypes()
+{
+    SF::registerType( (Circle *) 0, "Circle");
+    SF::registerType( (Rectangle *) 0, "Rectangle");
+    SF::registerBaseAndDerived( (Shape *) 0, (Circle *) 0);
+    SF::registerBaseAndDerived( (Shape *) 0, (Rectangle *) 0);
+
+    SF::registerType( (std::int32_t *) 0, "int32");
+    SF::registerType( (double *) 0, "double");
+    SF::registerType( (std::string *) 0, "string");
+    SF::registerAny( (std::int32_t *) 0);
+    SF::registerAny( (double *) 0);
+    SF::registerAny( (std::string *) 0);
+}
+
+//------------------------------------------------------------------------------
+// Benchmark cases
+
+class BenchCase
+{
+public:
+    BenchCase(const std::string & name, bool pointerTracking) :
+        mName(name),
+        mPointerTracking(pointerTracking)
+    {}
+
+    virtual ~BenchCase()
+    {}
+
+    const std::string & getName() const
+    {
+        return mName;
+    }
+
+    bool getPointerTracking() const
+    {
+        return mPointerTracking;
+    }
+
+    virtual void write(SF::OBinaryStream & out) = 0;
+
+    // Reads a fresh copy of the value.
+    virtual void read(SF::IBinaryStream & in) = 0;
+
+    // Checks and releases the copy made by read(). Not timed.
+    virtual bool verifyAndReset() = 0;
+
+private:
+    std::string     mName;
+    bool            mPointerTracking;
+};
+
+typedef std::shared_ptr<BenchCase> BenchCasePtr;
+
+template<typename T, typename Compare>
+class ValueCase : public BenchCase
+{
+public:
+    ValueCase(const std::string & name, const T & value, Compare compare) :
+        BenchCase(name, false),
+        mValue(value),
+        mCompare(compare)
+    {}
+
+    void write(SF::OBinaryStream & out)
+    {
+        out << mValue;
+    }
+
+    void read(SF::IBinaryStream & in)
+    {
+        in >> mCopy;
+    }
+
+    bool verifyAndReset()
+    {
+        bool ok = mCompare(mValue, mCopy);
+        mCopy = T();
+        return ok;
+    }
+
+private:
+    T           mValue;
+    T           mCopy;
+    Compare     mCompare;
+};
+
+template<typename T, typename Compare>
+BenchCasePtr makeValueCase(const std::string & name, const T & value, Compare compare)
+{
+    return BenchCasePtr( new ValueCase<T, Compare>(name, value, compare) );
+}
+
+struct Equal
+{
+    template<typename T>
+    bool operator()(const T & lhs, const T & rhs) const
+    {
+        return lhs == rhs;
+    }
+};
+
+struct EqualBuffers
+{
+    bool operator()(const RCF::ByteBuffer & lhs, const RCF::ByteBuffer & rhs) const
+    {
+        return
+                lhs.getLength() == rhs.getLength()
+            &&  0 == memcmp(lhs.getPtr(), rhs.getPtr(), lhs.getLength());
+    }
+};
+
+struct EqualAnys
+{
+    bool operator()(const std::vector<boost::any> & lhs, const std::vector<boost::any> & rhs) const
+    {
+        if (lhs.size() != rhs.size())
+        {
+            return false;
+        }
+        for (std::size_t i=0; i<lhs.size(); ++i)
+        {
+            if (lhs[i].type() != rhs[i].type())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+class ShapesCase : public BenchCase
+{
+public:
+    ShapesCase(const std::string & name, std::size_t count, bool pointerTracking) :
+        BenchCase(name, pointerTracking)
+    {
+        makeShapes(mShapes, count);
+    }
+
+    ~ShapesCase()
+    {
+        freePtrs(mShapes);
+        freePtrs(mCopy);
+    }
+
+    void write(SF::OBinaryStream & out)
+    {
+        out << mShapes;
+    }
+
+    void read(SF::IBinaryStream & in)
+    {
+        in >> mCopy;
+    }
+
+    bool verifyAndReset()
+    {
+        bool ok =
+                mCopy.size() == mShapes.size()
+            &&  (mCopy.size() < 2 || dynamic_cast<Circle *>(mCopy[1]) != NULL);
+
+        freePtrs(mCopy);
+        return ok;
+    }
+
+private:
+    Shapes mShapes;
+    Shapes mCopy;
+};
+
+class GraphCase : public BenchCase
+{
+public:
+    GraphCase(const std::string & name, std::size_t nodeCount) :
+        BenchCase(name, true)
+    {
+        makeGraph(mGraph, nodeCount);
+    }
+
+    ~GraphCase()
+    {
+        freePtrs(mGraph);
+        freePtrs(mCopy);
+    }
+
+    void write(SF::OBinaryStream & out)
+    {
+        out << mGraph;
+    }
+
+    void read(SF::IBinaryStream & in)
+    {
+        in >> mCopy;
+    }
+
+    bool verifyAndReset()
+    {
+        bool ok =
+                mCopy.size() == mGraph.size()
+            &&  (mCopy.size() < 3 || mCopy[2]->mpParent == mCopy[0]);
+
+        freePtrs(mCopy);
+        return ok;
+    }
+
+private:
+    Graph mGraph;
+    Graph mCopy;
+};
+
+void makeCases(std::vector<BenchCasePtr> & cases)
+{
+    std::vector<std::int32_t> ints(1000000);
+    for (std::size_t i=0; i<ints.size(); ++i)
+    {
+        ints[i] = static_cast<std::int32_t>(i);
+    }
+    cases.push_back( makeValueCase("vector_int32", ints, Equal()) );
+
+    std::vector<double> doubles(1000000);
+    for (std::size_t i=0; i<doubles.size(); ++i)
+    {
+        doubles[i] = 0.5*i;
+    }
+    cases.push_back( makeValueCase("vector_double", doubles, Equal()) );
+
+    std::vector<std::string> strings(100000);
+    for (std::size_t i=0; i<strings.size(); ++i)
+    {
+        strings[i].assign(8 + i % 56, static_cast<char>('a' + i % 26));
+    }
+    cases.push_back( makeValueCase("vector_string", strings, Equal()) );
+
+    typedef std::map<std::string, std::map<std::int32_t, std::string> > NestedMap;
+    NestedMap nestedMap;
+    for (std::int32_t i=0; i<1000; ++i)
+    {
+        std::map<std::int32_t, std::string> & inner = nestedMap["key" + std::to_string(i)];
+        for (std::int32_t j=0; j<100; ++j)
+        {
+            inner[j] = "value" + std::to_string(j);
+        }
+    }
+    cases.push_back( makeValueCase("nested_map", nestedMap, Equal()) );
+
+    cases.push_back( BenchCasePtr( new ShapesCase("polymorphic_ptrs", 100000, false) ) );
+    cases.push_back( BenchCasePtr( new ShapesCase("polymorphic_ptrs_tracked", 100000, true) ) );
+    cases.push_back( BenchCasePtr( new GraphCase("pointer_graph_tracked", 100000) ) );
+
+    std::vector<boost::any> anys(10000);
+    for (std::size_t i=0; i<anys.size(); ++i)
+    {
+        switch (i % 3)
+        {
+        case 0:     anys[i] = static_cast<std::int32_t>(i);     break;
+        case 1:     anys[i] = 0.5*i;                            break;
+        default:    anys[i] = std::string("any");               break;
+        }
+    }
+    cases.push_back( makeValueCase("vector_any", anys, EqualAnys()) );
+
+    RCF::ByteBuffer byteBuffer(16*1024*1024);
+    for (std::size_t i=0; i<byteBuffer.getLength(); ++i)
+    {
+        byteBuffer.getPtr()[i] = static_cast<char>(i);
+    }
+    cases.push_back( makeValueCase("byte_buffer_16mb", byteBuffer, EqualBuffers()) );
+}
+
+//------------------------------------------------------------------------------
+// Measurement
+
+typedef std::chrono::steady_clock Clock;
+
+struct BenchResult
+{
+    BenchResult() : mOps(0), mElapsed(Clock::duration::zero()), mBytes(0), mAllocs(0)
+    {}
+
+    std::uint64_t       mOps;
+    Clock::duration     mElapsed;
+    std::uint64_t       mBytes;
+    std::uint64_t       mAllocs;
+
+    double nsPerOp() const
+    {
+        double ns = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(mElapsed).count());
+        return ns / mOps;
+    }
+
+    double bytesPerOp() const
+    {
+        return static_cast<double>(mBytes) / mOps;
+    }
+
+    double allocsPerOp() const
+    {
+        return static_cast<double>(mAllocs) / mOps;
+    }
+
+    double mbPerSec() const
+    {
+        return bytesPerOp() / nsPerOp() * 1000.0;
+    }
+};
+
+// Archives are written to and read from memory, and the output buffer is reused, so the figures
+// reflect SF itself rather than stream buffer growth. The first operation in each direction is a
+// warm up and is not measured.
+void runCase(
+    BenchCase &         bench,
+    Clock::duration     minTime,
+    BenchResult &       writeResult,
+    BenchResult &       readResult)
+{
+    RCF::MemOstream os;
+
+    for (std::uint64_t i=0; i == 0 || writeResult.mElapsed < minTime || writeResult.mOps < 3; ++i)
+    {
+        os.rewind();
+
+        std::uint64_t allocs0 = gAllocCount.load();
+        Clock::time_point t0 = Clock::now();
+
+        {
+            SF::OBinaryStream out(os);
+            out.setEnablePointerTracking(bench.getPointerTracking());
+            bench.write(out);
+        }
+
+        Clock::time_point t1 = Clock::now();
+        std::uint64_t allocs1 = gAllocCount.load();
+
+        if (i > 0)
+        {
+            writeResult.mOps += 1;
+            writeResult.mElapsed += t1 - t0;
+            writeResult.mBytes += os.tellp();
+            writeResult.mAllocs += allocs1 - allocs0;
+        }
+    }
+
+    std::size_t len = static_cast<std::size_t>(os.tellp());
+    RCF::MemIstream is;
+
+    for (std::uint64_t i=0; i == 0 || readResult.mElapsed < minTime || readResult.mOps < 3; ++i)
+    {
+        is.reset(os.str(), len);
+
+        std::uint64_t allocs0 = gAllocCount.load();
+        Clock::time_point t0 = Clock::now();
+
+        {
+            SF::IBinaryStream in(is);
+            bench.read(in);
+        }
+
+        Clock::time_point t1 = Clock::now();
+        std::uint64_t allocs1 = gAllocCount.load();
+
+        if (!bench.verifyAndReset())
+        {
+            RCF_THROW(RCF::Exception("Case did not round trip: " + bench.getName()));
+        }
+
+        if (i > 0)
+        {
+            readResult.mOps += 1;
+            readResult.mElapsed += t1 - t0;
+            readResult.mBytes += len;
+            readResult.mAllocs += allocs1 - allocs0;
+        }
+    }
+}
+
+void printHeader(bool csv)
+{
+    if (csv)
+    {
+        std::cout << "case,op,ops,ns_per_op,bytes_per_op,allocs_per_op,mb_per_sec" << std::endl;
+    }
+    else
+    {
+        std::cout
+            << std::left << std::setw(28) << "Case"
+            << std::setw(8) << "Op"
+            << std::right << std::setw(8) << "Ops"
+            << std::setw(16) << "ns/op"
+            << std::setw(14) << "bytes/op"
+            << std::setw(14) << "allocs/op"
+            << std::setw(10) << "MB/s"
+            << std::endl;
+    }
+}
+
+void printResult(bool csv, const std::string & name, const char * op, const BenchResult & result)
+{
+    if (csv)
+    {
+        std::cout
+            << name << ","
+            << op << ","
+            << result.mOps << ","
+            << std::fixed << std::setprecision(1)
+            << result.nsPerOp() << ","
+            << result.bytesPerOp() << ","
+            << std::setprecision(2)
+            << result.allocsPerOp() << ","
+            << result.mbPerSec()
+            << std::endl;
+    }
+    else
+    {
+        std::cout
+            << std::left << std::setw(28) << name
+            << std::setw(8) << op
+            << std::right << std::setw(8) << result.mOps
+            << std::fixed << std::setprecision(0)
+            << std::setw(16) << result.nsPerOp()
+            << std::setw(14) << result.bytesPerOp()
+            << std::setprecision(1)
+            << std::setw(14) << result.allocsPerOp()
+            << std::setw(10) << result.mbPerSec()
+            << std::endl;
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    RCF::RcfInit rcfInit;
+
+    bool csv = false;
+    std::string filter;
+    Clock::duration minTime = std::chrono::milliseconds(200);
+
+    for (int i=1; i<argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--csv")
+        {
+            csv = true;
+        }
+        else if (arg == "--filter" && i+1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if (arg == "--min-time" && i+1 < argc)
+        {
+            minTime = std::chrono::milliseconds( std::strtoul(argv[++i], NULL, 10) );
+        }
+        else
+        {
+            std::cout << "Usage: sf_bench [--csv] [--filter <text>] [--min-time <ms>]" << std::endl;
+            return 1;
+        }
+    }
+
+    try
+    {
+        registerTypes();
+
+        std::vector<BenchCasePtr> cases;
+        makeCases(cases);
+
+        printHeader(csv);
+
+        for (std::size_t i=0; i<cases.size(); ++i)
+        {
+            BenchCase & bench = *cases[i];
+            if (!filter.empty() && bench.getName().find(filter) == std::string::npos)
+            {
+                continue;
+            }
+
+            BenchResult writeResult;
+            BenchResult readResult;
+            runCase(bench, minTime, writeResult, readResult);
+
+            printResult(csv, bench.getName(), "write", writeResult);
+            printResult(csv, bench.getName(), "read", readResult);
+        }
+    }
+    catch(const RCF::Exception & e)
+    {
+        std::cout << "Caught exception:\n";
+        std::cout << e.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_RCF_ARRAYVIEW_HPP
+#define INCLUDE_RCF_ARRAYVIEW_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <RCF/ByteBuffer.hpp>
+#include <RCF/Export.hpp>
+
+namespace RCF {
+
+    class ArrayViewBase;
+
+} // namespace RCF
+
+namespace SF {
+
+    class Archive;
+
+    RCF_EXPORT void serializeArrayView(
+        SF::Archive &           ar,
+        RCF::ArrayViewBase &    view,
+        std::size_t             elementSize,
+        std::size_t             elementAlign);
+
+} // namespace SF
+
+namespace RCF {
+
+    /// Base class of StringView and ArrayView<>.
+    class RCF_EXPORT ArrayViewBase
+    {
+    public:
+
+        /// Returns the buffer holding the viewed data. Empty if the view refers to memory owned by the application.
+        const ByteBuffer &  getByteBuffer() const;
+
+        /// Returns true if the view was deserialized by pointing into the received message buffer, rather than by copying.
+        bool                isBorrowed() const;
+
+    protected:
+
+        ArrayViewBase();
+        ArrayViewBase(const void * pData, std::size_t count);
+
+        const char *        mpData;
+        std::size_t         mCount;
+        ByteBuffer          mBuffer;
+        bool                mBorrowed;
+
+    private:
+
+        friend void SF::serializeArrayView(SF::Archive &, ArrayViewBase &, std::size_t, std::size_t);
+    };
+
+    /// Read-only view of a character string.
+
+    /// StringView has the same wire format as std::string, and can be used as a remote call parameter in place of
+    /// std::string. When deserialized from a remote call, a StringView points directly into the received message
+    /// buffer, rather than copying the string into a newly allocated container. The view holds a reference on the
+    /// message buffer, so the data remains valid for as long as the view does.
+    class StringView : public ArrayViewBase
+    {
+    public:
+
+        StringView()
+        {}
+
+        StringView(const char * psz) : ArrayViewBase(psz, strlen(psz))
+        {}
+
+        StringView(const char * pch, std::size_t len) : ArrayViewBase(pch, len)
+        {}
+
+        StringView(const std::string & s) : ArrayViewBase(s.data(), s.size())
+        {}
+
+        const char *    data() const        { return mpData; }
+        std::size_t     size() const        { return mCount; }
+        std::size_t     length() const      { return mCount; }
+        bool            empty() const       { return mCount == 0; }
+        const char *    begin() const       { return mpData; }
+        const char *    end() const         { return mpData + mCount; }
+
+        char operator[](std::size_t idx) const
+        {
+            return mpData[idx];
+        }
+
+        /// Copies the viewed characters into a std::string.
+        std::string str() const
+        {
+            return std::string(mpData, mCount);
+        }
+    };
+
+    inline bool operator==(const StringView & lhs, const StringView & rhs)
+    {
+        return lhs.size() == rhs.size() && (lhs.size() == 0 || 0 == memcmp(lhs.data(), rhs.data(), lhs.size()));
+    }
+
+    inline bool operator!=(const StringView & lhs, const StringView & rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    /// Read-only view of an array of fundamental types.
+
+    /// ArrayView<T> has the same wire format as std::vector<T>, and can be used as a remote call parameter in place
+    /// of std::vector<T>. When deserialized from a remote call, an ArrayView<T> points directly into the received
+    /// message buffer, rather than copying the elements into a newly allocated container. The elements are copied
+    /// if they need byte reordering, or if they are not suitably aligned within the message buffer.
+    template<typename T>
+    class ArrayView : public ArrayViewBase
+    {
+    public:
+
+        static_assert(
+            std::is_fundamental<T>::value && !std::is_same<T, bool>::value,
+            "ArrayView<> can only be used with fundamental types other than bool.");
+
+        typedef T value_type;
+
+        ArrayView()
+        {}
+
+        ArrayView(const T * pt, std::size_t count) : ArrayViewBase(pt, count)
+        {}
+
+        template<typename A>
+        ArrayView(const std::vector<T, A> & vec) : ArrayViewBase(vec.empty() ? NULL : &vec[0], vec.size())
+        {}
+
+        const T *       data() const        { return reinterpret_cast<const T *>(mpData); }
+        std::size_t     size() const        { return mCount; }
+        bool            empty() const       { return mCount == 0; }
+        const T *       begin() const       { return data(); }
+        const T *       end() const         { return data() + mCount; }
+
+        const T & operator[](std::size_t idx) const
+        {
+            return data()[idx];
+        }
+
+        /// Copies the viewed elements into a std::vector.
+        std::vector<T> toVector() const
+        {
+            return std::vector<T>(begin(), end());
+        }
+    };
+
+} // namespace RCF
+
+namespace SF {
+
+    inline void serialize(SF::Archive & ar, RCF::StringView & s)
+    {
+        serializeArrayView(ar, s, 1, 1);
+    }
+
+    template<typename T>
+    inline void serialize(SF::Archive & ar, RCF::ArrayView<T> & v)
+    {
+        serializeArrayView(ar, v, sizeof(T), std::alignment_of<T>::value);
+    }
+
+} // namespace SF
+
+#endif // ! INCLUDE_RCF_ARRAYVIEW_HPP
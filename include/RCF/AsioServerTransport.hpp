@@ -19,6 +19,7 @@
 #ifndef INCLUDE_RCF_ASIOSERVERTRANSPORT_HPP
 #define INCLUDE_RCF_ASIOSERVERTRANSPORT_HPP
 
+#include <atomic>
 #include <memory>
 #include <set>
 #include <vector>
@@ -38,6 +39,7 @@ namespace RCF {
     class TcpClientTransport;
     class AsioNetworkSession;
     class AsioServerTransport;
+    class AsioIncrementalRead;
 
     typedef std::shared_ptr<AsioNetworkSession>         AsioNetworkSessionPtr;
     typedef std::weak_ptr<AsioNetworkSession>           AsioNetworkSessionWeakPtr;
@@ -147,6 +149,9 @@ namespace RCF {
         volatile bool                   mStopFlag;
         RcfServer *                     mpServer;
 
+        friend class AsioIncrementalRead;
+        std::atomic<std::size_t>        mIncrementalReadCount;
+
     private:
 
         virtual AsioNetworkSessionPtr     implCreateNetworkSession() = 0;
@@ -275,6 +280,13 @@ namespace RCF {
         void            doCustomFraming(size_t bytesTransferred);
         void            doRegularFraming(size_t bytesTransferred);
 
+        bool            shouldReadIncrementally();
+        void            beginIncrementalRead();
+        void            endIncrementalRead();
+
+        void            beginReadChunk(std::uint32_t frameLength);
+        void            onReadChunkCompleted();
+
         // TODO: too many friends
         friend class    AsioServerTransport;
         friend class    TcpNetworkSession;
@@ -324,17 +336,28 @@ namespace RCF {
 
         std::shared_ptr<Mutex>    mSocketOpsMutexPtr;
 
+        // Request that is being processed while it is still being read.
+        std::shared_ptr<AsioIncrementalRead>    mIncrementalReadPtr;
+
+        // Chunks of the last message read, if it was sent with chunked framing.
+        std::vector<ByteBuffer>     mReadChunks;
+        std::size_t                 mReadChunksLen;
+        bool                        mReadChunked;
+        bool                        mReadFinalFrame;
+
         // I_NetworkSession
 
     private:
         
         void                    postRead();
         ByteBuffer              getReadByteBuffer();
+        void                    getReadChunks(std::vector<ByteBuffer> & chunks);
         void                    postWrite(std::vector<ByteBuffer> &byteBuffers);
         void                    postClose();
         ServerTransport &       getServerTransport();
         const RemoteAddress &   getRemoteAddress();
         bool                    isConnected();
+        MemIstreamSourcePtr     getIncrementalReadSource();
 
     private:
 
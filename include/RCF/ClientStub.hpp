@@ -260,6 +260,39 @@ namespace RCF {
         /// Gets pointer tracking mode when using SF serialization.
         bool                    getEnableSfPointerTracking() const;
 
+        /// Enables sizing of outgoing request messages. 
+        
+        /// When enabled, the message buffer is allocated at its final size before the parameters are serialized. 
+        /// The size is taken from the previous request with the same method, or else measured with a sizing pass 
+        /// over the parameters. Sizing passes are only made with SF binary serialization.
+        void                    setEnableSizingPass(bool enable);
+
+        /// Gets a value indicating if sizing of outgoing request messages is enabled.
+        bool                    getEnableSizingPass() const;
+
+        /// Sets the chunk size for chunked framing of request messages. 
+        
+        /// With a non-zero chunk size, requests are sent as a sequence of frames of at most chunkSize bytes, so 
+        /// messages are not limited by the length field of a single frame, and the server stores the message as a 
+        /// chain of buffers rather than in a single allocation. The server needs to support chunked framing, and 
+        /// replies with chunked framing as well. Chunked framing is only used on TCP and local transports. Sizes 
+        /// below 4 KB are rounded up. Defaults to zero, which disables chunked framing.
+        void                    setMessageChunkSize(std::size_t chunkSize);
+
+        /// Gets the chunk size for chunked framing of request messages.
+        std::size_t             getMessageChunkSize() const;
+
+        /// Enables binding IDs. 
+
+        /// When enabled, the server assigns a compact binding ID to the servant binding name, in the response to 
+        /// the first call on a connection. Subsequent requests on the connection carry the binding ID instead of 
+        /// the binding name, and the server resolves it without looking up the servant binding by name. Binding 
+        /// IDs are not used if the server does not support them.
+        void                    setEnableBindingIds(bool enable);
+
+        /// Gets a value indicating if binding IDs are enabled.
+        bool                    getEnableBindingIds() const;
+
         /// Sets the auto-versioning property. 
         
         /// If auto-versioning is enabled, the RCF client will automatically adjust the RCF runtime version 
@@ -608,7 +641,8 @@ namespace RCF {
                                     std::string & uploadId,
                                     std::uint32_t chunkSize,
                                     std::uint32_t transferRateBps,
-                                    std::uint32_t sessionLocalId);
+                                    std::uint32_t sessionLocalId,
+                                    bool compressChunks = false);
 
         void                    downloadFiles(
                                     const Path& downloadToPath,
@@ -618,7 +652,10 @@ namespace RCF {
                                     std::uint32_t sessionLocalId,
                                     const std::string & downloadId,
                                     std::uint64_t startPos = 0,
-                                    std::uint64_t endPos = -1);
+                                    std::uint64_t endPos = -1,
+                                    std::uint32_t stripeCount = 1,
+                                    bool deltaSync = false,
+                                    bool compressChunks = false);
 
         std::uint32_t           addUploadStream(FileUpload fileStream);
         void                    processUploadStreams();
@@ -670,6 +707,7 @@ namespace RCF {
 
         friend class FutureConverterBase;
         friend class FutureImplBase;
+        friend class PublisherBase;
 
         template<
             typename R, 
@@ -715,6 +753,9 @@ namespace RCF {
         void                enrol(
                                 I_Future *pFuture);
 
+        void                addCompletionHandler(
+                                std::function<void()> handler);
+
         void                init( 
                                 int fnId, 
                                 RCF::RemoteCallMode rcs);
@@ -786,6 +827,10 @@ namespace RCF {
 
         const std::vector<FilterPtr> &getMessageFilters();
 
+        void                    decodeChunkedResponse(
+                                    std::vector<ByteBuffer> &       chunks,
+                                    MethodInvocationResponse &      response);
+
         std::vector<char> &     getRetValVec();
 
 
@@ -823,6 +868,10 @@ namespace RCF {
 
         bool                        mEnableSfPointerTracking;
         bool                        mEnableNativeWstringSerialization = false;
+        bool                        mEnableSizingPass = false;
+        std::size_t                 mMessageChunkSize = 0;
+        bool                        mEnableBindingIds = false;
+        int                         mBindingId = 0;
 
         std::vector<I_Future *>     mFutures;
 
@@ -833,6 +882,7 @@ namespace RCF {
         bool                        mAsync;
         AsyncOpType                 mAsyncOpType;
         std::function<void()>       mAsyncCallback;
+        std::vector< std::function<void()> > mCompletionHandlers;
         std::unique_ptr<Exception>  mAsyncException;
         unsigned int                mEndTimeMs;
         bool                        mRetry;
@@ -179,6 +179,10 @@ namespace RCF {
 
         virtual void getProgressInfo(RemoteCallProgressInfo & info);
 
+        // Retrieves the chunks of the last message received, if it was sent with chunked framing. Otherwise chunks 
+        // is left empty, and the message is returned through receive().
+        virtual void getReadChunks(std::vector<ByteBuffer> & chunks);
+
     private:
         std::size_t mMaxMessageLength;
         std::size_t mMaxOutgoingMessageLength;
@@ -164,6 +164,15 @@
 #endif
 #endif
 
+// Coroutine feature. Requires C++20 coroutine support from the compiler.
+#ifndef RCF_FEATURE_COROUTINES
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define RCF_FEATURE_COROUTINES          1
+#else
+#define RCF_FEATURE_COROUTINES          0
+#endif
+#endif
+
 // Custom allocator feature.
 #ifndef RCF_FEATURE_CUSTOM_ALLOCATOR
 #ifdef RCF_USE_CUSTOM_ALLOCATOR
@@ -71,6 +71,7 @@ namespace RCF {
         void                    onWriteCompleted(std::size_t bytes);
 
         void                    getProgressInfo(RemoteCallProgressInfo & info);
+        void                    getReadChunks(std::vector<ByteBuffer> & chunks);
 
         friend class HttpServerTransport;
         friend class AsioServerTransport;
@@ -142,6 +143,12 @@ namespace RCF {
         std::size_t                 mBytesRequested;
         ByteBuffer                  mReadBuffer2;        
 
+        // Chunks received so far, for messages sent with chunked framing.
+        std::vector<ByteBuffer>     mReadChunks;
+        std::size_t                 mReadChunksLen;
+        bool                        mReadChunked;
+        bool                        mReadFinalFrame;
+
     protected:
         friend class Subscription;
         OverlappedAmiPtr            mOverlappedPtr;
@@ -184,6 +191,8 @@ namespace RCF {
         void        onConnectCompleted(int err);
         
         void        transition();
+        void        beginReadChunk(std::uint32_t frameLength);
+        void        onReadChunksCompleted();
         void        onTransitionCompleted_(std::size_t bytesTransferred);
         void        issueRead(const ByteBuffer &buffer, std::size_t bytesToRead);
         void        issueWrite(const std::vector<ByteBuffer> &byteBuffers);
@@ -0,0 +1,395 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_RCF_COROUTINETASK_HPP
+#define INCLUDE_RCF_COROUTINETASK_HPP
+
+#include <RCF/Config.hpp>
+
+#if RCF_FEATURE_COROUTINES==1
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <RCF/Exception.hpp>
+#include <RCF/Future.hpp>
+#include <RCF/RcfSession.hpp>
+#include <RCF/RemoteCallContext.hpp>
+#include <RCF/ThreadLibrary.hpp>
+
+namespace RCF {
+
+    // Shared completion state of a CoroutineTask<>. Outlives the coroutine frame.
+    class CoroutineTaskStateBase : Noncopyable
+    {
+    public:
+
+        CoroutineTaskStateBase() : mDone(false)
+        {}
+
+        bool ready()
+        {
+            Lock lock(mMutex);
+            return mDone;
+        }
+
+        // Registers fn to run on completion. Returns false, without registering, if already complete.
+        bool addContinuation(std::function<void()> fn)
+        {
+            Lock lock(mMutex);
+            if (mDone)
+            {
+                return false;
+            }
+            mContinuations.push_back(fn);
+            return true;
+        }
+
+        // Runs fn on completion, or immediately if already complete.
+        void onComplete(std::function<void()> fn)
+        {
+            if (!addContinuation(fn))
+            {
+                fn();
+            }
+        }
+
+        void setException(std::exception_ptr ePtr)
+        {
+            mExceptionPtr = ePtr;
+            setDone();
+        }
+
+    protected:
+
+        void setDone()
+        {
+            std::vector< std::function<void()> > continuations;
+            {
+                Lock lock(mMutex);
+                RCF_ASSERT(!mDone);
+                mDone = true;
+                continuations.swap(mContinuations);
+            }
+            for (std::size_t i=0; i<continuations.size(); ++i)
+            {
+                continuations[i]();
+            }
+        }
+
+        void rethrowIfException()
+        {
+            if (mExceptionPtr)
+            {
+                std::rethrow_exception(mExceptionPtr);
+            }
+        }
+
+        Mutex                                   mMutex;
+        bool                                    mDone;
+        std::exception_ptr                      mExceptionPtr;
+        std::vector< std::function<void()> >    mContinuations;
+    };
+
+    template<typename T>
+    class CoroutineTaskState : public CoroutineTaskStateBase
+    {
+    public:
+
+        void setValue(T t)
+        {
+            mValue = std::move(t);
+            setDone();
+        }
+
+        T get()
+        {
+            RCF_ASSERT(ready());
+            rethrowIfException();
+            return mValue;
+        }
+
+    private:
+        T mValue = T();
+    };
+
+    template<>
+    class CoroutineTaskState<void> : public CoroutineTaskStateBase
+    {
+    public:
+
+        void setValue()
+        {
+            setDone();
+        }
+
+        void get()
+        {
+            RCF_ASSERT(ready());
+            rethrowIfException();
+        }
+    };
+
+    template<typename T>
+    class CoroutineTaskPromiseBase
+    {
+    public:
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void unhandled_exception()
+        {
+            mStatePtr->setException(std::current_exception());
+        }
+
+    protected:
+        std::shared_ptr< CoroutineTaskState<T> > mStatePtr = std::make_shared< CoroutineTaskState<T> >();
+    };
+
+    /// Coroutine return type for asynchronous servant implementations.
+
+    /// A servant method declared with RCF_METHOD_Rn() can be implemented as a coroutine returning CoroutineTask<R>.
+    /// RCF then creates a RemoteCallContext for the call, and commits it when the coroutine completes,
+    /// sending back either the return value or the exception thrown by the coroutine. Within the coroutine,
+    /// remote calls made through RcfClient<> can be co_await'ed, as can other CoroutineTask<> instances, without
+    /// blocking the server thread that dispatched the call.
+
+    /// CoroutineTask<> starts executing immediately when the coroutine is called, and has shallow copy semantics.
+    template<typename T>
+    class CoroutineTask
+    {
+    public:
+
+        class promise_type : public CoroutineTaskPromiseBase<T>
+        {
+        public:
+
+            CoroutineTask get_return_object()
+            {
+                return CoroutineTask(this->mStatePtr);
+            }
+
+            template<typename U>
+            void return_value(U && u)
+            {
+                this->mStatePtr->setValue( T(std::forward<U>(u)) );
+            }
+        };
+
+        /// Returns true if the coroutine has completed.
+        bool ready() const
+        {
+            return mStatePtr->ready();
+        }
+
+        /// Returns the value returned by the coroutine, or rethrows the exception it threw. The coroutine must have completed.
+        T get() const
+        {
+            return mStatePtr->get();
+        }
+
+        /// Registers a callback to run when the coroutine completes. If it has already completed, the callback is run immediately.
+        void onComplete(std::function<void()> fn)
+        {
+            mStatePtr->onComplete(fn);
+        }
+
+        bool await_ready() const
+        {
+            return ready();
+        }
+
+        bool await_suspend(std::coroutine_handle<> h)
+        {
+            return mStatePtr->addContinuation( [h]() { h.resume(); } );
+        }
+
+        T await_resume()
+        {
+            return get();
+        }
+
+    private:
+
+        CoroutineTask(std::shared_ptr< CoroutineTaskState<T> > statePtr) : mStatePtr(statePtr)
+        {}
+
+        std::shared_ptr< CoroutineTaskState<T> > mStatePtr;
+    };
+
+    template<>
+    class CoroutineTask<void>
+    {
+    public:
+
+        class promise_type : public CoroutineTaskPromiseBase<void>
+        {
+        public:
+
+            CoroutineTask get_return_object()
+            {
+                return CoroutineTask(this->mStatePtr);
+            }
+
+            void return_void()
+            {
+                this->mStatePtr->setValue();
+            }
+        };
+
+        bool ready() const
+        {
+            return mStatePtr->ready();
+        }
+
+        void get() const
+        {
+            mStatePtr->get();
+        }
+
+        void onComplete(std::function<void()> fn)
+        {
+            mStatePtr->onComplete(fn);
+        }
+
+        bool await_ready() const
+        {
+            return ready();
+        }
+
+        bool await_suspend(std::coroutine_handle<> h)
+        {
+            return mStatePtr->addContinuation( [h]() { h.resume(); } );
+        }
+
+        void await_resume()
+        {
+            get();
+        }
+
+    private:
+
+        CoroutineTask(std::shared_ptr< CoroutineTaskState<void> > statePtr) : mStatePtr(statePtr)
+        {}
+
+        std::shared_ptr< CoroutineTaskState<void> > mStatePtr;
+    };
+
+    // Awaiter for Future<>. The coroutine is resumed on the thread that completes the remote call.
+    template<typename T>
+    class FutureAwaiter
+    {
+    public:
+
+        FutureAwaiter(const Future<T> & future) : mFuture(future)
+        {}
+
+        bool await_ready()
+        {
+            return mFuture.ready();
+        }
+
+        void await_suspend(std::coroutine_handle<> h)
+        {
+            mFuture.onReady( [h]() { h.resume(); } );
+        }
+
+        T await_resume()
+        {
+            return *mFuture;
+        }
+
+    private:
+        Future<T> mFuture;
+    };
+
+    /// Allows a coroutine to co_await an asynchronous remote call.
+    template<typename T>
+    FutureAwaiter<T> operator co_await(const Future<T> & future)
+    {
+        return FutureAwaiter<T>(future);
+    }
+
+    /// Allows a coroutine to co_await a remote call directly, e.g. co_await client.method(...) . The call is performed asynchronously.
+    template<typename T>
+    FutureAwaiter<T> operator co_await(const FutureConverter<T> & fc)
+    {
+        Future<T> future(fc);
+        return FutureAwaiter<T>(future);
+    }
+
+    // Called by the server marshaling code, when a servant returns a CoroutineTask<>.
+    template<typename T, typename U>
+    void setServerReturnValue(bool assign, T & t, CoroutineTask<U> & task)
+    {
+        if (task.ready())
+        {
+            // Completed synchronously, so the response is sent in the usual way. The result is retrieved 
+            // even if it isn't needed, so that any exception from the coroutine is rethrown.
+            if (assign)
+            {
+                t = task.get();
+            }
+            else
+            {
+                task.get();
+            }
+            return;
+        }
+
+        // The coroutine has suspended. Take over the response, and send it when the coroutine completes.
+        typedef std::shared_ptr<RemoteCallContextImpl> RemoteCallContextPtr;
+        RemoteCallContextPtr contextPtr( new RemoteCallContextImpl(getCurrentRcfSession()) );
+        T * pt = &t;
+
+        task.onComplete( [contextPtr, pt, task]()
+        {
+            try
+            {
+                *pt = task.get();
+            }
+            catch (const std::exception & e)
+            {
+                contextPtr->commit(e);
+                return;
+            }
+            catch (...)
+            {
+                contextPtr->commit( Exception(RcfError_NonStdException) );
+                return;
+            }
+            contextPtr->commit();
+        });
+    }
+
+} // namespace RCF
+
+#endif // RCF_FEATURE_COROUTINES==1
+
+#endif // ! INCLUDE_RCF_COROUTINETASK_HPP
@@ -228,6 +228,38 @@ namespace RCF {
         St_Schannel
     };
 
+    /// Describes what a publisher does with a message published to a subscriber whose outbound queue is full.
+    /// See PublisherParms::setSubscriberQueueLimit().
+    enum QueueOverflowPolicy
+    {
+        /// Discards the oldest queued message.
+        Qop_DropOldest,
+
+        /// Discards the message being published.
+        Qop_DropNewest,
+
+        /// Disconnects the subscriber.
+        Qop_Disconnect,
+
+        /// Replaces any queued message with the same key as the message being published, whether or not the 
+        /// queue is full. Messages are given keys with Publisher<>::publish(key). If the queue is full and there is no such message, discards the oldest
+        /// queued message.
+        Qop_Conflate
+    };
+
+    /// Describes the order in which a SubscriptionDispatcher dispatches the messages of a subscription. See 
+    /// SubscriptionParms::setDispatcher().
+    enum DispatchOrdering
+    {
+        /// Messages of a subscription are dispatched one at a time, in the order they were received.
+        Do_PerSubscription,
+
+        /// Messages of a subscription with the same key are dispatched one at a time, in the order they were 
+        /// received. Messages with different keys may be dispatched in parallel. Messages are given keys with 
+        /// Publisher<>::publish(key), and messages without a key are dispatched in order with each other.
+        Do_PerKey
+    };
+
     /// @}
 
     RCF_EXPORT std::string getTransportProtocolName(TransportProtocol protocol);
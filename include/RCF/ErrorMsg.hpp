@@ -247,6 +247,9 @@ namespace RCF
     #define RcfError_HttpMessageVerificationAdmin    ErrorMsg(192) // HTTP message verification failed. %1%
     #define RcfError_HttpSessionNotAvailable         ErrorMsg(193) // HTTP session not available.
     #define RcfError_HttpInvalidMessage              ErrorMsg(194) // Invalid HTTP message.
+    #define RcfError_FileHashMismatch                ErrorMsg(195) // File integrity check failed. The downloaded file does not match the file on the server. File: %1%.
+    #define RcfError_FileDelta                       ErrorMsg(196) // Invalid file delta. %1%
+    #define RcfError_ChunkedFraming                  ErrorMsg(197) // Invalid chunked message framing.
 
     static const int RcfError_Ok_Id                           =   0;
     static const int RcfError_ServerMessageLength_Id          =   2;
@@ -433,6 +436,9 @@ namespace RCF
     static const int RcfError_HttpMessageVerificationAdmin_Id = 192;
     static const int RcfError_HttpSessionNotAvailable_Id      = 193;
     static const int RcfError_HttpInvalidMessage_Id           = 194;
+    static const int RcfError_FileHashMismatch_Id             = 195;
+    static const int RcfError_FileDelta_Id                    = 196;
+    static const int RcfError_ChunkedFraming_Id               = 197;
 
     //[[[end]]]
 
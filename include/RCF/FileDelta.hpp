@@ -0,0 +1,226 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF 
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com 
+//
+//******************************************************************************
+
+#ifndef INCLUDE_RCF_FILEDELTA_HPP
+#define INCLUDE_RCF_FILEDELTA_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <RCF/FileStream.hpp>
+
+#include <SF/vector.hpp>
+
+namespace RCF {
+
+    // SHA-256 message digest.
+    class RCF_EXPORT Sha256
+    {
+    public:
+        Sha256();
+
+        void            update(const void * pData, std::size_t len);
+
+        // Returns the 32 byte digest. No further data can be added afterwards.
+        std::string     final();
+
+    private:
+        void            transform(const unsigned char * pBlock);
+
+        std::uint32_t   mState[8];
+        std::uint64_t   mLength;
+        unsigned char   mBlock[64];
+        std::size_t     mBlockLen;
+    };
+
+    // Weak checksum of a block of data, which can be rolled forward a byte at a time, as in rsync.
+    class RollingChecksum
+    {
+    public:
+        RollingChecksum() : mA(0), mB(0)
+        {
+        }
+
+        void reset(const char * pData, std::size_t len)
+        {
+            mA = 0;
+            mB = 0;
+            for (std::size_t i = 0; i < len; ++i)
+            {
+                mA += static_cast<unsigned char>(pData[i]);
+                mB += mA;
+            }
+        }
+
+        // Moves the block forward by one byte.
+        void roll(char out, char in, std::size_t len)
+        {
+            mA += static_cast<unsigned char>(in);
+            mA -= static_cast<unsigned char>(out);
+            mB += mA;
+            mB -= static_cast<std::uint32_t>(len) * static_cast<unsigned char>(out);
+        }
+
+        std::uint32_t value() const
+        {
+            return (mA & 0xFFFF) | (mB << 16);
+        }
+
+    private:
+        std::uint32_t   mA;
+        std::uint32_t   mB;
+    };
+
+    /// Signatures of the blocks of a file, used to download the file as a delta against an existing copy of it.
+    class RCF_EXPORT FileSignature
+    {
+    public:
+        FileSignature();
+
+        /// Length of the strong hash of each block.
+        static const std::size_t    StrongHashLength = 16;
+
+        /// Size of each block. The last block may be shorter.
+        std::uint32_t               mBlockSize;
+
+        /// Size of the file the signatures were computed from.
+        std::uint64_t               mFileSize;
+
+        /// Rolling checksum of each block.
+        std::vector<std::uint32_t>  mWeakHashes;
+
+        /// Truncated SHA-256 hash of each block, StrongHashLength bytes per block.
+        std::string                 mStrongHashes;
+
+        std::size_t                 getBlockCount() const;
+        std::uint32_t               getBlockLength(std::size_t blockIndex) const;
+
+#if RCF_FEATURE_SF==1
+        void serialize(SF::Archive & ar);
+#endif
+
+#if RCF_FEATURE_BOOST_SERIALIZATION==1
+        template<typename Archive>
+        void serialize(Archive & ar, const unsigned int)
+        {
+            RCF_UNUSED_VARIABLE(ar);
+            RCF_THROW(Exception(RcfError_BSerFileTransferNotSupported));
+        }
+#endif
+
+    };
+
+    /// One step in rebuilding a file from a delta. Either copies mLength bytes from mBasisOffset in the existing 
+    /// copy of the file, or, if mData is not empty, appends mData.
+    class FileDeltaOp
+    {
+    public:
+        FileDeltaOp();
+
+        bool isCopy() const;
+
+        std::uint64_t   mBasisOffset;
+        std::uint64_t   mLength;
+        ByteBuffer      mData;
+
+#if RCF_FEATURE_SF==1
+        void serialize(SF::Archive & ar);
+#endif
+
+#if RCF_FEATURE_BOOST_SERIALIZATION==1
+        template<typename Archive>
+        void serialize(Archive & ar, const unsigned int)
+        {
+            RCF_UNUSED_VARIABLE(ar);
+            RCF_THROW(Exception(RcfError_BSerFileTransferNotSupported));
+        }
+#endif
+
+    };
+
+    // Picks a block size of about the square root of the file size, as rsync does, large enough for the 
+    // signatures to fit in maxSignatureBytes.
+    RCF_EXPORT std::uint32_t chooseDeltaBlockSize(
+        std::uint64_t           fileSize, 
+        std::uint64_t           maxSignatureBytes);
+
+    RCF_EXPORT void computeFileSignature(
+        const Path &            filePath, 
+        std::uint32_t           blockSize, 
+        FileSignature &         signature);
+
+    // Encodes a file as a sequence of FileDeltaOp's against a FileSignature, a part at a time. The file is read 
+    // once, and its SHA-256 hash is computed along the way.
+    class RCF_EXPORT FileDeltaEncoder : Noncopyable
+    {
+    public:
+        FileDeltaEncoder(
+            const Path &            filePath, 
+            std::uint64_t           fileSize, 
+            const FileSignature &   signature);
+
+        // Encodes the next part of the file, with at most maxLiteralBytes of literal data. Returns true once the 
+        // whole file has been encoded.
+        bool                encode(std::vector<FileDeltaOp> & ops, std::uint32_t maxLiteralBytes);
+
+        // Number of bytes of the file encoded so far.
+        std::uint64_t       getPos() const;
+
+        // SHA-256 hash of the whole file. Only available once encoding has completed.
+        const std::string & getFileHash() const;
+
+    private:
+
+        std::size_t         fill(std::size_t bytesNeeded);
+        bool                findBlock(const char * pData, std::size_t len, std::uint32_t weakHash, std::uint32_t & blockIndex);
+        std::uint64_t       flushLiteral(std::vector<FileDeltaOp> & ops);
+        void                addCopy(std::vector<FileDeltaOp> & ops, std::uint32_t blockIndex, std::size_t len);
+
+        static std::size_t  getTag(std::uint32_t weakHash);
+
+        FileSignature                                       mSignature;
+        std::unordered_map<std::uint32_t, std::uint32_t>    mFirstBlock;
+        std::vector<std::uint32_t>                          mNextBlock;
+        std::vector<char>                                   mTags;
+
+        FileHandle                                          mFile;
+        std::uint64_t                                       mFileSize;
+        Sha256                                              mHash;
+        std::string                                         mFileHash;
+        bool                                                mDone;
+
+        // Bytes of the file from mBufPos onwards.
+        std::vector<char>                                   mBuf;
+        std::uint64_t                                       mBufPos;
+        std::uint64_t                                       mReadPos;
+
+        // Literal data is pending from mLitStart to mWinPos, and the block being matched starts at mWinPos.
+        std::uint64_t                                       mLitStart;
+        std::uint64_t                                       mWinPos;
+        RollingChecksum                                     mChecksum;
+        bool                                                mChecksumValid;
+        std::uint32_t                                       mLastCopyBlock;
+    };
+
+    typedef std::shared_ptr<FileDeltaEncoder> FileDeltaEncoderPtr;
+
+} // namespace RCF
+
+#endif // ! INCLUDE_RCF_FILEDELTA_HPP
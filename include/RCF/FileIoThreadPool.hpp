@@ -20,7 +20,9 @@
 #define INCLUDE_RCF_FILEIOTHREADPOOL_HPP
 
 #include <deque>
+#include <map>
 #include <memory>
+#include <set>
 
 #include <RCF/ByteBuffer.hpp>
 #include <RCF/Exception.hpp>
@@ -35,7 +37,12 @@ namespace RCF {
 
     class FileHandle;
     typedef std::shared_ptr<FileHandle> FileHandlePtr;
+
+    class FileChunk;
     
+    // Runs file reads and writes on a pool of threads. Requests on the same file are run one at a time, in the 
+    // order they were made, while requests on different files run in parallel. Files with requests waiting are 
+    // serviced round robin, a request at a time, so a busy transfer can't hold up the others.
     class RCF_EXPORT FileIoThreadPool
     {
     public:
@@ -48,6 +55,9 @@ namespace RCF {
 
         void setSerializeFileIo(bool serializeFileIo);
 
+        // Maximum number of file requests run at the same time.
+        void setThreadMaxCount(std::size_t threadMaxCount);
+
     private:
 
         friend class FileIoRequest;
@@ -55,17 +65,19 @@ namespace RCF {
         bool ioTask();
         void stopIoTask();
 
-        bool                            mSerializeFileIo;
+        typedef std::deque< FileIoRequestPtr >                  OpQueue;
+
+        bool                                                    mSerializeFileIo;
     
-        RCF::Mutex                      mOpsMutex;
-        RCF::Condition                  mOpsCondition;
-        std::deque< FileIoRequestPtr >  mOpsQueued;
-        std::deque< FileIoRequestPtr >  mOpsInProgress;
+        RCF::Mutex                                              mOpsMutex;
+        RCF::Condition                                          mOpsCondition;
+
+        // Requests waiting for each file, and the files that have requests waiting and none running.
+        std::map< FileHandle *, OpQueue >                       mFileOps;
+        std::set< FileHandle * >                                mFilesInProgress;
+        std::deque< FileHandle * >                              mFilesReady;
         
-        RCF::ThreadPool                 mThreadPool;
-    
-        RCF::Mutex                      mCompletionMutex;
-        RCF::Condition                  mCompletionCondition;
+        RCF::ThreadPool                                         mThreadPool;
     };
    
     class RCF_EXPORT FileIoRequest : 
@@ -81,13 +93,21 @@ namespace RCF {
         void initiateRead(FileHandlePtr finPtr, RCF::ByteBuffer buffer);
         void initateWrite(FileHandlePtr foutPtr, RCF::ByteBuffer buffer);
 
+        // Writes the data of a file chunk, decompressing it first if it is compressed.
+        void initiateWrite(FileHandlePtr foutPtr, const FileChunk & chunk);
+
         std::uint64_t getBytesTransferred();
 
+        // Error from a request that transferred no bytes.
+        RCF::Exception getError();
+
     private:
 
         friend class FileIoThreadPool;
 
         void doTransfer();
+        void waitForCompletion();
+        FileHandle * getFileHandle();
     
         FileIoThreadPool &                  mFts;
     
@@ -95,10 +115,15 @@ namespace RCF {
         FileHandlePtr                       mFoutPtr;
     
         RCF::ByteBuffer                     mBuffer;
+        std::shared_ptr<FileChunk>          mCompressedChunkPtr;
         std::uint64_t                       mBytesTransferred;
         bool                                mInitiated;
         bool                                mCompleted;
         RCF::Exception                      mError;
+
+        // Completion is signaled to each request separately.
+        RCF::Mutex                          mCompletionMutex;
+        RCF::Condition                      mCompletionCondition;
     };
 
     RCF_EXPORT FileIoThreadPool & getFileIoThreadPool();
@@ -61,6 +61,7 @@ namespace RCF {
             Read,
             WriteTruncate,
             WriteAppend,
+            WriteExisting,
         };
 
         FileHandle();
@@ -76,16 +77,22 @@ namespace RCF {
         std::size_t     read(const ByteBuffer& buffer);
         std::size_t     write(const ByteBuffer& buffer);    
 
+        // Positional I/O. Doesn't use or move the current position.
+        std::size_t     readAt(const ByteBuffer& buffer, std::uint64_t pos);
+        std::size_t     writeAt(const ByteBuffer& buffer, std::uint64_t pos);
+
         Exception       err() const;
 
         Path            getFilePath();
 
     private:
 
+        // The file is only opened and closed through the FILE, and all reads and writes are positional, at mPos.
         FILE *          mpFile = NULL;
         Path            mFilePath;
         OpenMode        mOpenMode = Read;
         std::size_t     mBeginPos = 0;
+        std::uint64_t   mPos = 0;
         Exception       mErr;
     };
 
@@ -282,6 +289,16 @@ namespace RCF {
         std::uint32_t   mServerLimitBps;
     };
 
+    /// Compression applied to the data of a file chunk.
+    enum FileChunkCompression
+    {
+        /// Data is not compressed.
+        Fcc_None = 0,
+
+        /// Data is compressed with zlib.
+        Fcc_Zlib = 1
+    };
+
     class FileChunk
     {
     public:
@@ -290,9 +307,21 @@ namespace RCF {
 
         bool isEmpty() const;
 
+        // Length of the data, once decompressed.
+        std::uint64_t getDataLength() const;
+
+        // Compresses the data, if a sample of it looks compressible, and compressing it saves enough to be 
+        // worth decompressing.
+        void compress();
+
+        // Decompresses the data, if it is compressed.
+        void decompress();
+
         std::uint32_t mFileIndex;
         std::uint64_t mOffset;
         ByteBuffer mData;
+        FileChunkCompression mCompression;
+        std::uint32_t mUncompressedLength;
 
 #if RCF_FEATURE_SF==1
         void serialize(SF::Archive & ar);
@@ -318,6 +347,9 @@ namespace RCF {
         std::uint64_t mPos;
         std::uint32_t mChunkSize;
 
+        // Compression the client can accept for the chunks it downloads.
+        FileChunkCompression mCompression;
+
 #if RCF_FEATURE_SF==1
         void serialize(SF::Archive & ar);
 #endif
@@ -387,6 +419,22 @@ namespace RCF {
         /// Progress callback. Called during the transfer to provide progress information.
         FileProgressCallback    mProgressCallback;
 
+        /// Number of connections to download over in parallel. Each connection downloads its own byte range of 
+        /// the file, and the progress of each range is kept in a .stripes file alongside the download, until the 
+        /// download completes. Only applicable to downloads.
+        std::uint32_t       mStripeCount = 1;
+
+        /// Downloads the file as a delta against the existing copy at the download path, if there is one. Only the 
+        /// parts of the file that differ from the existing copy are transferred, and the new copy is verified 
+        /// against a SHA-256 hash of the file on the server, before it replaces the existing copy. Only applicable 
+        /// to downloads of whole files.
+        bool                mDeltaSync = false;
+
+        /// Compresses the file chunks that are transferred, where a quick sample of a chunk predicts that it will 
+        /// compress. Requires RCF_FEATURE_ZLIB=1 on both the client and the server, and otherwise chunks are 
+        /// transferred uncompressed.
+        bool                mCompressChunks = false;
+
         // For test purposes.
         std::uint32_t       mChunkSize = 0;
     };
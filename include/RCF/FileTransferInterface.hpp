@@ -35,7 +35,7 @@ namespace RCF {
                 BeginUpload,
                     const FileManifest &,           // upload manifest
                     const std::vector<FileChunk> &, // optional first chunks
-                    FileChunk &,                    // where to start uploading
+                    FileChunk &,                    // where to start uploading, and compression accepted
                     std::uint32_t &,                // max message length
                     std::string &,                  // upload id
                     std::uint32_t &,                // bps
@@ -71,6 +71,20 @@ namespace RCF {
                     std::uint32_t &,                // advised wait for next call
                     std::uint32_t &)                // bps
 
+        RCF_METHOD_V1(
+            void,
+                BeginDeltaDownload,
+                    const FileSignature &)          // signatures of the client's copy
+
+        RCF_METHOD_V5(
+            void,
+                DownloadDeltaChunks,
+                    const FileTransferRequest &,    // transfer request
+                    std::vector<FileDeltaOp> &,     // delta to apply to the client's copy
+                    std::string &,                  // file hash, once the delta is complete
+                    std::uint32_t &,                // advised wait for next call
+                    std::uint32_t &)                // bps
+
     RCF_END(I_FileTransferService)
 
 } // namespace RCF
@@ -22,6 +22,7 @@
 #include <map>
 #include <set>
 
+#include <RCF/FileDelta.hpp>
 #include <RCF/FileStream.hpp>
 #include <RCF/RcfFwd.hpp>
 #include <RCF/Service.hpp>
@@ -117,6 +118,7 @@ namespace RCF {
         ByteBuffer              mReadBuffer;
         ByteBuffer              mSendBuffer;
         ByteBuffer              mSendBufferRemaining;
+        FileDeltaEncoderPtr     mDeltaEncoderPtr;
 
         bool                    mResume;
 
@@ -190,6 +192,16 @@ namespace RCF {
                                 std::uint32_t & adviseWaitMs,
                                 std::uint32_t & bps);
 
+        void                BeginDeltaDownload(
+                                const FileSignature & signature);
+
+        void                DownloadDeltaChunks(
+                                const FileTransferRequest & request,
+                                std::vector<FileDeltaOp> & ops,
+                                std::string & fileHash,
+                                std::uint32_t & adviseWaitMs,
+                                std::uint32_t & bps);
+
         //----------------------------------------------------------------------
 
     private:
@@ -205,6 +217,13 @@ namespace RCF {
         std::map<std::string, TransferInfo> mFileTransfersInProgress;
 
         void                checkForUploadCompletion(FileUploadInfoPtr uploadInfoPtr);
+        void                checkForDownloadCompletion(FileDownloadInfoPtr & downloadInfoPtr);
+
+        void                trimToTransferWindow(
+                                FileDownloadInfo & di, 
+                                std::uint32_t & chunkSize, 
+                                std::uint32_t & adviseWaitMs, 
+                                std::uint32_t & bps);
 
 
 
@@ -19,6 +19,9 @@
 #ifndef INCLUDE_RCF_FUTURE_HPP
 #define INCLUDE_RCF_FUTURE_HPP
 
+#include <atomic>
+#include <vector>
+
 #include <RCF/ClientStub.hpp>
 #include <RCF/Marshal.hpp>
 
@@ -34,6 +37,21 @@ namespace RCF {
     template<typename T>
     class FutureConverter;
 
+    template<typename T>
+    class Future;
+
+    template<typename R>
+    class FutureContinuation;
+
+    template<typename T>
+    class FutureAwaiter;
+
+    template<typename T>
+    Future<Void> whenAll(const std::vector< Future<T> > & futures);
+
+    template<typename T>
+    Future<std::size_t> whenAny(const std::vector< Future<T> > & futures);
+
     /// Provides the ability for remote calls to be executed asynchronously.
 
     /// The Future class provides the user with a mechanism to access the return values of an asynchronous 
@@ -45,6 +63,10 @@ namespace RCF {
     /// at any time using cancel(). Once a remote call completes, the result is accessed by dereferencing
     /// the Future instance using operator*().
 
+    /// Alternatively, use then() to attach a continuation that runs when the call completes, or 
+    /// whenAll() and whenAny() to compose several Future instances. Continuations are run on the thread that 
+    /// completes the call, and do not require a waiting thread.
+
     /// The Future class is internally reference counted, and has shallow copy semantics.
 
     template<typename T>
@@ -131,29 +153,99 @@ namespace RCF {
             return mStatePtr->getClientStub().getAsyncException();
         }
 
+        /// Registers a continuation to be run when the asynchronous call completes. The continuation is passed
+        /// a copy of this Future, and its return value is made available through the returned Future. If the 
+        /// call has already completed, the continuation is run immediately, on the calling thread.
+        template<typename Func>
+        Future< typename FutureContinuation< decltype( std::declval<Func>()( std::declval<Future<T> &>() ) ) >::ResultType > 
+            then(Func func)
+        {
+            typedef decltype( std::declval<Func>()( std::declval<Future<T> &>() ) ) R;
+            typedef typename FutureContinuation<R>::ResultType ResultType;
+
+            Future<ResultType> result = Future<ResultType>::makePending();
+            Future<T> self = *this;
+            mStatePtr->onReady( [=]() mutable
+            {
+                FutureContinuation<R>::run(result, func, self);
+            });
+            return result;
+        }
+
     private:
 
         template<typename U>
         friend class FutureConverter;
 
+        template<typename U>
+        friend class Future;
+
+        template<typename R>
+        friend class FutureContinuation;
+
+        template<typename U>
+        friend class FutureAwaiter;
+
+        template<typename U>
+        friend Future<Void> whenAll(const std::vector< Future<U> > & futures);
+
+        template<typename U>
+        friend Future<std::size_t> whenAny(const std::vector< Future<U> > & futures);
+
+        struct PendingTag {};
+
+        Future(PendingTag) : mStatePtr( new State(PendingTag()) )
+        {}
+
+        // Creates a Future that is not backed by a remote call, and is completed through setValue() or setException().
+        static Future makePending()
+        {
+            return Future( PendingTag() );
+        }
+
+        void setValue(const T & t)
+        {
+            mStatePtr->setLocalValue(t);
+        }
+
+        void setException(std::unique_ptr<Exception> ePtr)
+        {
+            mStatePtr->setLocalException(std::move(ePtr));
+        }
+
+        void onReady(std::function<void()> fn)
+        {
+            mStatePtr->onReady(fn);
+        }
+
         class State : public I_Future, Noncopyable
         {
         public:
             State() : 
                 mpt(), 
                 mtPtr( new T() ), 
-                mpClientStub()
+                mpClientStub(),
+                mLocalReady(true)
             {}
 
             State(T *pt) : 
                 mpt(pt), 
-                mpClientStub()
+                mpClientStub(),
+                mLocalReady(true)
             {}
 
             State(const T &t) : 
                 mpt(), 
                 mtPtr( new T(t) ), 
-                mpClientStub()
+                mpClientStub(),
+                mLocalReady(true)
+            {}
+
+            State(PendingTag) : 
+                mpt(), 
+                mtPtr( new T() ), 
+                mpClientStub(),
+                mLocalReady(false)
             {}
 
             ~State()
@@ -183,6 +275,18 @@ namespace RCF {
                         ePtr->throwSelf();
                     }
                 }
+                else
+                {
+                    Lock lock(mLocalMutex);
+                    while (!mLocalReady)
+                    {
+                        mLocalCondition.wait(lock);
+                    }
+                    if (mLocalException.get())
+                    {
+                        mLocalException->throwSelf();
+                    }
+                }
 
                 T *pt = mpt ? mpt : mtPtr.get();
                 {
@@ -207,27 +311,113 @@ namespace RCF {
                 mtPtr.reset();
             }
 
+            void setLocalValue(const T & t)
+            {
+                *mtPtr = t;
+                setLocalReady();
+            }
+
+            void setLocalException(std::unique_ptr<Exception> ePtr)
+            {
+                {
+                    Lock lock(mLocalMutex);
+                    mLocalException = std::move(ePtr);
+                }
+                setLocalReady();
+            }
+
+            // Runs fn once this state is ready. Remote call completions are tracked by the ClientStub, 
+            // everything else by the state itself. Either way, only a per-call lock is taken.
+            void onReady(std::function<void()> fn)
+            {
+                if (mpClientStub)
+                {
+                    mpClientStub->addCompletionHandler(fn);
+                    return;
+                }
+
+                {
+                    Lock lock(mLocalMutex);
+                    if (!mLocalReady)
+                    {
+                        mContinuations.push_back(fn);
+                        return;
+                    }
+                }
+                fn();
+            }
+
         private:
 
+            void setLocalReady()
+            {
+                std::vector< std::function<void()> > continuations;
+                {
+                    Lock lock(mLocalMutex);
+                    RCF_ASSERT(!mLocalReady);
+                    mLocalReady = true;
+                    continuations.swap(mContinuations);
+                    mLocalCondition.notify_all();
+                }
+                for (std::size_t i=0; i<continuations.size(); ++i)
+                {
+                    continuations[i]();
+                }
+            }
+
             T *                     mpt;
             std::unique_ptr<T>      mtPtr;
             RCF::ClientStub *       mpClientStub;
 
+            // Completion state for futures not backed by a remote call.
+            Mutex                                   mLocalMutex;
+            Condition                               mLocalCondition;
+            bool                                    mLocalReady;
+            std::unique_ptr<Exception>              mLocalException;
+            std::vector< std::function<void()> >    mContinuations;
+
         public:
 
             bool ready()
             {
-                return mpClientStub->ready();
+                if (mpClientStub)
+                {
+                    return mpClientStub->ready();
+                }
+
+                Lock lock(mLocalMutex);
+                return mLocalReady;
             }
 
             void wait(std::uint32_t timeoutMs = 0)
             {
-                mpClientStub->waitForReady(timeoutMs);
+                if (mpClientStub)
+                {
+                    mpClientStub->waitForReady(timeoutMs);
+                    return;
+                }
+
+                Lock lock(mLocalMutex);
+                if (!mLocalReady)
+                {
+                    if (timeoutMs)
+                    {
+                        using namespace std::chrono_literals;
+                        mLocalCondition.wait_for(lock, timeoutMs*1ms, [this]() { return mLocalReady; });
+                    }
+                    else
+                    {
+                        mLocalCondition.wait(lock, [this]() { return mLocalReady; });
+                    }
+                }
             }
 
             void cancel()
             {
-                mpClientStub->cancel();                
+                if (mpClientStub)
+                {
+                    mpClientStub->cancel();
+                }
             }
 
             ClientStub & getClientStub()
@@ -251,6 +441,123 @@ namespace RCF {
         std::shared_ptr<State> mStatePtr;
     };
 
+    // Runs a continuation registered through Future<>::then(), and forwards its result or exception.
+    template<typename R>
+    class FutureContinuation
+    {
+    public:
+        typedef R ResultType;
+
+        template<typename Func, typename T>
+        static void run(Future<R> & result, Func & func, Future<T> & arg)
+        {
+            std::unique_ptr<Exception> ePtr;
+            try
+            {
+                R r = func(arg);
+                result.setValue(r);
+                return;
+            }
+            catch (const Exception & e)
+            {
+                ePtr = e.clone();
+            }
+            catch (const std::exception & e)
+            {
+                ePtr.reset( new Exception(e.what()) );
+            }
+            catch (...)
+            {
+                ePtr.reset( new Exception(RcfError_NonStdException) );
+            }
+            result.setException(std::move(ePtr));
+        }
+    };
+
+    template<>
+    class FutureContinuation<void>
+    {
+    public:
+        typedef Void ResultType;
+
+        template<typename Func, typename T>
+        static void run(Future<Void> & result, Func & func, Future<T> & arg)
+        {
+            std::unique_ptr<Exception> ePtr;
+            try
+            {
+                func(arg);
+                result.setValue(Void());
+                return;
+            }
+            catch (const Exception & e)
+            {
+                ePtr = e.clone();
+            }
+            catch (const std::exception & e)
+            {
+                ePtr.reset( new Exception(e.what()) );
+            }
+            catch (...)
+            {
+                ePtr.reset( new Exception(RcfError_NonStdException) );
+            }
+            result.setException(std::move(ePtr));
+        }
+    };
+
+    /// Returns a Future that becomes ready once all of the given futures are ready. The results of the
+    /// individual calls are retrieved from the original Future instances.
+    template<typename T>
+    Future<Void> whenAll(const std::vector< Future<T> > & futures)
+    {
+        Future<Void> result = Future<Void>::makePending();
+        if (futures.empty())
+        {
+            result.setValue(Void());
+            return result;
+        }
+
+        std::shared_ptr< std::atomic<std::size_t> > remainingPtr( 
+            new std::atomic<std::size_t>(futures.size()) );
+
+        for (std::size_t i=0; i<futures.size(); ++i)
+        {
+            Future<T> future = futures[i];
+            future.onReady( [=]() mutable
+            {
+                if (--(*remainingPtr) == 0)
+                {
+                    result.setValue(Void());
+                }
+            });
+        }
+        return result;
+    }
+
+    /// Returns a Future holding the index of the first of the given futures to become ready.
+    template<typename T>
+    Future<std::size_t> whenAny(const std::vector< Future<T> > & futures)
+    {
+        RCF_ASSERT(!futures.empty());
+
+        Future<std::size_t> result = Future<std::size_t>::makePending();
+        std::shared_ptr< std::atomic<bool> > donePtr( new std::atomic<bool>(false) );
+
+        for (std::size_t i=0; i<futures.size(); ++i)
+        {
+            Future<T> future = futures[i];
+            future.onReady( [=]() mutable
+            {
+                if (!donePtr->exchange(true))
+                {
+                    result.setValue(i);
+                }
+            });
+        }
+        return result;
+    }
+
     class LogEntryExit
     {
     public:
@@ -243,23 +243,63 @@ namespace RCF {
     // -------------------------------------------------------------------------
     // Parameter store.
 
+#if RCF_FEATURE_PROTOBUF==1
+
+    template<typename T>
+    T * createOnProtobufArena(RCF::TrueType *)
+    {
+        google::protobuf::Arena * pArena = getCurrentProtobufArena();
+        return pArena ? google::protobuf::Arena::CreateMessage<T>(pArena) : NULL;
+    }
+
+    template<typename T>
+    T * createOnProtobufArena(RCF::FalseType *)
+    {
+        return NULL;
+    }
+
+#endif
+
     template<typename T>
     class ParmStore
     {
     public:
-        ParmStore() : mptPtr(), mpT(NULL)
+        ParmStore() : mptPtr(), mpT(NULL), mArenaOwned(false)
         {
         }
 
-        ParmStore(std::vector<char> & vec) : mptPtr(), mpT(NULL)
+        ParmStore(std::vector<char> & vec, bool useArena = false) : mptPtr(), mpT(NULL), mArenaOwned(false)
         {
-            allocate(vec);
+            allocate(vec, useArena);
         }
 
-        void allocate(std::vector<char> & vec)
+        // Constructs a Protobuf message on the arena of the current call, if T is a Protobuf message 
+        // type and the call has an arena. The arena owns the message, and releases it once the call 
+        // parameters are cleared. Only for server side marshaling, as the arena belongs to the session 
+        // of the call being dispatched, rather than to any calls the servant makes.
+        bool allocateOnArena()
         {
             RCF_ASSERT(mpT == NULL);
 
+#if RCF_FEATURE_PROTOBUF==1
+            typedef typename std::remove_cv<T>::type U;
+            typedef typename std::is_base_of<google::protobuf::Message, U>::type IsProtobuf;
+            mpT = createOnProtobufArena<U>( (IsProtobuf *) NULL);
+            mArenaOwned = (mpT != NULL);
+#endif
+
+            return mArenaOwned;
+        }
+
+        void allocate(std::vector<char> & vec, bool useArena = false)
+        {
+            RCF_ASSERT(mpT == NULL);
+
+            if (useArena && allocateOnArena())
+            {
+                return;
+            }
+
             getObjectPool().getObj(mptPtr, false);
 
             if (mptPtr)
@@ -298,7 +338,7 @@ namespace RCF {
 
         ~ParmStore()
         {
-            if (!mptPtr)
+            if (!mptPtr && !mArenaOwned)
             {
                 if (mpT)
                 {
@@ -319,6 +359,7 @@ namespace RCF {
 
         std::shared_ptr<T> mptPtr;
         T * mpT;
+        bool mArenaOwned;
     };
 
     // Helper class to ensure delete is called for pointers that we allocate as part of reference marshaling.
@@ -358,7 +399,7 @@ namespace RCF {
         static_assert( !IsPointer<T>::value, "Incorrect marshaling code." );
         static_assert( !IsReference<T>::value, "Incorrect marshaling code." );
 
-        Sm_Value(std::vector<char> & vec) : mPs(vec)
+        Sm_Value(std::vector<char> & vec) : mPs(vec, true)
         { 
         }
 
@@ -441,6 +482,17 @@ namespace RCF {
         }
     };
 
+#if RCF_FEATURE_COROUTINES==1
+
+    template<typename T>
+    class CoroutineTask;
+
+    // Defined in CoroutineTask.hpp.
+    template<typename T, typename U>
+    void setServerReturnValue(bool assign, T & t, CoroutineTask<U> & task);
+
+#endif
+
     template<typename T>
     class Sm_Ret
     {
@@ -449,7 +501,7 @@ namespace RCF {
         static_assert(!IsPointer<T>::value, "Incorrect marshaling code.");
         static_assert(!IsReference<T>::value, "Incorrect marshaling code.");
 
-        Sm_Ret(std::vector<char> & vec) : mPs(vec)
+        Sm_Ret(std::vector<char> & vec) : mPs(vec, true)
         { 
         }
 
@@ -470,6 +522,17 @@ namespace RCF {
         { 
             *mPs = t; 
         }
+
+#if RCF_FEATURE_COROUTINES==1
+
+        // Servant implemented as a coroutine.
+        template<typename U>
+        void set(bool assign, CoroutineTask<U> task)
+        {
+            setServerReturnValue(assign, *mPs, task);
+        }
+
+#endif
         
         void read(SerializationProtocolIn &) 
         { 
@@ -539,7 +602,7 @@ namespace RCF {
                 else if (ver == 8)
                 {
                     // Deserialize as value.
-                    mPs.allocate(mVec);
+                    mPs.allocate(mVec, true);
                     deserialize(in, *mPs);
                 }
                 else if (ver >= 9)
@@ -547,10 +610,15 @@ namespace RCF {
                     // If BSer, deserialize through pointer.
                     // If SF and caching disabled, deserialize through pointer.
                     // If SF and caching enabled, use object cache and deserialize through value.
+                    // If Protobuf and the call has an arena, deserialize through value on the arena.
 
                     int sp = in.getSerializationProtocol();
-                    if (    (sp == Sp_SfBinary || sp == Sp_SfText)
-                        &&  getObjectPool().isCachingEnabled( (T *) NULL ))
+                    if (mPs.allocateOnArena())
+                    {
+                        deserialize(in, *mPs);
+                    }
+                    else if (   (sp == Sp_SfBinary || sp == Sp_SfText)
+                            &&  getObjectPool().isCachingEnabled( (T *) NULL ))
                     {
                         mPs.allocate(mVec);
                         deserialize(in, *mPs);
@@ -572,7 +640,7 @@ namespace RCF {
             }
             else
             {
-                mPs.allocate(mVec);
+                mPs.allocate(mVec, true);
             }
         }
 
@@ -637,7 +705,7 @@ namespace RCF {
                 {
                     // Deserialize as value.
 
-                    mPs.allocate(mVec);
+                    mPs.allocate(mVec, true);
                     deserialize(in, *mPs);
                 }
                 else if (ver >= 9)
@@ -645,10 +713,15 @@ namespace RCF {
                     // If BSer, deserialize through pointer.
                     // If SF and caching disabled, deserialize through pointer.
                     // If SF and caching enabled, use object cache and deserialize through value.
+                    // If Protobuf and the call has an arena, deserialize through value on the arena.
 
                     int sp = in.getSerializationProtocol();
-                    if (    (sp == Sp_SfBinary || sp == Sp_SfText)
-                        &&  getObjectPool().isCachingEnabled( (T *) NULL ))
+                    if (mPs.allocateOnArena())
+                    {
+                        deserialize(in, *mPs);
+                    }
+                    else if (   (sp == Sp_SfBinary || sp == Sp_SfText)
+                            &&  getObjectPool().isCachingEnabled( (T *) NULL ))
                     {
                         mPs.allocate(mVec);
                         deserialize(in, *mPs);
@@ -670,7 +743,7 @@ namespace RCF {
             }
             else
             {
-                mPs.allocate(mVec);
+                mPs.allocate(mVec, true);
             }
         }
 
@@ -704,7 +777,7 @@ namespace RCF {
         static_assert(IsReference<RefT>::value, "Incorrect marshaling code.");
         static_assert(!IsPointer<T>::value, "Incorrect marshaling code.");
 
-        Sm_OutRef(std::vector<char> & vec) : mPs(vec)
+        Sm_OutRef(std::vector<char> & vec) : mPs(vec, true)
         {
         }
 
@@ -782,6 +855,12 @@ namespace RCF {
         { 
             if (in.getRemainingArchiveLength() != 0)
             {
+                if (mPs.allocateOnArena())
+                {
+                    deserialize(in, const_cast<U &>(*mPs));
+                    return;
+                }
+
                 T *pt = NULL;
                 Deleter<T> deleter(pt);
                 deserialize(in, pt);
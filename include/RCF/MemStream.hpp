@@ -20,8 +20,10 @@
 #define INCLUDE_RCF_MEMSTREAM_HPP
 
 #include <istream>
+#include <memory>
 #include <streambuf>
 #include <cstdint> 
+#include <vector>
 
 #include <RCF/Config.hpp>
 #include <RCF/ByteBuffer.hpp>
@@ -32,6 +34,19 @@ namespace RCF {
 
     class ByteBuffer;
 
+    // Supplies the contents of a MemIstream buffer that is still being filled, e.g. by a network read.
+    class RCF_EXPORT MemIstreamSource
+    {
+    public:
+        virtual ~MemIstreamSource() {}
+
+        // Blocks until the buffer has been filled up to pchRequired, or until no more data will arrive. 
+        // Returns the end of the data that has been filled in so far.
+        virtual const char * waitForData(const char * pchRequired) = 0;
+    };
+
+    typedef std::shared_ptr<MemIstreamSource> MemIstreamSourcePtr;
+
     // MemIstreamBuf
 
     class MemIstreamBuf :
@@ -41,18 +56,35 @@ namespace RCF {
       public:   
         MemIstreamBuf(char * buffer = NULL, std::size_t bufferLen = 0);
         ~MemIstreamBuf();
-        void reset(char * buffer, std::size_t bufferLen);
+        void reset(char * buffer, std::size_t bufferLen, MemIstreamSource * pSource = NULL);
+
+        // Reads from a chain of buffers, as if they were a single buffer. The chain is not copied.
+        void reset(const std::vector<ByteBuffer> & chunks);
            
       private:   
         std::streambuf::int_type underflow();   
 
+        std::streamsize showmanyc();
+
+        char * waitForData(char * pchRequired);
+
+        void setChunk(std::size_t chunkIndex, std::size_t chunkOffset, std::size_t posInChunk);
+
         pos_type seekoff(
             off_type off, 
             std::ios_base::seekdir dir,
             std::ios_base::openmode mode = std::ios_base::in | std::ios_base::out);
+
+        pos_type seekChunks(off_type off, std::ios_base::seekdir dir);
            
         char * mBuffer;
         std::size_t mBufferLen; 
+        MemIstreamSource * mpSource;
+
+        const std::vector<ByteBuffer> * mpChunks;
+        std::size_t mChunkIndex;
+        std::size_t mChunkOffset;
+        std::size_t mChunksLen;
     };   
 
     // MemIstream - a replacement for std::istrstream.
@@ -63,7 +95,8 @@ namespace RCF {
     public:   
         MemIstream(const char * buffer = NULL, std::size_t bufferLen = 0);
         ~MemIstream();
-        void reset(const char * buffer, std::size_t bufferLen);
+        void reset(const char * buffer, std::size_t bufferLen, MemIstreamSource * pSource = NULL);
+        void reset(const std::vector<ByteBuffer> & chunks);
 
     private:   
 
@@ -123,6 +156,8 @@ namespace RCF {
             std::ios_base::seekdir dir,
             std::ios_base::openmode mode = std::ios_base::in | std::ios_base::out);
 
+        void reserve(std::size_t newCapacity);
+
         friend class MemOstream;
         ReallocBuffer mWriteBuffer;
     };   
@@ -142,6 +177,9 @@ namespace RCF {
 
         std::size_t capacity();
 
+        // Grows the buffer to at least the given size, so that writes up to that size don't reallocate.
+        void reserve(std::size_t newCapacity);
+
         void rewind()
         {
             rdbuf()->pubseekoff(0, std::ios::beg, std::ios::out);
@@ -182,6 +220,45 @@ namespace RCF {
 
     typedef std::shared_ptr<MemOstream> MemOstreamPtr;
 
+    // CountingOstreamBuf - discards written data, and counts the bytes.
+
+    class RCF_EXPORT CountingOstreamBuf :
+        public std::streambuf,
+        Noncopyable
+    {
+    public:
+        CountingOstreamBuf();
+
+        std::size_t getCount() const;
+        void resetCount();
+
+    private:
+        std::streamsize xsputn(const char * pch, std::streamsize count);
+        std::streambuf::int_type overflow(std::streambuf::int_type ch);
+
+        pos_type seekoff(
+            off_type off,
+            std::ios_base::seekdir dir,
+            std::ios_base::openmode mode = std::ios_base::in | std::ios_base::out);
+
+        std::size_t mCount;
+    };
+
+    // CountingOstream - used to measure the length of serialized data, without storing it.
+
+    class RCF_EXPORT CountingOstream :
+        public std::basic_ostream<char>
+    {
+    public:
+        CountingOstream();
+
+        std::size_t getCount() const;
+        void resetCount();
+
+    private:
+        CountingOstreamBuf mBuf;
+    };
+
     // iostream impl
 
     template<typename T>
@@ -0,0 +1,60 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_RCF_MESSAGEFRAMING_HPP
+#define INCLUDE_RCF_MESSAGEFRAMING_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <RCF/ByteBuffer.hpp>
+#include <RCF/Export.hpp>
+
+namespace RCF {
+
+    // Messages on stream oriented transports are framed with a 4 byte length prefix. A message can also be sent 
+    // with chunked framing, as a sequence of frames with ChunkedFrameFlag set in their length prefix, terminated 
+    // by a frame without it. The receiver then holds the message as a chain of buffers, one per frame, and never 
+    // needs a single buffer large enough for the whole message.
+
+    static const std::uint32_t ChunkedFrameFlag         = 0x80000000;
+    static const std::uint32_t MaxFrameLength           = 0x7FFFFFFF;
+
+    // Default frame size used by servers when responding to chunked requests.
+    static const std::size_t DefaultMessageChunkSize    = 1024*1024;
+
+    // Smaller frame sizes are rounded up, as the per frame overhead would dominate.
+    static const std::size_t MinMessageChunkSize        = 4*1024;
+
+    // Splits a message into frames of at most chunkSize bytes each, followed by an empty terminating frame. 
+    // The frames refer to the message buffers, which are not copied.
+    RCF_EXPORT void encodeChunkedFrames(
+        std::vector<ByteBuffer> &           frames,
+        const std::vector<ByteBuffer> &     message,
+        std::size_t                         chunkSize);
+
+    // Checks a frame against the chunks already received for the message. Only the last frame carrying data 
+    // can be shorter than MinMessageChunkSize, so receivers reject anything else, rather than handle a message 
+    // in arbitrarily small pieces.
+    RCF_EXPORT bool isValidChunkedFrame(
+        std::uint32_t                       frameLength,
+        const std::vector<ByteBuffer> &     chunks);
+
+} // namespace RCF
+
+#endif // ! INCLUDE_RCF_MESSAGEFRAMING_HPP
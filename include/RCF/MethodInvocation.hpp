@@ -28,6 +28,7 @@
 #include <RCF/Export.hpp>
 #include <RCF/Exception.hpp>
 #include <RCF/SerializationProtocol_Base.hpp>
+#include <RCF/SubscriptionFilter.hpp>
 
 namespace RCF {
 
@@ -54,6 +55,9 @@ namespace RCF {
     static const int Descriptor_Response            = 2;
     static const int Descriptor_FilteredPayload     = 3;
 
+    // Binding ID carried in a request, asking the server to assign a binding ID for the servant binding name.
+    static const int BindingId_Request              = -1;
+
     void encodeServerError(RcfServer & server, ByteBuffer & byteBuffer, int error);
     void encodeServerError(RcfServer & server, ByteBuffer & byteBuffer, int error, int arg0, int arg1);
 
@@ -123,6 +127,13 @@ namespace RCF {
         int             getPingBackIntervalMs();
 
         ByteBuffer      encodeRequestHeader();
+        void            invalidateHeaderCache();
+
+        int             getBindingId() const;
+        void            setBindingId(int bindingId);
+
+        const std::string & getMessageKey() const;
+        void            setMessageKey(const std::string & messageKey);
 
         void            encodeRequest(
                             const std::vector<ByteBuffer> & buffers,
@@ -167,6 +178,8 @@ namespace RCF {
                             const std::vector<ByteBuffer> & buffers,
                             const std::vector<FilterPtr> &  filters);
 
+        void            encodeHeaderCache();
+
         std::string             mService;
         int                     mFnId;
         SerializationProtocol   mSerializationProtocol;
@@ -183,7 +196,20 @@ namespace RCF {
         ByteBuffer              mOutOfBandRequest;
         ByteBuffer              mOutOfBandResponse;
 
+        // Binding ID negotiated for mService on this connection. BindingId_Request if the client is asking for 
+        // one, and 0 if binding IDs are not in use.
+        int                     mBindingId = 0;
+
+        // Key of a published message. Varies from one message to the next, so isn't part of the cached header.
+        std::string             mMessageKey;
+
         std::shared_ptr<std::vector<char> >   mVecPtr;
+
+        // Encoded header fields that don't change from one call to the next.
+        // The prefix precedes the function ID, and the suffix follows the close flag.
+        bool                    mHeaderCacheValid = false;
+        std::vector<char>       mHeaderPrefix;
+        std::vector<char>       mHeaderSuffix;
         
 
         friend RCF::MemOstream& operator<<(RCF::MemOstream& os, const MethodInvocationRequest& r);
@@ -200,6 +226,7 @@ namespace RCF {
         int     getArg0() const;
         int     getArg1() const;
         bool    getEnableSfPointerTracking() const;
+        int     getBindingId() const;
 
         std::unique_ptr<RemoteException> getExceptionPtr();
 
@@ -216,6 +243,7 @@ namespace RCF {
         int                 mArg0;
         int                 mArg1;
         bool                mEnableSfPointerTracking;
+        int                 mBindingId;
 
         friend RCF::MemOstream& operator<<(RCF::MemOstream& os, const MethodInvocationResponse& r);
     };
@@ -228,6 +256,7 @@ namespace RCF {
         Omt_CreateCallbackConnection = 2,
         Omt_RequestSubscription = 3,
         Omt_RequestProxyConnection = 4,
+        Omt_RequestRetransmit = 5,
     };
 
     class OobMessage;
@@ -302,7 +331,9 @@ namespace RCF {
         OobRequestSubscription(
             int                     runtimeVersion, 
             const std::string &     publisherName, 
-            std::uint32_t           subToPubPingIntervalMs);
+            std::uint32_t           subToPubPingIntervalMs,
+            const SubscriptionFilter & filter = SubscriptionFilter(),
+            bool                    multicastDelivery = false);
 
         virtual OobMessageType  getMessageType();
         virtual void            encodeRequest(ByteBuffer & buffer);
@@ -314,6 +345,42 @@ namespace RCF {
         std::string             mPublisherName;
         std::uint32_t           mSubToPubPingIntervalMs;
         std::uint32_t           mPubToSubPingIntervalMs;
+        SubscriptionFilter      mFilter;
+
+        // Set by the subscriber to ask for delivery through the multicast group of the publisher, and by the 
+        // publisher if it has one.
+        bool                    mMulticastDelivery;
+    };
+
+    class RCF_EXPORT OobRequestRetransmit : public OobMessage
+    {
+    public:
+        OobRequestRetransmit(int runtimeVersion);
+
+        OobRequestRetransmit(
+            int                     runtimeVersion,
+            const std::string &     publisherName,
+            std::uint64_t           streamId,
+            std::uint64_t           firstSeq,
+            std::uint64_t           lastSeq,
+            std::uint32_t           maxResponseLength);
+
+        virtual OobMessageType  getMessageType();
+        virtual void            encodeRequest(ByteBuffer & buffer);
+        virtual void            decodeRequest(const ByteBuffer & buffer, std::size_t & pos);
+        virtual void            encodeResponse(ByteBuffer & buffer);
+        virtual void            decodeResponse(const ByteBuffer & buffer);
+
+        std::string             mPublisherName;
+        std::uint64_t           mStreamId;
+        std::uint64_t           mFirstSeq;
+        std::uint64_t           mLastSeq;
+
+        // Max message length the subscriber can receive, or 0 if unlimited.
+        std::uint32_t           mMaxResponseLength;
+
+        // Datagrams still held by the publisher, in sequence, starting from the oldest one requested.
+        std::vector<ByteBuffer> mDatagrams;
     };
 
     class RCF_EXPORT OobRequestProxyConnection : public OobMessage
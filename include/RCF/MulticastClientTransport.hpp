@@ -19,12 +19,20 @@
 #ifndef INCLUDE_RCF_MULTICASTCLIENTTRANSPORT_HPP
 #define INCLUDE_RCF_MULTICASTCLIENTTRANSPORT_HPP
 
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <RCF/ClientTransport.hpp>
+#include <RCF/Enums.hpp>
 #include <RCF/Export.hpp>
+#include <RCF/SubscriptionFilter.hpp>
 #include <RCF/ThreadLibrary.hpp>
 
 namespace RCF {
@@ -32,11 +40,42 @@ namespace RCF {
     typedef std::shared_ptr< ClientTransportUniquePtr >       ClientTransportUniquePtrPtr;
     typedef std::vector< ClientTransportUniquePtrPtr >        ClientTransportList;
 
+    class SubscriberQueue;
+    typedef std::shared_ptr<SubscriberQueue>                  SubscriberQueuePtr;
+
+    class SubscriberQueueStats;
+
+    // Trailer appended to each datagram sent to a multicast group, after the RCF message. It carries the stream
+    // id of the publisher, the sequence number of the datagram, and the key of the message. Receivers that don't
+    // expect a trailer, read only the length prefixed RCF message and ignore it.
+    class RCF_EXPORT MulticastTrailer
+    {
+    public:
+        MulticastTrailer();
+
+        static const std::uint32_t  Magic = 0x52434d54;
+
+        // Magic number, stream id, sequence number and key length.
+        static const std::size_t    FixedLength = 24;
+
+        void        encode(std::vector<char> & vec) const;
+
+        // Decodes the trailer of a datagram, given the length of the RCF message including its length prefix.
+        bool        decode(const char * pDatagram, std::size_t datagramLen, std::size_t messageLen);
+
+        std::uint64_t   mStreamId;
+        std::uint64_t   mSeq;
+        std::string     mKey;
+    };
+
     // Special purpose client transport for sending messages in parallel on multiple sub-transports.
     class RCF_EXPORT MulticastClientTransport : public ClientTransport
     {
     public:
 
+        MulticastClientTransport();
+        ~MulticastClientTransport();
+
         TransportType getTransportType();
 
         std::unique_ptr<ClientTransport> clone() const;
@@ -69,7 +108,9 @@ namespace RCF {
                         unsigned int                    timeoutMs);
 
         void        addTransport(
-                        ClientTransportUniquePtr          clientTransportUniquePtr);
+                        ClientTransportUniquePtr        clientTransportUniquePtr,
+                        const SubscriptionFilter &      filter = SubscriptionFilter(),
+                        bool                            multicastDelivery = false);
 
         void        setTransportFilters(
                         const std::vector<FilterPtr> &  filters);
@@ -86,9 +127,60 @@ namespace RCF {
 
         std::size_t getTransportCount();
 
+        // Key of the next message sent. Only sent on transports whose filter matches the key, and used for 
+        // conflation on transport queues.
+        void        setMessageKey(const std::string & messageKey);
+
+        // Non-blocking sends. With a non-zero queue limit, each transport gets an outbound queue, and send() 
+        // returns once the message has been queued on all transports.
+        void        setQueueLimit(std::size_t queueLimit, QueueOverflowPolicy policy);
+        void        getQueueStats(std::vector<SubscriberQueueStats> & stats);
+        std::uint64_t getDroppedCount();
+        std::uint64_t getOverflowDisconnectCount();
+
+        // Sends each message once on the group transport, as well as on the transports of subscribers that
+        // don't receive from the group. Transports added with multicastDelivery set, then only receive pings.
+        // The last historyLength datagrams are kept, for retransmission.
+        void        setMulticastGroup(ClientTransportUniquePtr groupTransportPtr, std::size_t historyLength);
+
+        bool        hasMulticastGroup();
+
+        // Copies the datagrams with sequence numbers firstSeq to lastSeq, that are still in the history.
+        void        getMulticastDatagrams(
+                        std::uint64_t                   streamId,
+                        std::uint64_t                   firstSeq,
+                        std::uint64_t                   lastSeq,
+                        std::vector<ByteBuffer> &       datagrams);
+
+        // Keeps the last message sent with each key, up to maxKeys keys and maxBytes bytes, least recently 
+        // updated keys being evicted first. Transports added later are sent the cached messages before any 
+        // other message. A maxKeys of zero disables the cache, and a maxBytes of zero doesn't limit its size.
+        void        setLastValueCacheLimit(std::size_t maxKeys, std::size_t maxBytes);
+        void        removeLastValue(const std::string & messageKey);
+        std::size_t getLastValueCount();
+
     private:
 
-        void        bringInNewTransports();
+        void        bringInNewTransports(unsigned int timeoutMs);
+
+        void        sendSnapshots(
+                        Lock &                              lock,
+                        ClientTransportList &               transports,
+                        const std::vector<SubscriptionFilter> & filters,
+                        const std::vector<bool> &           multicastFlags,
+                        unsigned int                        timeoutMs);
+
+        void        updateLastValue(const std::string & messageKey, const ByteBuffer & message);
+
+        SubscriberQueuePtr & getSubscriberQueue(const ClientTransportUniquePtrPtr & transportPtr);
+
+        void        sendOnQueues(const ByteBuffer & message, const std::string & messageKey);
+        void        sendOnGroup(const std::vector<ByteBuffer> & data, const std::string & messageKey);
+        void        removeStaleEntries();
+
+        void        addSubscriberFilter(ClientTransportUniquePtr * pTransport, const SubscriptionFilter & filter);
+        void        removeSubscriberFilter(ClientTransportUniquePtr * pTransport);
+        void        setAsideTransports(const std::string & messageKey);
 
         Mutex                                           mClientTransportsMutex;
         ClientTransportList                             mClientTransports;
@@ -97,8 +189,56 @@ namespace RCF {
 
         Mutex                                           mAddedClientTransportsMutex;
         ClientTransportList                             mAddedClientTransports;
+        std::vector<SubscriptionFilter>                 mAddedFilters;
+        std::vector<bool>                               mAddedMulticastFlags;
 
         ClientTransportUniquePtr                          mMulticastTemp;
+
+        typedef std::map<ClientTransportUniquePtr *, SubscriberQueuePtr> SubscriberQueues;
+
+        std::size_t                                     mQueueLimit;
+        QueueOverflowPolicy                             mOverflowPolicy;
+        std::string                                     mMessageKey;
+        SubscriberQueues                                mSubscriberQueues;
+        std::uint64_t                                   mDroppedCount;
+        std::uint64_t                                   mOverflowDisconnectCount;
+
+        // Subscriber filters, indexed by key. Transports without a filter receive all messages.
+        typedef std::unordered_map<ClientTransportUniquePtr *, SubscriptionFilter>  SubscriberFilters;
+        typedef std::vector<ClientTransportUniquePtr *>                             TransportPtrs;
+        typedef std::unordered_map<std::string, TransportPtrs>                      SubscriberKeyIndex;
+
+        SubscriberFilters                               mSubscriberFilters;
+        SubscriberKeyIndex                              mSubscriberKeyIndex;
+        TransportPtrs                                   mRangeFilteredTransports;
+        std::unordered_set<ClientTransportUniquePtr *>  mMatchedTransports;
+        ClientTransportList                             mUnmatchedTransports;
+
+        // Multicast group, and the subscribers receiving from it.
+        ClientTransportUniquePtr                        mGroupTransportPtr;
+        std::unordered_set<ClientTransportUniquePtr *>  mMulticastSubscribers;
+        std::uint64_t                                   mStreamId;
+        std::uint64_t                                   mNextSeq;
+
+        Mutex                                           mHistoryMutex;
+        std::deque<ByteBuffer>                          mHistory;
+        std::size_t                                     mHistoryLength;
+
+        // Last value cache, least recently updated key first.
+        struct LastValue
+        {
+            std::string     mKey;
+            ByteBuffer      mMessage;
+        };
+
+        typedef std::list<LastValue>                                        LastValues;
+        typedef std::unordered_map<std::string, LastValues::iterator>       LastValueIndex;
+
+        std::size_t                                     mLastValueLimit;
+        std::size_t                                     mLastValueMaxBytes;
+        std::size_t                                     mLastValueBytes;
+        LastValues                                      mLastValues;
+        LastValueIndex                                  mLastValueIndex;
     };
 
 } // namespace RCF
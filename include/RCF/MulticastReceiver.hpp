@@ -0,0 +1,109 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_RCF_MULTICASTRECEIVER_HPP
+#define INCLUDE_RCF_MULTICASTRECEIVER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <RCF/Export.hpp>
+#include <RCF/RcfFwd.hpp>
+#include <RCF/SubscriptionFilter.hpp>
+#include <RCF/ThreadLibrary.hpp>
+#include <RCF/ThreadPool.hpp>
+#include <RCF/Tools.hpp>
+
+namespace RCF {
+
+    class Endpoint;
+    class MulticastReceiveStats;
+    class MulticastTrailer;
+    class UdpServerTransport;
+    class UdpNetworkSession;
+
+    typedef std::shared_ptr<UdpNetworkSession> UdpNetworkSessionPtr;
+
+    // Receives the messages of a publisher from a multicast group, and dispatches them in sequence to the 
+    // servant of a subscription. Datagrams missing from the sequence are requested from the publisher with
+    // retransmit requests on a separate connection, if one is given, and are otherwise counted as lost.
+    class RCF_EXPORT MulticastReceiver : Noncopyable
+    {
+    public:
+
+        MulticastReceiver(
+            RcfServer &                 server,
+            const Endpoint &            groupEp,
+            RcfClientPtr                rcfClientPtr,
+            const std::string &         publisherName,
+            const SubscriptionFilter &  filter,
+            RcfClientPtr                retransmitClientPtr);
+
+        ~MulticastReceiver();
+
+        void        start();
+        void        stop();
+
+        void        getStats(MulticastReceiveStats & stats);
+
+        // Messages from the group are queued for dispatch on the dispatcher of the subscription, once they are 
+        // in sequence.
+        void        setDispatchQueue(SubscriptionDispatchQueuePtr dispatchQueuePtr);
+
+    private:
+
+        void        cycle(int timeoutMs);
+
+        void        onDatagram(const char * pDatagram, std::size_t datagramLen);
+        void        recoverGap(std::uint64_t firstSeq, std::uint64_t lastSeq);
+        void        dispatch(const char * pDatagram, std::size_t messageLen, const std::string & key);
+
+        static bool parseDatagram(
+                        const char *        pDatagram, 
+                        std::size_t         datagramLen, 
+                        std::size_t &       messageLen, 
+                        MulticastTrailer &  trailer);
+
+        RcfServer &                     mServer;
+        std::string                     mPublisherName;
+        SubscriptionFilter              mFilter;
+        RcfClientPtr                    mRetransmitClientPtr;
+
+        std::unique_ptr<UdpServerTransport> mTransportPtr;
+        UdpNetworkSessionPtr            mNetworkSessionPtr;
+        RcfSessionPtr                   mRcfSessionPtr;
+
+        ThreadPool                      mThreadPool;
+        std::vector<char>               mRecvBuffer;
+
+        bool                            mStreamStarted;
+        std::uint64_t                   mStreamId;
+        std::uint64_t                   mNextSeq;
+
+        Mutex                           mStatsMutex;
+        std::uint64_t                   mReceivedCount;
+        std::uint64_t                   mRecoveredCount;
+        std::uint64_t                   mLostCount;
+        std::uint64_t                   mDiscardedCount;
+    };
+
+} // namespace RCF
+
+#endif // ! INCLUDE_RCF_MULTICASTRECEIVER_HPP
@@ -19,12 +19,15 @@
 #ifndef INCLUDE_RCF_PUBLISHINGSERVICE_HPP
 #define INCLUDE_RCF_PUBLISHINGSERVICE_HPP
 
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <RCF/Export.hpp>
 #include <RCF/PeriodicTimer.hpp>
+#include <RCF/SubscriptionFilter.hpp>
 #include <RCF/RcfClient.hpp>
 #include <RCF/ClientStub.hpp>
 #include <RCF/RcfFwd.hpp>
@@ -35,6 +38,28 @@
 
 namespace RCF {
 
+    /// Outbound queue statistics of a subscriber, for publishers with non-blocking publishing enabled.
+    class RCF_EXPORT SubscriberQueueStats
+    {
+    public:
+        SubscriberQueueStats();
+
+        /// Network address of the subscriber. Empty for HTTP and HTTPS subscribers.
+        std::string     mSubscriberAddress;
+
+        /// Number of messages waiting to be sent to the subscriber.
+        std::size_t     mQueueDepth;
+
+        /// Number of messages sent to the subscriber.
+        std::uint64_t   mSentCount;
+
+        /// Number of messages discarded because the queue of the subscriber was full.
+        std::uint64_t   mDroppedCount;
+
+        /// Number of queued messages replaced by a newer message with the same key.
+        std::uint64_t   mConflatedCount;
+    };
+
     /// General configuration of a publisher.
     class RCF_EXPORT PublisherParms
     {
@@ -52,13 +77,64 @@ namespace RCF {
         /// Configures a callback to be called whenever a subscriber disconnects from this publisher.
         void setOnSubscriberDisconnect(OnSubscriberDisconnect onSubscriberDisconnect);
 
+        /// Enables non-blocking publishing. Each subscriber gets an outbound queue holding up to queueLimit 
+        /// messages, which is drained by the server I/O threads, and publish calls return as soon as the message
+        /// has been queued. A slow subscriber then no longer holds up the publisher or other subscribers. If 
+        /// queueLimit is zero, publish calls block until the message has been sent to all subscribers. The 
+        /// default is zero.
+        void setSubscriberQueueLimit(std::size_t queueLimit);
+
+        /// Gets the subscriber queue limit of the publisher.
+        std::size_t getSubscriberQueueLimit() const;
+
+        /// Sets what happens when a message is published to a subscriber whose queue is full. The default is
+        /// Qop_DropOldest.
+        void setQueueOverflowPolicy(QueueOverflowPolicy policy);
+
+        /// Gets the queue overflow policy of the publisher.
+        QueueOverflowPolicy getQueueOverflowPolicy() const;
+
+        /// Sets a multicast group to publish messages on, typically a UdpEndpoint with a multicast IP address. 
+        /// Each message is then sent once to the group, regardless of the number of subscribers receiving it. 
+        /// Subscribers opt in with SubscriptionParms::setMulticastEndpoint(), and other subscribers are still 
+        /// sent messages on their own connections.
+        void setMulticastEndpoint(const Endpoint & groupEp);
+
+        /// Sets the number of recent multicast messages kept by the publisher, for subscribers to request again 
+        /// when they detect a lost message. The default is 1024.
+        void setMulticastHistoryLength(std::size_t historyLength);
+
+        /// Gets the multicast history length of the publisher.
+        std::size_t getMulticastHistoryLength() const;
+
+        /// Enables the last value cache of the publisher. The publisher keeps the last message published with each
+        /// message key, for up to maxKeys keys and, if maxBytes is non-zero, up to maxBytes bytes. When the limits 
+        /// are exceeded, the least recently published keys are evicted first. A new subscriber is first sent the 
+        /// cached messages matching its SubscriptionFilter, in the order they were published, followed by any
+        /// message published from then on. Subscribers receiving from a multicast group are not sent the cached 
+        /// messages. The default maxKeys is zero, which disables the cache.
+        void setLastValueCacheLimit(std::size_t maxKeys, std::size_t maxBytes = 0);
+
+        /// Gets the maximum number of keys in the last value cache.
+        std::size_t getLastValueCacheLimit() const;
+
+        /// Gets the maximum size of the last value cache, in bytes.
+        std::size_t getLastValueCacheMaxBytes() const;
+
     private:
 
         friend class PublishingService;
+        friend class PublisherBase;
 
         std::string             mTopicName;
         OnSubscriberConnect     mOnSubscriberConnect;
         OnSubscriberDisconnect  mOnSubscriberDisconnect;
+        std::size_t             mSubscriberQueueLimit = 0;
+        QueueOverflowPolicy     mQueueOverflowPolicy = Qop_DropOldest;
+        EndpointPtr             mMulticastEndpointPtr;
+        std::size_t             mMulticastHistoryLength = 1024;
+        std::size_t             mLastValueCacheLimit = 0;
+        std::size_t             mLastValueCacheMaxBytes = 0;
     };
 
     /// Base class of all publishers.
@@ -74,6 +150,24 @@ namespace RCF {
         /// Gets the number of subscribers currently connected.
         std::size_t     getSubscriberCount();
 
+        /// Gets the outbound queue statistics of each current subscriber. Only available with non-blocking 
+        /// publishing. See PublisherParms::setSubscriberQueueLimit().
+        void            getSubscriberQueueStats(std::vector<SubscriberQueueStats> & stats);
+
+        /// Gets the total number of messages discarded by the queue overflow policy, across all subscribers 
+        /// including disconnected ones.
+        std::uint64_t   getDroppedMessageCount();
+
+        /// Gets the number of subscribers disconnected by the Qop_Disconnect overflow policy.
+        std::uint64_t   getOverflowDisconnectCount();
+
+        /// Removes the cached message of a key from the last value cache, for instance once the item the key 
+        /// refers to no longer exists. See PublisherParms::setLastValueCacheLimit().
+        void            removeLastValue(const std::string & messageKey);
+
+        /// Gets the number of keys in the last value cache.
+        std::size_t     getLastValueCount();
+
         /// Closes the publisher and disconnects any current subscribers.
         void            close();
 
@@ -83,11 +177,15 @@ namespace RCF {
 
         void init();
 
+        void setMessageKey(const std::string & messageKey);
+        void clearMessageKey();
+
         PublishingService &     mPublishingService;
         PublisherParms          mParms;
         bool                    mClosed;
         std::string             mTopicName;
         RcfClientPtr            mRcfClientPtr;
+        bool                    mMessageKeySet;
     };
 
     /// Represents a single publisher within a RcfServer.  To create a publisher, use RcfServer::createPublisher().
@@ -117,6 +215,22 @@ namespace RCF {
         RcfClientT & publish()
         {
             RCF_ASSERT(!mClosed);
+            if (mMessageKeySet)
+            {
+                clearMessageKey();
+            }
+            return *mpClient;
+        }
+
+        /// Returns a reference to the RcfClient<> instance to use when publishing messages, and sets the key of 
+        /// the next message published. The message is only sent to subscribers whose SubscriptionFilter matches 
+        /// the key. The key is also used for conflation, see Qop_Conflate, and for the last value cache, see
+        /// PublisherParms::setLastValueCacheLimit(). The key is carried to subscribers in the request header
+        /// of the message, and orders the dispatch of messages on subscribers with Do_PerKey ordering.
+        RcfClientT & publish(const std::string & messageKey)
+        {
+            RCF_ASSERT(!mClosed);
+            setMessageKey(messageKey);
             return *mpClient;
         }
 
@@ -169,7 +283,23 @@ namespace RCF {
         std::int32_t  RequestSubscription(
                             const std::string &subscriptionName,
                             std::uint32_t subToPubPingIntervalMs,
-                            std::uint32_t & pubToSubPingIntervalMs);
+                            std::uint32_t & pubToSubPingIntervalMs,
+                            const SubscriptionFilter & filter = SubscriptionFilter());
+
+        std::int32_t  RequestSubscription(
+                            const std::string &subscriptionName,
+                            std::uint32_t subToPubPingIntervalMs,
+                            std::uint32_t & pubToSubPingIntervalMs,
+                            const SubscriptionFilter & filter,
+                            bool & multicastDelivery);
+
+        std::int32_t  RequestRetransmit(
+                            const std::string & publisherName,
+                            std::uint64_t streamId,
+                            std::uint64_t firstSeq,
+                            std::uint64_t lastSeq,
+                            std::uint32_t maxResponseLength,
+                            std::vector<ByteBuffer> & datagrams);
 
     private:
 
@@ -181,7 +311,9 @@ namespace RCF {
         void            addSubscriberTransport(
                             RcfSession &session,
                             const std::string &publisherName,
-                            ClientTransportUniquePtrPtr clientTransportUniquePtrPtr);
+                            ClientTransportUniquePtrPtr clientTransportUniquePtrPtr,
+                            const SubscriptionFilter & filter,
+                            bool multicastDelivery);
 
         void            closePublisher(const std::string & name);
 
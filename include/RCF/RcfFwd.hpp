@@ -68,6 +68,15 @@ namespace RCF
     typedef std::shared_ptr<Subscription>           SubscriptionPtr;
     typedef std::weak_ptr<Subscription>             SubscriptionWeakPtr;
 
+    class                                           MulticastReceiver;
+    typedef std::shared_ptr<MulticastReceiver>      MulticastReceiverPtr;
+
+    class                                           SubscriptionDispatcher;
+    typedef std::shared_ptr<SubscriptionDispatcher> SubscriptionDispatcherPtr;
+
+    class                                           SubscriptionDispatchQueue;
+    typedef std::shared_ptr<SubscriptionDispatchQueue> SubscriptionDispatchQueuePtr;
+
     /// Describes a user-provided callback function to be called on the publisher side, whenever a subscriber connects to a publisher.
     typedef std::function<bool(RcfSession &, const std::string &)>          OnSubscriberConnect;
 
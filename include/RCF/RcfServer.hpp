@@ -21,6 +21,7 @@
 #ifndef INCLUDE_RCF_RCFSERVER_HPP
 #define INCLUDE_RCF_RCFSERVER_HPP
 
+#include <atomic>
 #include <functional>
 #include <map>
 #include <memory>
@@ -171,6 +172,7 @@ namespace RCF {
 
             WriteLock writeLock(mStubMapMutex);
             mStubMap.erase(name_);
+            ++mStubMapGeneration;
             return true;
         }
         
@@ -523,6 +525,9 @@ namespace RCF {
         typedef std::map<std::string, RcfClientPtr>     StubMap;
         StubMap                                         mStubMap;
 
+        // Incremented whenever mStubMap changes, so sessions know when to re-resolve their binding IDs.
+        std::atomic<std::uint32_t>                      mStubMapGeneration{1};
+
 
         typedef std::function<void(const JsonRpcRequest &, JsonRpcResponse &)> JsonRpcMethod;
         typedef std::map<std::string, JsonRpcMethod>    JsonRpcMethods;
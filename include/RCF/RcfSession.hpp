@@ -180,6 +180,18 @@ namespace RCF {
         void            setDefaultStubEntryPtr(RcfClientPtr stubEntryPtr);
         void            setCachedStubEntryPtr(RcfClientPtr stubEntryPtr);
 
+        int             getBindingId(const std::string & bindingName);
+        bool            getBindingName(int bindingId, std::string & bindingName);
+        RcfClientPtr    getBoundStubEntryPtr(int bindingId);
+
+        bool            decodeIncrementalRequest(
+                            const ByteBuffer &          message,
+                            ByteBuffer &                messageBody,
+                            MemIstreamSourcePtr &       sourcePtr);
+
+        bool            decodeChunkedRequest(
+                            std::vector<ByteBuffer> &   chunks);
+
         /// @name Custom request/response user data
         /// The application data in a remote call is normally carried in the parameters of the remote call itself.
         /// RCF also allows you to add untyped custom data to the remote call request and response.
@@ -277,6 +289,19 @@ namespace RCF {
         /// Gets a value indicating if SF pointer tracking is enabled for this RcfSession.
         bool            getEnableSfPointerTracking() const;
 
+        /// Enables sizing of outgoing response messages on this RcfSession. See ClientStub::setEnableSizingPass().
+        void            setEnableSizingPass(bool enable);
+
+        /// Gets a value indicating if sizing of outgoing response messages is enabled on this RcfSession.
+        bool            getEnableSizingPass() const;
+
+#if RCF_FEATURE_PROTOBUF==1
+
+        /// Returns the arena that Protobuf parameters and return values of the current remote call are constructed on, or NULL if arena construction is not enabled for the call. See ServerBinding::setEnableProtobufArena().
+        google::protobuf::Arena *   getProtobufArena();
+
+#endif
+
 
         ///@}
 
@@ -437,6 +462,7 @@ namespace RCF {
         bool                                    mTransportFiltersLocked;
 
         bool                                    mEnableNativeWstringSerialization = false;
+        bool                                    mEnableSizingPass = false;
 
         SerializationProtocolIn                 mIn;
         SerializationProtocolOut                mOut;
@@ -470,6 +496,7 @@ namespace RCF {
         void processOob_CreateCallbackConnection(OobMessage& msg);
         void processOob_RequestSubscription(OobMessage& msg);
         void processOob_RequestProxyConnection(OobMessage& msg);
+        void processOob_RequestRetransmit(OobMessage& msg);
         void processOobMessages();
         
         void callServant();
@@ -535,6 +562,51 @@ namespace RCF {
         RcfClientPtr                            mDefaultStubEntryPtr;
         RcfClientPtr                            mCachedStubEntryPtr;
 
+        // Servant bindings that clients on this session refer to by binding ID. The binding ID is the 
+        // index into the table, plus one.
+        struct BindingEntry
+        {
+            std::string         mBindingName;
+            RcfClientPtr        mStubEntryPtr;
+            std::uint32_t       mStubMapGeneration = 0;
+        };
+
+        std::vector<BindingEntry>               mBindings;
+
+#if RCF_FEATURE_PUBSUB==1
+
+    private:
+
+        friend class Subscription;
+        friend class MulticastReceiver;
+        friend class SubscriptionDispatchQueue;
+
+        void setDispatchQueue(SubscriptionDispatchQueuePtr dispatchQueuePtr);
+        bool queueForDispatch(
+            const ByteBuffer &                  readByteBuffer, 
+            const std::vector<ByteBuffer> &     readChunks, 
+            MemIstreamSourcePtr                 sourcePtr);
+
+        // Oneway requests on subscriptions with a dispatcher are queued, and dispatched on the threads of the 
+        // dispatcher, rather than on this session.
+        SubscriptionDispatchQueuePtr            mDispatchQueuePtr;
+
+#endif
+
+#if RCF_FEATURE_PROTOBUF==1
+
+    private:
+
+        friend class ServerBinding;
+
+        // Set by ServerBinding for each call. The arena is reset when the call parameters are cleared, and
+        // keeps its initial block, so calls that fit in the block don't allocate.
+        bool                                        mEnableProtobufArena = false;
+        std::vector<char>                           mProtobufArenaBlock;
+        std::unique_ptr<google::protobuf::Arena>    mProtobufArenaPtr;
+
+#endif
+
     public:
         NetworkSession & getNetworkSession() const;
         void setNetworkSession(NetworkSession & networkSession);
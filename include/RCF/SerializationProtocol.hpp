@@ -50,6 +50,7 @@ namespace RCF {
 
     class MethodInvocationRequest;
     class MethodInvocationResponse;
+    class I_Parameters;
 
     class RCF_EXPORT SerializationProtocolIn
     {
@@ -67,6 +68,15 @@ namespace RCF {
                             int protocol, 
                             int runtimeVersion, 
                             int archiveVersion,
+                            bool enableSfPointerTracking,
+                            MemIstreamSourcePtr sourcePtr = MemIstreamSourcePtr());
+
+        // Reads from the chunks of a message received with chunked framing.
+        void            reset(
+                            const std::vector<ByteBuffer> &chunks, 
+                            int protocol, 
+                            int runtimeVersion, 
+                            int archiveVersion,
                             bool enableSfPointerTracking);
 
         void            clearByteBuffer();
@@ -119,12 +129,16 @@ namespace RCF {
 
         void            bindProtocol();
         void            unbindProtocol();
+        void            extractChunkSlice(ByteBuffer &byteBuffer, std::size_t pos, std::size_t len);
 
         friend class ClientStub; // TODO
         friend class RcfSession; // TODO
 
         int                                     mProtocol;
         ByteBuffer                              mByteBuffer;
+        std::vector<ByteBuffer>                 mChunks;
+        std::size_t                             mArchiveLength;
+        MemIstreamSourcePtr                     mSourcePtr;
         MemIstream                              mIs;
 
         Protocol< Int<1> >::In     mInProtocol1;
@@ -186,6 +200,13 @@ namespace RCF {
         void    extractByteBuffers();
         void    extractByteBuffers(std::vector<ByteBuffer> &byteBuffers);
 
+        // Grows the message buffer, so that a further len bytes can be written without reallocating.
+        void    reserve(std::size_t len);
+
+        // Writes remote call parameters. If sizing is enabled, the message buffer is reserved up front, using the
+        // size of the last message written for the same fnId, or else a sizing pass over the parameters.
+        void    writeParameters(I_Parameters & parameters, int fnId, bool enableSizing);
+
         int     getRuntimeVersion();
 
     private:
@@ -193,6 +214,9 @@ namespace RCF {
         void    bindProtocol();
         void    unbindProtocol();
 
+        bool        beginSizing();
+        std::size_t endSizing();
+
 
         friend class ClientStub; // TODO
         friend class RcfSession; // TODO
@@ -211,6 +235,10 @@ namespace RCF {
 
         int                                                 mRuntimeVersion;
         int                                                 mArchiveVersion;
+
+        bool                                                mSizing;
+        std::unique_ptr<CountingOstream>                    mCountingOsPtr;
+        std::map<int, std::size_t>                          mSizeHints;
     };
 
     inline void serialize(
@@ -257,6 +285,10 @@ namespace RCF {
 
 #if RCF_FEATURE_PROTOBUF==1
 
+    // Returns the arena that Protobuf parameters of the remote call being dispatched on this thread are 
+    // constructed on, or NULL if arena construction is not enabled for the call.
+    RCF_EXPORT google::protobuf::Arena * getCurrentProtobufArena();
+
     // Some compile-time gymnastics to detect Protobuf classes, so we don't 
     // pass them off to SF or Boost.Serialization.
 
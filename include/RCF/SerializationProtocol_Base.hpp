@@ -148,7 +148,7 @@ namespace RCF {
         {
         public:
             void bind(
-                RCF::MemOstream &os, 
+                std::ostream &os, 
                 int runtimeVersion, 
                 int archiveVersion,
                 SerializationProtocolOut & spOut)
@@ -21,6 +21,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include <RCF/Config.hpp>
@@ -331,6 +332,23 @@ namespace RCF {
         /// a remote method on this server binding.
         void setAccessControl(AccessControlCallback cbAccessControl);
 
+#if RCF_FEATURE_PROTOBUF==1
+
+        /// Enables construction of Protobuf parameters and return values on a per-call arena, for the methods
+        /// of this server binding. Nested messages and strings are then allocated from the arena rather than the
+        /// heap, and are released together when the call completes. Servant code must not retain pointers to 
+        /// arena constructed parameters beyond the call. Disabled by default.
+        void setEnableProtobufArena(bool enable);
+
+        /// Gets a value indicating if Protobuf arena construction is enabled for this server binding.
+        bool getEnableProtobufArena();
+
+        /// Excludes an individual method from Protobuf arena construction. fnId is the zero based index of the
+        /// method within the RCF interface, as passed to the access control callback.
+        void setProtobufArenaOptOut(int fnId, bool optOut = true);
+
+#endif
+
         template<typename RcfClientT, typename RefWrapperT>
         void addServerMethods(RcfClientT &rcfClient, RefWrapperT refWrapper)
         {
@@ -353,6 +371,11 @@ namespace RCF {
         Mutex                           mMutex;
         ServerMethodPtr                 mServerMethodPtr;
         AccessControlCallback           mCbAccessControl;
+
+#if RCF_FEATURE_PROTOBUF==1
+        bool                            mEnableProtobufArena = false;
+        std::set<int>                   mProtobufArenaOptOuts;
+#endif
     };
 
     template<typename InterfaceT, typename ImplementationT, typename ImplementationPtrT>
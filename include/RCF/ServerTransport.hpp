@@ -49,6 +49,9 @@ namespace RCF {
     enum TransportProtocol;
     enum TransportType;
 
+    class MemIstreamSource;
+    typedef std::shared_ptr<MemIstreamSource> MemIstreamSourcePtr;
+
     /// Indicates that no remote address is available.
     class NoRemoteAddress : public RemoteAddress
     {};
@@ -81,6 +84,13 @@ namespace RCF {
         
         virtual void        getWireFilters(std::vector<FilterPtr> &filters);
 
+        // Returns a source for the request being read, if it is being processed before it has been fully received.
+        virtual MemIstreamSourcePtr 
+                            getIncrementalReadSource();
+
+        // Returns the chunks of the last message read, if it was sent with chunked framing. Otherwise chunks is 
+        // left empty, and the message is returned by getReadByteBuffer().
+        virtual void        getReadChunks(std::vector<ByteBuffer> & chunks);
 
 
         std::uint64_t       getTotalBytesReceived() const;
@@ -153,6 +163,29 @@ namespace RCF {
         /// Returns the initial number of listening connections that are created when the server transport starts.
         std::size_t         getInitialNumberOfConnections() const;
 
+        /// Sets the message length above which requests are deserialized while they are still being received.
+
+        /// Normally a request is deserialized once it has been fully received. For requests at least this long, 
+        /// deserialization starts as soon as the request header has arrived, and proceeds as the rest of the 
+        /// request comes in, overlapping decoding with network transfer. Incremental reads require a server thread 
+        /// pool with more than one thread, and are only made over TCP, UNIX local socket and named pipe 
+        /// transports, without transport or message filters. Zero disables incremental reads, which is the default.
+        void                setIncrementalReadThreshold(std::size_t messageLength);
+
+        /// Returns the message length above which requests are deserialized while they are still being received.
+        std::size_t         getIncrementalReadThreshold() const;
+
+        /// Sets the maximum frame size for responses to clients that send requests with chunked framing.
+
+        /// Clients enable chunked framing with ClientStub::setMessageChunkSize(). Responses to chunked requests 
+        /// are split into frames of at most this size, so the client doesn't need a single buffer large enough 
+        /// for the whole response. Zero sends responses in a single frame. Sizes below 4 KB are 
+        /// rounded up. The default is 1 MB.
+        void                setMessageChunkSize(std::size_t chunkSize);
+
+        /// Returns the maximum frame size for responses to clients that send requests with chunked framing.
+        std::size_t         getMessageChunkSize() const;
+
         /// Sets the thread pool that the server transport will use.
         void                setThreadPool(ThreadPoolPtr threadPoolPtr);
 
@@ -181,6 +214,8 @@ namespace RCF {
         std::size_t                 mMaxMessageLength;
         std::size_t                 mConnectionLimit;       
         std::size_t                 mInitialNumberOfConnections;
+        std::size_t                 mIncrementalReadThreshold;
+        std::size_t                 mMessageChunkSize;
 
         std::vector<TransportProtocol> mSupportedProtocols;
 
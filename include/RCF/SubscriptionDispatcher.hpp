@@ -0,0 +1,161 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_RCF_SUBSCRIPTIONDISPATCHER_HPP
+#define INCLUDE_RCF_SUBSCRIPTIONDISPATCHER_HPP
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <RCF/ByteBuffer.hpp>
+#include <RCF/Enums.hpp>
+#include <RCF/Export.hpp>
+#include <RCF/RcfFwd.hpp>
+#include <RCF/ServerTransport.hpp>
+#include <RCF/ThreadLibrary.hpp>
+#include <RCF/ThreadPool.hpp>
+#include <RCF/Tools.hpp>
+
+namespace RCF {
+
+    class IpAddress;
+    class SubscriptionDispatchStats;
+
+    class DispatchStrand;
+    typedef std::shared_ptr<DispatchStrand> DispatchStrandPtr;
+
+    class DispatchNetworkSession;
+    typedef std::shared_ptr<DispatchNetworkSession> DispatchNetworkSessionPtr;
+
+    /// A fixed size pool of threads, dispatching the messages of subscriptions. 
+    
+    /// Subscriptions are assigned a dispatcher with SubscriptionParms::setDispatcher(), and a dispatcher may be 
+    /// shared by any number of subscriptions. Messages are then read from the publisher ahead of being dispatched, 
+    /// and dispatched on the threads of the dispatcher, rather than on the server thread that read them. Messages 
+    /// of a subscription are dispatched in order, either all together or per message key, according to the 
+    /// DispatchOrdering of the subscription.
+    class RCF_EXPORT SubscriptionDispatcher : Noncopyable
+    {
+    public:
+
+        /// Constructs a dispatcher with threadCount threads. The threads are started when the first message is 
+        /// dispatched.
+        SubscriptionDispatcher(std::size_t threadCount);
+
+        ~SubscriptionDispatcher();
+
+        /// Gets the number of threads of the dispatcher.
+        std::size_t         getThreadCount() const;
+
+        /// Stops the threads of the dispatcher. Messages that have not yet been dispatched are discarded.
+        void                stop();
+
+    private:
+
+        friend class SubscriptionDispatchQueue;
+
+        void                schedule(DispatchStrandPtr strandPtr);
+        void                unschedule(SubscriptionDispatchQueue * pQueue);
+
+        bool                dispatchTask();
+        void                stopDispatchTask();
+
+        const std::size_t               mThreadCount;
+
+        Mutex                           mMutex;
+        Condition                       mCondition;
+        std::deque<DispatchStrandPtr>   mReadyStrands;
+
+        ThreadPool                      mThreadPool;
+    };
+
+    // Messages of a subscription that are waiting to be dispatched. Each ordering key of the subscription has a 
+    // strand, holding the messages for that key, and a strand is dispatched by one dispatcher thread at a time.
+    class RCF_EXPORT SubscriptionDispatchQueue : 
+        public std::enable_shared_from_this<SubscriptionDispatchQueue>, 
+        Noncopyable
+    {
+    public:
+
+        SubscriptionDispatchQueue(
+            RcfServer &                     server,
+            SubscriptionDispatcherPtr       dispatcherPtr,
+            DispatchOrdering                ordering,
+            std::size_t                     queueLimit,
+            RcfClientPtr                    rcfClientPtr);
+
+        ~SubscriptionDispatchQueue();
+
+        // Queues a message read on the session. Returns false if the queue is full, in which case the session 
+        // should stop reading, and the queue resumes reading on the session once it has drained.
+        bool                push(RcfSession & session, const ByteBuffer & message);
+
+        // Discards queued messages, and waits for messages being dispatched on other threads.
+        void                close();
+
+        void                getStats(SubscriptionDispatchStats & stats);
+
+    private:
+
+        friend class SubscriptionDispatcher;
+
+        void                dispatch(DispatchStrandPtr strandPtr);
+
+        DispatchNetworkSessionPtr createDispatchSession();
+
+        RcfServer &                     mServer;
+        SubscriptionDispatcherPtr       mDispatcherPtr;
+        const DispatchOrdering          mOrdering;
+        const std::size_t               mQueueLimit;
+        RcfClientPtr                    mRcfClientPtr;
+
+        Mutex                           mMutex;
+        Condition                       mCondition;
+        bool                            mClosed;
+
+        typedef std::unordered_map<std::string, DispatchStrandPtr> Strands;
+        Strands                         mStrands;
+
+        // Threads currently dispatching messages of the subscription.
+        std::vector<ThreadId>           mDispatchingThreads;
+
+        // Sessions that messages are dispatched on, one for each strand being dispatched. They are created with 
+        // the transport and address of the session that read the messages.
+        std::vector<DispatchNetworkSessionPtr> mIdleSessions;
+        ServerTransport *               mpServerTransport;
+        std::shared_ptr<IpAddress>      mIpAddressPtr;
+        TransportProtocol               mTransportProtocol;
+
+        // Session to resume reading on, once the queue has drained. Nothing else keeps the network session alive 
+        // while no read is posted on it.
+        NetworkSessionPtr               mPausedNetworkSessionPtr;
+        bool                            mPaused;
+
+        std::size_t                     mQueueDepth;
+        std::uint64_t                   mDispatchedCount;
+        std::uint32_t                   mLastLagMs;
+        std::uint32_t                   mMaxLagMs;
+    };
+
+} // namespace RCF
+
+#endif // ! INCLUDE_RCF_SUBSCRIPTIONDISPATCHER_HPP
@@ -0,0 +1,74 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_RCF_SUBSCRIPTIONFILTER_HPP
+#define INCLUDE_RCF_SUBSCRIPTIONFILTER_HPP
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <RCF/ByteBuffer.hpp>
+#include <RCF/Export.hpp>
+
+namespace RCF {
+
+    /// Selects the messages a subscriber receives from a publisher, by message key.
+
+    /// A subscription filter is passed to the publisher when subscribing, and is evaluated by the publisher 
+    /// against the key of each message published with Publisher<>::publish(key). Messages whose key doesn't 
+    /// match are not sent to the subscriber. Messages published without a key are sent to all subscribers.
+    ///
+    /// An empty filter matches all messages. Publishers that don't support subscription filters ignore them, 
+    /// and send all messages to the subscriber.
+    class RCF_EXPORT SubscriptionFilter
+    {
+    public:
+
+        /// Adds a key to the filter. Messages published with this key are matched.
+        void            addKey(const std::string & key);
+
+        /// Adds a key range to the filter. Messages published with a key in the range [firstKey, lastKey], in 
+        /// lexicographic order, are matched. Numeric keys should be published with a fixed width, e.g. "000123".
+        void            addKeyRange(const std::string & firstKey, const std::string & lastKey);
+
+        /// Returns true if no keys or key ranges have been added to the filter.
+        bool            isEmpty() const;
+
+        /// Returns true if a message published with the given key is matched by the filter.
+        bool            matches(const std::string & key) const;
+
+        /// Gets the keys of the filter.
+        const std::set<std::string> & getKeys() const;
+
+        /// Gets the key ranges of the filter.
+        const std::vector< std::pair<std::string, std::string> > & getKeyRanges() const;
+
+        void            encode(std::vector<char> & vec, std::size_t & pos) const;
+        void            decode(const ByteBuffer & buffer, std::size_t & pos);
+
+    private:
+
+        std::set<std::string>                               mKeys;
+        std::vector< std::pair<std::string, std::string> >  mKeyRanges;
+    };
+
+} // namespace RCF
+
+#endif // ! INCLUDE_RCF_SUBSCRIPTIONFILTER_HPP
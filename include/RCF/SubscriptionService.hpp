@@ -33,9 +33,51 @@
 #include <RCF/PeriodicTimer.hpp>
 #include <RCF/ServerStub.hpp>
 #include <RCF/Service.hpp>
+#include <RCF/SubscriptionFilter.hpp>
 
 namespace RCF {
 
+    /// Delivery statistics of a subscription receiving messages from a multicast group.
+    class RCF_EXPORT MulticastReceiveStats
+    {
+    public:
+        MulticastReceiveStats();
+
+        /// Number of messages received from the multicast group.
+        std::uint64_t   mReceivedCount;
+
+        /// Number of lost messages recovered through retransmit requests to the publisher.
+        std::uint64_t   mRecoveredCount;
+
+        /// Number of lost messages that could not be recovered.
+        std::uint64_t   mLostCount;
+
+        /// Number of duplicate, late or malformed datagrams discarded.
+        std::uint64_t   mDiscardedCount;
+    };
+
+    /// Dispatch statistics of a subscription with a SubscriptionDispatcher.
+    class RCF_EXPORT SubscriptionDispatchStats
+    {
+    public:
+        SubscriptionDispatchStats();
+
+        /// Number of messages waiting to be dispatched.
+        std::size_t     mQueueDepth;
+
+        /// Number of messages dispatched.
+        std::uint64_t   mDispatchedCount;
+
+        /// Time in ms that the most recently dispatched message waited in the queue.
+        std::uint32_t   mLastLagMs;
+
+        /// Longest time in ms that a message has waited in the queue.
+        std::uint32_t   mMaxLagMs;
+
+        /// Whether reading from the publisher is paused, because the queue is full.
+        bool            mReadPaused;
+    };
+
     /// Represents a subscription to a RCF publisher. To create a subscription, use RcfServer::createSubscription().
     class RCF_EXPORT Subscription : Noncopyable
     {
@@ -65,11 +107,24 @@ namespace RCF {
         /// Closes the subscription and disconnects from the publisher.
         void            close();
 
+        /// Checks if the subscription receives messages from a multicast group of the publisher. See 
+        /// SubscriptionParms::setMulticastEndpoint().
+        bool            isMulticastDelivery();
+
+        /// Gets the delivery statistics of a subscription receiving messages from a multicast group.
+        void            getMulticastReceiveStats(MulticastReceiveStats & stats);
+
+        /// Gets the dispatch statistics of a subscription with a SubscriptionDispatcher. See 
+        /// SubscriptionParms::setDispatcher().
+        void            getDispatchStats(SubscriptionDispatchStats & stats);
+
     private:
         friend class SubscriptionService;
 
         static void     onDisconnect(SubscriptionWeakPtr subPtr, RcfSession & session);
 
+        void            setDispatchQueue(SubscriptionDispatchQueuePtr dispatchQueuePtr);
+
         SubscriptionService &       mSubscriptionService;
         SubscriptionWeakPtr         mThisWeakPtr;
 
@@ -85,6 +140,9 @@ namespace RCF {
 
         OnSubscriptionDisconnect    mOnDisconnect;
         bool                        mClosed = false;
+
+        MulticastReceiverPtr        mMulticastReceiverPtr;
+        SubscriptionDispatchQueuePtr mDispatchQueuePtr;
     };
 
     /// General configuration of a subscription.
@@ -111,6 +169,40 @@ namespace RCF {
         /// Configures a callback to be called when an asynchronous subscription connection is established.
         void        setOnAsyncSubscribeCompleted(OnAsyncSubscribeCompleted onAsyncSubscribeCompleted);
 
+        /// Sets a filter, evaluated by the publisher, selecting the messages to be sent to the subscriber. By 
+        /// default all messages are sent.
+        void        setFilter(const SubscriptionFilter & filter);
+
+        /// Gets the filter of the subscription.
+        const SubscriptionFilter & getFilter() const;
+
+        /// Receives the messages of the subscription from the multicast group of the publisher, instead of on 
+        /// the subscription connection. groupEp is typically a UdpEndpoint listening on the multicast IP address 
+        /// configured with PublisherParms::setMulticastEndpoint(). Messages are dispatched in sequence, and lost 
+        /// messages are requested again from the publisher. If the publisher has no multicast group, messages 
+        /// are sent on the subscription connection as usual.
+        void        setMulticastEndpoint(const Endpoint & groupEp);
+
+        /// Sets whether messages lost on the multicast group are requested again from the publisher, on a 
+        /// separate connection. The default is true.
+        void        setMulticastRetransmit(bool enable);
+
+        /// Dispatches the messages of the subscription on the threads of dispatcherPtr, rather than on the server 
+        /// thread reading them from the publisher. With Do_PerSubscription, messages are dispatched one at a time, 
+        /// in the order they were published. With Do_PerKey, messages with the same key, as passed to 
+        /// Publisher::publish(), are dispatched in order, and messages with different keys are dispatched 
+        /// in parallel. Only oneway messages are queued, and messages received before the subscription is 
+        /// established are dispatched directly.
+        void        setDispatcher(
+                        SubscriptionDispatcherPtr   dispatcherPtr, 
+                        DispatchOrdering            ordering = Do_PerSubscription);
+
+        /// Sets the number of messages the subscription may have waiting to be dispatched. When the limit is 
+        /// reached, reading from the publisher is paused until half the queued messages have been dispatched. 
+        /// Messages received from a multicast group are never held back. The default is 1000, and 0 means no 
+        /// limit.
+        void        setDispatchQueueLimit(std::size_t queueLimit);
+
     private:
 
         friend class SubscriptionService;
@@ -119,6 +211,12 @@ namespace RCF {
         ClientStub                              mClientStub;
         OnSubscriptionDisconnect                mOnDisconnect;
         OnAsyncSubscribeCompleted               mOnAsyncSubscribeCompleted;
+        SubscriptionFilter                      mFilter;
+        EndpointPtr                             mMulticastEndpointPtr;
+        bool                                    mMulticastRetransmit;
+        SubscriptionDispatcherPtr               mDispatcherPtr;
+        DispatchOrdering                        mDispatchOrdering;
+        std::size_t                             mDispatchQueueLimit;
     };
 
     class RCF_EXPORT SubscriptionService :
@@ -175,7 +273,8 @@ namespace RCF {
             OnSubscriptionDisconnect                onDisconnect,
             OnAsyncSubscribeCompleted               onCompletion,
             std::uint32_t                         pubToSubPingIntervalMs,
-            bool                                    pingsEnabled);
+            bool                                    pingsEnabled,
+            MulticastReceiverPtr                    multicastReceiverPtr = MulticastReceiverPtr());
 
         void closeSubscription(SubscriptionWeakPtr subscriptionPtr);
 
@@ -211,22 +310,41 @@ namespace RCF {
             RcfClientPtr                            rcfClientPtr,
             OnSubscriptionDisconnect                onDisconnect,
             std::uint32_t                           pubToSubPingIntervalMs,
-            bool                                    pingsEnabled);
+            bool                                    pingsEnabled,
+            MulticastReceiverPtr                    multicastReceiverPtr = MulticastReceiverPtr());
 
     private:
 
+        MulticastReceiverPtr createMulticastReceiver(
+            RcfClientPtr                    rcfClientPtr,
+            const SubscriptionParms &       parms,
+            const std::string &             publisherName);
+
+        SubscriptionDispatchQueuePtr createDispatchQueue(
+            RcfClientPtr                    rcfClientPtr,
+            const SubscriptionParms &       parms);
+
+        void onAsyncSubscribeCompleted(
+            SubscriptionPtr                 subscriptionPtr,
+            ExceptionPtr                    ePtr,
+            SubscriptionDispatchQueuePtr    dispatchQueuePtr,
+            OnAsyncSubscribeCompleted       onCompletion);
+
         std::int32_t doRequestSubscription(
             ClientStub &                    clientStubOrig, 
             const std::string &             publisherName,
+            const SubscriptionFilter &      filter,
             std::uint32_t                   subToPubPingIntervalMs, 
             std::uint32_t &                 pubToSubPingIntervalMs,
-            bool &                          pingsEnabled);
+            bool &                          pingsEnabled,
+            bool &                          multicastDelivery);
 
         void doRequestSubscriptionAsync(
             ClientStub &                    clientStubOrig, 
             const std::string &             publisherName,
             RcfClientPtr                    rcfClientPtr,
-            const SubscriptionParms &       parms);
+            const SubscriptionParms &       parms,
+            OnAsyncSubscribeCompleted       onCompletion);
 
         void doRequestSubscriptionAsync_Complete(
             Future<Void>                    fv,
@@ -234,7 +352,8 @@ namespace RCF {
             const std::string &             publisherName,
             RcfClientPtr                    rcfClientPtr,
             OnSubscriptionDisconnect        onDisconnect,
-            OnAsyncSubscribeCompleted       onCompletion);
+            OnAsyncSubscribeCompleted       onCompletion,
+            MulticastReceiverPtr            multicastReceiverPtr);
 
         // Legacy subscription requests.
 
@@ -249,7 +368,8 @@ namespace RCF {
             ClientStub &                    clientStubOrig,
             const std::string &             publisherName,
             RcfClientPtr                    rcfClientPtr,
-            const SubscriptionParms &       parms);
+            const SubscriptionParms &       parms,
+            OnAsyncSubscribeCompleted       onCompletion);
 
         void doRequestSubscriptionAsync_Legacy_Complete(
             ClientStubPtr                   clientStubPtr,
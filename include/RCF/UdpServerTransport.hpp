@@ -60,6 +60,7 @@ namespace RCF {
         SessionPtr                                  mRcfSessionPtr;
 
         friend class UdpServerTransport;
+        friend class MulticastReceiver;
 
     private:
 
@@ -137,6 +138,7 @@ namespace RCF {
         bool                mEnableSharedAddressBinding;
 
         friend class UdpNetworkSession;
+        friend class MulticastReceiver;
 
     };
 
@@ -86,6 +86,10 @@ namespace RCF {
     // 2017-09-04   - version number 13
     //      - Serialization of fs::path changed to use wstring instead of string.
     //      - Serialization of RemoteException changed.
+
+    // 2026-10-18   - version number 14
+    //      - SF: Polymorphic type names interned per archive, and written as integer id's after first occurrence.
+    //      - File transfer chunks carry a compression flag, and can be compressed with zlib.
  
 
     /// Gets the maximum RCF runtime version number this RCF build supports.
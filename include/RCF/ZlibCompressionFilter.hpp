@@ -36,6 +36,13 @@ namespace RCF {
 
     std::string zlibError(int zErr);
 
+    // One shot compression at the fastest level, as used for file transfer chunks. Returns false if the 
+    // compressed data doesn't fit in maxLength bytes.
+    bool zlibCompress(const ByteBuffer & data, ByteBuffer & compressed, std::size_t maxLength);
+
+    // One shot decompression, of data that decompresses to exactly length bytes.
+    void zlibDecompress(const ByteBuffer & compressed, ByteBuffer & data, std::size_t length);
+
     class RCF_EXPORT ZlibCompressionFilterBase : 
         public Filter, 
         Noncopyable
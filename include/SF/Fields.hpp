@@ -0,0 +1,260 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_SF_FIELDS_HPP
+#define INCLUDE_SF_FIELDS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+#include <RCF/ByteOrdering.hpp>
+#include <RCF/Exception.hpp>
+#include <RCF/Tools.hpp>
+
+#include <SF/Archive.hpp>
+#include <SF/Serializer.hpp>
+#include <SF/Stream.hpp>
+
+/// Declares the serialized fields of a class, in the order they are written.
+
+/// Place SF_FIELDS() in the class definition, after the listed members:
+/// @code
+/// struct Point
+/// {
+///     std::int32_t    x;
+///     std::int32_t    y;
+///     std::string     label;
+///
+///     SF_FIELDS(Point, x, y, label)
+/// };
+/// @endcode
+///
+/// Values of the class are serialized without the Node header that SF normally writes around each object. Runs of
+/// arithmetic and enum fields are packed into a fixed size buffer whose size is computed at compile time, and written
+/// with a single call. Other fields are serialized as usual.
+///
+/// The number of fields is written ahead of the fields, and acts as the version tag of the field list. Fields may be
+/// appended to the end of the list: when reading an archive written with fewer fields, the remaining fields are left
+/// as they are. Reading an archive written with more fields than are declared, fails with RcfError_SfDataFormat.
+///
+/// Arithmetic fields are written with their native size, so prefer fixed width types such as std::int32_t. Values
+/// serialized through SF_FIELDS() are not registered for pointer tracking.
+#define SF_FIELDS(T, ...)                                                   \
+    typedef T SfFieldsType;                                                 \
+                                                                            \
+    auto sfFields() -> decltype(std::tie(__VA_ARGS__))                      \
+    {                                                                       \
+        return std::tie(__VA_ARGS__);                                       \
+    }                                                                       \
+                                                                            \
+    void serialize(SF::Archive & ar)                                        \
+    {                                                                       \
+        SF::serializeFields(ar, *this);                                     \
+    }
+
+namespace SF {
+
+    // Wire size of arithmetic and enum fields. Enums are written as 32 bit integers, as serializeEnum() does.
+    template<typename T>
+    struct FixedField
+    {
+        static const bool IsFixed = std::is_arithmetic<T>::value || std::is_enum<T>::value;
+        static const std::size_t Size = std::is_enum<T>::value ? 4 : sizeof(T);
+    };
+
+    template<typename T>
+    inline void packField(const T & t, char * pch, RCF::FalseType *)
+    {
+        memcpy(pch, &t, sizeof(T));
+        RCF::machineToNetworkOrder(pch, static_cast<int>(sizeof(T)), 1);
+    }
+
+    template<typename T>
+    inline void packField(const T & t, char * pch, RCF::TrueType *)
+    {
+        std::int32_t n = static_cast<std::int32_t>(t);
+        packField(n, pch, (RCF::FalseType *) NULL);
+    }
+
+    template<typename T>
+    inline void unpackField(T & t, char * pch, RCF::FalseType *)
+    {
+        RCF::networkToMachineOrder(pch, static_cast<int>(sizeof(T)), 1);
+        memcpy(&t, pch, sizeof(T));
+    }
+
+    template<typename T>
+    inline void unpackField(T & t, char * pch, RCF::TrueType *)
+    {
+        std::int32_t n = 0;
+        unpackField(n, pch, (RCF::FalseType *) NULL);
+        t = static_cast<T>(n);
+    }
+
+    // Packs Count fixed size fields, starting at field I.
+    template<typename Fields, std::size_t I, std::size_t Count>
+    struct FieldPacker
+    {
+        typedef typename std::remove_reference<
+            typename std::tuple_element<I, Fields>::type>::type FieldT;
+
+        typedef typename std::is_enum<FieldT>::type IsEnum;
+
+        static void pack(Fields & fields, char * pch)
+        {
+            packField(std::get<I>(fields), pch, (IsEnum *) NULL);
+            FieldPacker<Fields, I+1, Count-1>::pack(fields, pch + FixedField<FieldT>::Size);
+        }
+
+        static void unpack(Fields & fields, char * pch)
+        {
+            unpackField(std::get<I>(fields), pch, (IsEnum *) NULL);
+            FieldPacker<Fields, I+1, Count-1>::unpack(fields, pch + FixedField<FieldT>::Size);
+        }
+    };
+
+    template<typename Fields, std::size_t I>
+    struct FieldPacker<Fields, I, 0>
+    {
+        static void pack(Fields &, char *)
+        {}
+
+        static void unpack(Fields &, char *)
+        {}
+    };
+
+    // Serializes fields I to N-1.
+    template<typename Fields, std::size_t I, std::size_t N>
+    struct FieldList
+    {
+        typedef typename std::remove_reference<
+            typename std::tuple_element<I, Fields>::type>::type FieldT;
+
+        typedef FieldList<Fields, I+1, N> Next;
+
+        typedef std::integral_constant<bool, FixedField<FieldT>::IsFixed> IsFixed;
+
+        // Number and total size of the run of fixed size fields starting at field I.
+        static const std::size_t RunCount = IsFixed::value ? 1 + Next::RunCount : 0;
+        static const std::size_t RunBytes = IsFixed::value ? FixedField<FieldT>::Size + Next::RunBytes : 0;
+
+        static void write(Archive & ar, Fields & fields)
+        {
+            write(ar, fields, (IsFixed *) NULL);
+        }
+
+        static void read(Archive & ar, Fields & fields, std::size_t count)
+        {
+            if (I < count)
+            {
+                read(ar, fields, count, (IsFixed *) NULL);
+            }
+        }
+
+    private:
+
+        typedef FieldList<Fields, I + RunCount, N> AfterRun;
+
+        static void write(Archive & ar, Fields & fields, RCF::TrueType *)
+        {
+            char buffer[RunBytes];
+            FieldPacker<Fields, I, RunCount>::pack(fields, buffer);
+            ar.getOstream()->writeRaw(buffer, static_cast<UInt32>(RunBytes));
+            AfterRun::write(ar, fields);
+        }
+
+        static void write(Archive & ar, Fields & fields, RCF::FalseType *)
+        {
+            ar & std::get<I>(fields);
+            Next::write(ar, fields);
+        }
+
+        static void readRaw(Archive & ar, char * pch, std::size_t len)
+        {
+            UInt32 bytesToRead = static_cast<UInt32>(len);
+            RCF_VERIFY(
+                ar.getIstream()->read(pch, bytesToRead) == bytesToRead,
+                RCF::Exception(RCF::RcfError_SfReadFailure));
+        }
+
+        static void read(Archive & ar, Fields & fields, std::size_t count, RCF::TrueType *)
+        {
+            if (count - I >= RunCount)
+            {
+                char buffer[RunBytes];
+                readRaw(ar, buffer, RunBytes);
+                FieldPacker<Fields, I, RunCount>::unpack(fields, buffer);
+                AfterRun::read(ar, fields, count);
+            }
+            else
+            {
+                // Written with fewer fields, so the run is cut short.
+                char buffer[FixedField<FieldT>::Size];
+                readRaw(ar, buffer, FixedField<FieldT>::Size);
+                FieldPacker<Fields, I, 1>::unpack(fields, buffer);
+                Next::read(ar, fields, count);
+            }
+        }
+
+        static void read(Archive & ar, Fields & fields, std::size_t count, RCF::FalseType *)
+        {
+            ar & std::get<I>(fields);
+            Next::read(ar, fields, count);
+        }
+    };
+
+    template<typename Fields, std::size_t N>
+    struct FieldList<Fields, N, N>
+    {
+        static const std::size_t RunCount = 0;
+        static const std::size_t RunBytes = 0;
+
+        static void write(Archive &, Fields &)
+        {}
+
+        static void read(Archive &, Fields &, std::size_t)
+        {}
+    };
+
+    template<typename T>
+    void serializeFields(Archive & ar, T & t)
+    {
+        typedef decltype(t.sfFields()) Fields;
+        const std::size_t FieldCount = std::tuple_size<Fields>::value;
+
+        Fields fields = t.sfFields();
+
+        if (ar.isRead())
+        {
+            UInt32 count = 0;
+            ar.getIstream()->read_int(count);
+            RCF_VERIFY(count <= FieldCount, RCF::Exception(RCF::RcfError_SfDataFormat));
+            FieldList<Fields, 0, FieldCount>::read(ar, fields, count);
+        }
+        else if (ar.isWrite())
+        {
+            ar.getOstream()->write_int(static_cast<UInt32>(FieldCount));
+            FieldList<Fields, 0, FieldCount>::write(ar, fields);
+        }
+    }
+
+} // namespace SF
+
+#endif // ! INCLUDE_SF_FIELDS_HPP
@@ -0,0 +1,210 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_SF_FLATHASHMAP_HPP
+#define INCLUDE_SF_FLATHASHMAP_HPP
+
+#include <cstdint>
+#include <functional>
+#include <typeinfo>
+#include <vector>
+
+#include <RCF/Tools.hpp>
+
+namespace SF {
+
+    // Open addressing hash map with linear probing, used for pointer tracking.
+    // Entries can't be erased individually. clear() is constant time and keeps the
+    // allocated slots, so a map can be reused across archives without reallocating.
+
+    template<
+        typename Key,
+        typename Value,
+        typename Hash,
+        typename Equal = std::equal_to<Key> >
+    class FlatHashMap
+    {
+    public:
+
+        FlatHashMap() : mSize(0), mGeneration(1)
+        {}
+
+        std::size_t size() const
+        {
+            return mSize;
+        }
+
+        bool empty() const
+        {
+            return mSize == 0;
+        }
+
+        Value * find(const Key & key)
+        {
+            if (mSize == 0)
+            {
+                return NULL;
+            }
+
+            const std::size_t mask = mSlots.size() - 1;
+            std::size_t idx = mixHash( Hash()(key) ) & mask;
+            while (mSlots[idx].mGeneration == mGeneration)
+            {
+                if (Equal()(mSlots[idx].mKey, key))
+                {
+                    return &mSlots[idx].mValue;
+                }
+                idx = (idx + 1) & mask;
+            }
+            return NULL;
+        }
+
+        // Returns the value for key, inserting value first if key is not present.
+        Value & insert(const Key & key, const Value & value, bool & inserted)
+        {
+            if ( 2*(mSize + 1) > mSlots.size() )
+            {
+                grow();
+            }
+
+            const std::size_t mask = mSlots.size() - 1;
+            std::size_t idx = mixHash( Hash()(key) ) & mask;
+            while (mSlots[idx].mGeneration == mGeneration)
+            {
+                if (Equal()(mSlots[idx].mKey, key))
+                {
+                    inserted = false;
+                    return mSlots[idx].mValue;
+                }
+                idx = (idx + 1) & mask;
+            }
+
+            Slot & slot = mSlots[idx];
+            slot.mGeneration = mGeneration;
+            slot.mKey = key;
+            slot.mValue = value;
+            ++mSize;
+            inserted = true;
+            return slot.mValue;
+        }
+
+        Value & operator[](const Key & key)
+        {
+            bool inserted = false;
+            return insert(key, Value(), inserted);
+        }
+
+        void clear()
+        {
+            mSize = 0;
+            ++mGeneration;
+
+            // On wrap around, stale slots would appear occupied again.
+            if (mGeneration == 0)
+            {
+                for (std::size_t i=0; i<mSlots.size(); ++i)
+                {
+                    mSlots[i].mGeneration = 0;
+                }
+                mGeneration = 1;
+            }
+        }
+
+    private:
+
+        struct Slot
+        {
+            Slot() : mGeneration(0), mKey(), mValue()
+            {}
+
+            std::uint32_t   mGeneration;
+            Key             mKey;
+            Value           mValue;
+        };
+
+        static std::size_t mixHash(std::size_t h)
+        {
+            // Pointers are aligned, so spread the entropy into the low bits.
+            std::uint64_t x = static_cast<std::uint64_t>(h);
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdULL;
+            x ^= x >> 33;
+            return static_cast<std::size_t>(x);
+        }
+
+        void grow()
+        {
+            std::vector<Slot> slots(mSlots.empty() ? 16 : 2*mSlots.size());
+            slots.swap(mSlots);
+
+            const std::uint32_t oldGeneration = mGeneration;
+            mGeneration = 1;
+            mSize = 0;
+
+            for (std::size_t i=0; i<slots.size(); ++i)
+            {
+                if (slots[i].mGeneration == oldGeneration)
+                {
+                    bool inserted = false;
+                    insert(slots[i].mKey, slots[i].mValue, inserted);
+                }
+            }
+        }
+
+        std::vector<Slot>   mSlots;
+        std::size_t         mSize;
+        std::uint32_t       mGeneration;
+    };
+
+    // Key for maps of (address, type) pairs.
+    struct TypedPtr
+    {
+        TypedPtr() : mPtr(), mpType()
+        {}
+
+        TypedPtr(void * ptr, const std::type_info * pType) : mPtr(ptr), mpType(pType)
+        {}
+
+        bool operator==(const TypedPtr & rhs) const
+        {
+            return mPtr == rhs.mPtr && (mpType == rhs.mpType || *mpType == *rhs.mpType);
+        }
+
+        void *                  mPtr;
+        const std::type_info *  mpType;
+    };
+
+    struct TypedPtrHash
+    {
+        std::size_t operator()(const TypedPtr & key) const
+        {
+            return reinterpret_cast<std::size_t>(key.mPtr) ^ key.mpType->hash_code();
+        }
+    };
+
+    struct UInt32Hash
+    {
+        std::size_t operator()(std::uint32_t n) const
+        {
+            return n;
+        }
+    };
+
+} // namespace SF
+
+#endif // ! INCLUDE_SF_FLATHASHMAP_HPP
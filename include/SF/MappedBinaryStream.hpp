@@ -0,0 +1,163 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_SF_MAPPEDBINARYSTREAM_HPP
+#define INCLUDE_SF_MAPPEDBINARYSTREAM_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+
+#include <RCF/Export.hpp>
+#include <RCF/FileSystem.hpp>
+#include <RCF/MemStream.hpp>
+#include <RCF/Tools.hpp>
+
+#include <SF/IBinaryStream.hpp>
+#include <SF/OBinaryStream.hpp>
+
+namespace SF {
+
+    // Memory mapping of a whole file.
+    class RCF_EXPORT MappedFile : Noncopyable
+    {
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        // Maps an existing file for reading.
+        void            openRead(const RCF::Path & filePath);
+
+        // Creates or truncates a file, extends it to initialSize bytes, and maps it for writing.
+        void            openWrite(const RCF::Path & filePath, std::uint64_t initialSize);
+
+        // Extends or truncates a file opened for writing, and maps it again.
+        void            resize(std::uint64_t newSize);
+
+        // Unmaps and closes the file. A file opened for writing is first truncated to finalSize bytes.
+        void            close(std::uint64_t finalSize = 0);
+
+        bool            isOpen() const;
+        char *          getPtr() const;
+        std::uint64_t   getSize() const;
+
+    private:
+
+        void            map();
+        void            unmap();
+        bool            setFileSize(std::uint64_t size);
+
+        RCF::Path       mFilePath;
+        bool            mWrite;
+        char *          mpData;
+        std::uint64_t   mSize;
+
+#ifdef RCF_WINDOWS
+        void *          mhFile;
+        void *          mhMapping;
+#else
+        int             mFd;
+#endif
+    };
+
+    // Output stream buffer writing into a MappedFile, and growing the file as needed.
+    class MappedOstreamBuf : public std::streambuf, Noncopyable
+    {
+    public:
+        MappedOstreamBuf(MappedFile & file);
+
+        // Positions the put area at the beginning of the mapping.
+        void            reset();
+
+        std::uint64_t   getWritePos() const;
+
+    private:
+
+        int_type        overflow(int_type ch);
+
+        pos_type        seekoff(
+                            off_type off, 
+                            std::ios_base::seekdir dir,
+                            std::ios_base::openmode mode = std::ios_base::in | std::ios_base::out);
+
+        void            setPutArea(std::uint64_t pos);
+
+        MappedFile &    mFile;
+    };
+
+    /// Input stream that deserializes directly from a memory mapped file.
+
+    /// IMappedBinaryStream reads the same format as IBinaryStream, but rather than copying the file through a 
+    /// std::istream in small reads, it maps the whole file and reads from the mapping in place. The mapping is 
+    /// marked for sequential access, so the operating system reads ahead and discards pages that have been read.
+    /// The file is unmapped when the stream is closed or destroyed. Deserialized objects don't refer to the mapping.
+    class RCF_EXPORT IMappedBinaryStream : public IBinaryStream
+    {
+    public:
+
+        /// Maps the file and prepares to deserialize from it.
+        IMappedBinaryStream(const RCF::Path & filePath);
+
+        ~IMappedBinaryStream();
+
+        /// Unmaps the file.
+        void            close();
+
+        /// Returns the size of the mapped file.
+        std::uint64_t   getFileSize() const;
+
+    private:
+        MappedFile          mFile;
+        RCF::MemIstream     mIs;
+    };
+
+    /// Output stream that serializes directly into a memory mapped file.
+
+    /// OMappedBinaryStream writes the same format as OBinaryStream. The file is created, extended to initialSize 
+    /// bytes and mapped, and serialized data is written directly into the mapping. If the data outgrows the file, 
+    /// the file is doubled in size and mapped again, so initialSize should be an estimate of the final size. When 
+    /// the stream is closed, the file is truncated to the length of the serialized data. Writing the mapped pages 
+    /// back to disk is left to the operating system.
+    class RCF_EXPORT OMappedBinaryStream : public OBinaryStream
+    {
+    public:
+
+        /// Creates or truncates the file, and maps it for writing.
+        OMappedBinaryStream(
+            const RCF::Path &   filePath, 
+            std::uint64_t       initialSize = 64*1024*1024);
+
+        /// Closes the stream, if it has not already been closed.
+        ~OMappedBinaryStream();
+
+        /// Truncates the file to the length of the serialized data, and unmaps it.
+        void            close();
+
+        /// Returns the number of bytes serialized so far.
+        std::uint64_t   getBytesWritten() const;
+
+    private:
+        MappedFile          mFile;
+        MappedOstreamBuf    mBuf;
+        std::ostream        mOs;
+        std::uint64_t       mBytesWritten;
+    };
+
+} // namespace SF
+
+#endif // ! INCLUDE_SF_MAPPEDBINARYSTREAM_HPP
@@ -35,7 +35,8 @@ namespace SF {
             type(),
             label(),
             id(),
-            ref()
+            ref(),
+            typeId()
         {}
 
         Node(
@@ -46,13 +47,15 @@ namespace SF {
                 type(type),
                 label(label),
                 id(id),
-                ref(nullPtr)
+                ref(nullPtr),
+                typeId()
         {}
 
         DataPtr type;
         DataPtr label;
         UInt32 id;
         UInt32 ref;
+        UInt32 typeId;
     };
 
 } // namespace SF
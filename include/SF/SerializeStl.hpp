@@ -19,6 +19,8 @@
 #ifndef INCLUDE_SF_SERIALIZESTL_HPP
 #define INCLUDE_SF_SERIALIZESTL_HPP
 
+#include <utility>
+
 #include <SF/Archive.hpp>
 
 namespace SF {
@@ -43,6 +45,16 @@ namespace SF {
         }
     };
 
+    class EmplaceSemantics
+    {
+    public:
+        template<typename Container, typename Value>
+        void add(Container &container, Value &value)
+        {
+            container.emplace( std::move(value) );
+        }
+    };
+
     class ReserveSemantics
     {
     public:
@@ -34,6 +34,8 @@
 
 namespace SF {
 
+    class I_SerializerPolymorphic;
+
     // Generic serializer, subclassed by all other serializers.
 
     class RCF_EXPORT SerializerBase : Noncopyable
@@ -44,10 +46,14 @@ namespace SF {
 
         // Following are overridden to provide type-specific operations.
         virtual std::string getTypeName() = 0;
+        virtual const std::type_info & 
+                            getTypeInfo() = 0;
         virtual void        newObject(Archive &ar) = 0;
         virtual bool        isDerived() = 0;
         virtual std::string getDerivedTypeName() = 0;
-        virtual void        getSerializerPolymorphic(const std::string &derivedTypeName) = 0;
+        virtual I_SerializerPolymorphic * 
+                            getSerializerPolymorphic(const std::string &derivedTypeName) = 0;
+        virtual void        setSerializerPolymorphic(I_SerializerPolymorphic * pSerializer) = 0;
         virtual void        invokeSerializerPolymorphic(SF::Archive &) = 0;
         virtual void        serializeContents(Archive &ar) = 0;
         virtual void        addToInputContext(IStream *, const UInt32 &) = 0;
@@ -90,10 +96,14 @@ namespace SF {
         IdT                         id;
 
         std::string         getTypeName();
+        const std::type_info & 
+                            getTypeInfo();
         void                newObject(Archive &ar);
         bool                isDerived();
         std::string         getDerivedTypeName();
-        void                getSerializerPolymorphic(const std::string &derivedTypeName);
+        I_SerializerPolymorphic * 
+                            getSerializerPolymorphic(const std::string &derivedTypeName);
+        void                setSerializerPolymorphic(I_SerializerPolymorphic * pSerializer);
         void                invokeSerializerPolymorphic(SF::Archive &ar);
         void                serializeContents(Archive &ar);
         void                addToInputContext(SF::IStream *stream, const UInt32 &nid);
@@ -140,14 +150,67 @@ namespace SF {
         >::type Base;
     };
 
+    // Detects types declared with SF_FIELDS(). Derived classes don't inherit the
+    // declaration, and polymorphic types always go through Serializer<>.
+    template<typename T>
+    class IsFieldsType
+    {
+    private:
+        template<typename U>
+        static typename std::is_same<typename U::SfFieldsType, U>::type test(typename U::SfFieldsType *);
+
+        template<typename U>
+        static RCF::FalseType test(...);
+
+    public:
+        typedef std::integral_constant<bool,
+                decltype(test<T>(0))::value
+            &&  !std::is_polymorphic<T>::value> type;
+    };
+
+    template<typename T>
+    void serializeFields(Archive & ar, T & t);
+
+    template<typename T>
+    inline void invokeFieldsSerializer(
+        T **ppt,
+        Archive &ar,
+        RCF::FalseType *)
+    {
+        Serializer<T>(ppt).invoke(ar);
+    }
+
+    template<typename T>
+    inline void invokeFieldsSerializer(
+        T **ppt,
+        Archive &ar,
+        RCF::TrueType *)
+    {
+        // SF_FIELDS() values are written without Node framing. Pointers still need
+        // a Node for null and reference tracking.
+        if (    !ar.isFlagSet(Archive::POINTER)
+            &&  !ar.isFlagSet(Archive::PARENT)
+            &&  !ar.isFlagSet(Archive::POLYMORPHIC)
+            &&  !ar.isFlagSet(Archive::NODE_ALREADY_READ))
+        {
+            ar.clearState();
+            serializeFields(ar, **ppt);
+        }
+        else
+        {
+            Serializer<T>(ppt).invoke(ar);
+        }
+    }
+
     template<typename T>
     inline void invokeCustomSerializer(
-        T **ppt, 
-        Archive &ar, 
+        T **ppt,
+        Archive &ar,
         int)
     {
         static_assert(!RCF::IsPointer<T>::value, "Incorrect serialization code.");
-        Serializer<T>(ppt).invoke(ar);
+        typedef typename IsFieldsType<T>::type type;
+        invokeFieldsSerializer(ppt, ar, (type *) NULL);
     }
 
     template<typename U, typename T>
@@ -386,6 +449,12 @@ namespace SF {
         return SF::Registry::getSingleton().getTypeName( (T *) 0);
     }
 
+    template<typename T>
+    const std::type_info & Serializer<T>::getTypeInfo()
+    {
+        return typeid(T);
+    }
+
 #ifdef _MSC_VER
 #pragma warning( push )
 #pragma warning( disable: 4702 )
@@ -427,12 +496,20 @@ namespace SF {
     }
 
     template<typename T>
-    void Serializer<T>::getSerializerPolymorphic(
+    I_SerializerPolymorphic * Serializer<T>::getSerializerPolymorphic(
         const std::string &derivedTypeName)
     {
         pf = & SF::Registry::getSingleton().getSerializerPolymorphic( 
             (T *) 0, 
             derivedTypeName);
+
+        return pf;
+    }
+
+    template<typename T>
+    void Serializer<T>::setSerializerPolymorphic(I_SerializerPolymorphic * pSerializer)
+    {
+        pf = pSerializer;
     }
 
     template<typename T>
@@ -0,0 +1,59 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_SF_SIZECOUNTER_HPP
+#define INCLUDE_SF_SIZECOUNTER_HPP
+
+#include <RCF/MemStream.hpp>
+
+#include <SF/OBinaryStream.hpp>
+
+namespace SF {
+
+    /// Output stream that measures the size of SF binary serialized data, without storing it.
+
+    /// SizeCounter runs the same serialization functions as OBinaryStream, and getSize() returns the number of
+    /// bytes an OBinaryStream would have written.
+    class SizeCounter : public OBinaryStream
+    {
+    public:
+        SizeCounter() : OBinaryStream()
+        {
+            setOs(mOs);
+        }
+
+        /// Returns the number of bytes written so far.
+        std::size_t getSize() const
+        {
+            return mOs.getCount();
+        }
+
+        /// Resets the byte count and the archive state.
+        void reset()
+        {
+            mOs.resetCount();
+            clearState();
+        }
+
+    private:
+        RCF::CountingOstream mOs;
+    };
+
+}
+
+#endif // ! INCLUDE_SF_SIZECOUNTER_HPP
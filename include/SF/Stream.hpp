@@ -21,11 +21,14 @@
 
 #include <map>
 #include <string>
+#include <typeinfo>
+#include <vector>
 
 #include <RCF/Export.hpp>
 
 #include <SF/DataPtr.hpp>
 #include <SF/Encoding.hpp>
+#include <SF/FlatHashMap.hpp>
 #include <SF/I_Stream.hpp>
 
 #include <iosfwd>
@@ -41,6 +44,9 @@ namespace RCF {
 }
 namespace SF {
 
+    class I_SerializerPolymorphic;
+    class I_SerializerAny;
+
     //**************************************************
     // Encoding of object data
 
@@ -92,9 +98,9 @@ namespace SF {
         bool getEnabled() const;
 
     private:
-        bool mEnabled;
-        std::unique_ptr<std::map<UInt32, ObjectId> >                          mNidToIdMap;
-        std::unique_ptr<std::map<std::string, std::map< void *, void * > > >  mTypeToObjMap;
+        bool                                            mEnabled;
+        FlatHashMap<UInt32, ObjectId, UInt32Hash>       mNidToIdMap;
+        FlatHashMap<TypedPtr, void *, TypedPtrHash>     mTypeToObjMap;
     };
 
     class RCF_EXPORT ContextWrite
@@ -110,7 +116,58 @@ namespace SF {
     private:
         bool                                            mEnabled;
         UInt32                                          mCurrentId;
-        std::unique_ptr<std::map<ObjectId, UInt32> >      mIdToNidMap;
+        FlatHashMap<TypedPtr, UInt32, TypedPtrHash>     mIdToNidMap;
+    };
+
+    //**************************************************
+    // Polymorphic type name interning
+
+    // From runtime version 14, the first occurrence of a polymorphic type name in an 
+    // archive is written along with a small integer id, and subsequent occurrences 
+    // are written as the id only.
+
+    class RCF_EXPORT TypeNameContextRead
+    {
+    public:
+        TypeNameContextRead();
+        ~TypeNameContextRead();
+        void add(UInt32 typeId, const std::string & typeName);
+        bool contains(UInt32 typeId) const;
+        bool query(UInt32 typeId, std::string & typeName);
+        void addSerializer(UInt32 typeId, const std::type_info & baseType, I_SerializerPolymorphic * pSerializer);
+        I_SerializerPolymorphic * querySerializer(UInt32 typeId, const std::type_info & baseType);
+        void addAnySerializer(UInt32 typeId, I_SerializerAny * pSerializer);
+        I_SerializerAny * queryAnySerializer(UInt32 typeId);
+        void clear();
+
+    private:
+
+        // Serializers resolved for a type id, cached so the registry is only consulted once per archive.
+        struct Entry
+        {
+            std::string                                                             mTypeName;
+            std::vector< std::pair<const std::type_info *, I_SerializerPolymorphic *> > mSerializers;
+            I_SerializerAny *                                                       mpAnySerializer;
+        };
+
+        Entry * getEntry(UInt32 typeId);
+
+        std::vector<Entry>  mEntries;
+        std::size_t         mEntryCount;
+    };
+
+    class RCF_EXPORT TypeNameContextWrite
+    {
+    public:
+        TypeNameContextWrite();
+        ~TypeNameContextWrite();
+        UInt32 add(const std::type_info & type, bool & isNew);
+        void addAnySerializer(UInt32 typeId, I_SerializerAny * pSerializer);
+        I_SerializerAny * queryAnySerializer(UInt32 typeId);
+        void clear();
+
+    private:
+        std::vector< std::pair<const std::type_info *, I_SerializerAny *> > mTypes;
     };
 
     //**************************************************
@@ -203,6 +260,7 @@ namespace SF {
 
         ContextRead &           getTrackingContext();
         const ContextRead &     getTrackingContext() const;
+        TypeNameContextRead &   getTypeNameContext();
         LocalStorage &          getLocalStorage();
 
         void            setEnablePointerTracking(bool enable);
@@ -221,6 +279,7 @@ namespace SF {
     private:
 
         ContextRead         mContextRead;
+        TypeNameContextRead mTypeNameContextRead;
         LocalStorage        mLocalStorage;
 
         std::istream *      mpIs;
@@ -292,6 +351,7 @@ namespace SF {
 
         ContextWrite &          getTrackingContext();
         const ContextWrite &    getTrackingContext() const;
+        TypeNameContextWrite &  getTypeNameContext();
 
         LocalStorage &  getLocalStorage();
 
@@ -308,8 +368,9 @@ namespace SF {
 
         void            writeArchiveMetadata();
 
-        ContextWrite    mContextWrite;
-        LocalStorage    mLocalStorage;
+        ContextWrite            mContextWrite;
+        TypeNameContextWrite    mTypeNameContextWrite;
+        LocalStorage            mLocalStorage;
 
         std::ostream *  mpOs;
         int             mRuntimeVersion;
@@ -26,13 +26,116 @@
 #include <SF/string.hpp>
 #include <SF/Registry.hpp>
 #include <SF/SerializeAny.hpp>
+#include <SF/Stream.hpp>
 
 namespace SF {
 
     class Archive;
 
+    // From runtime version 14, the type name is interned per archive, and the resolved 
+    // serializer is cached against the type id.
+    inline void serializeInterned(SF::Archive &ar, boost::any &a)
+    {
+        if ( ar.isWrite() )
+        {
+            TypeNameContextWrite & ctx = ar.getOstream()->getTypeNameContext();
+
+            UInt32 typeId = 0;
+            bool isNew = false;
+            if ( !a.empty() )
+            {
+                typeId = ctx.add(a.type(), isNew);
+            }
+
+            ar & typeId;
+
+            if ( a.empty() )
+            {
+                return;
+            }
+
+            SF::I_SerializerAny * serializerAny = NULL;
+            if ( isNew )
+            {
+                std::string which =
+                    SF::Registry::getSingleton().getTypeName(a.type());
+
+                if ( which.empty() )
+                {
+                    RCF_THROW(RCF::Exception(RCF::RcfError_AnyTypeNotRegistered, a.type().name()));
+                }
+
+                ar & which;
+
+                serializerAny = SF::Registry::getSingleton().getAnySerializer(which);
+                ctx.addAnySerializer(typeId, serializerAny);
+            }
+            else
+            {
+                serializerAny = ctx.queryAnySerializer(typeId);
+            }
+
+            // The type may have been interned by a polymorphic pointer rather than by 
+            // a previous any, in which case there is no cached serializer yet.
+            if ( !serializerAny )
+            {
+                std::string which =
+                    SF::Registry::getSingleton().getTypeName(a.type());
+
+                serializerAny = SF::Registry::getSingleton().getAnySerializer(which);
+                ctx.addAnySerializer(typeId, serializerAny);
+            }
+
+            if ( serializerAny )
+            {
+                serializerAny->serialize(ar, a);
+            }
+        }
+        else
+        {
+            TypeNameContextRead & ctx = ar.getIstream()->getTypeNameContext();
+
+            UInt32 typeId = 0;
+            ar & typeId;
+
+            if ( typeId == 0 )
+            {
+                a = boost::any();
+                return;
+            }
+
+            SF::I_SerializerAny * serializerAny = NULL;
+            if ( ctx.contains(typeId) )
+            {
+                serializerAny = ctx.queryAnySerializer(typeId);
+            }
+            else
+            {
+                std::string which;
+                ar & which;
+                ctx.add(typeId, which);
+            }
+
+            if ( !serializerAny )
+            {
+                std::string which;
+                ctx.query(typeId, which);
+                serializerAny = SF::Registry::getSingleton().getAnySerializer(which);
+                ctx.addAnySerializer(typeId, serializerAny);
+            }
+
+            serializerAny->serialize(ar, a);
+        }
+    }
+
     inline void serialize(SF::Archive &ar, boost::any &a)
     {
+        if ( ar.getRuntimeVersion() >= 14 )
+        {
+            serializeInterned(ar, a);
+            return;
+        }
+
         if ( ar.isWrite() )
         {
             std::string which =
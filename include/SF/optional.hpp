@@ -0,0 +1,58 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_SF_OPTIONAL_STD_HPP
+#define INCLUDE_SF_OPTIONAL_STD_HPP
+
+#include <optional>
+
+#include <SF/Archive.hpp>
+
+namespace SF {
+
+    // std::optional - serialized as a bool flag, followed by the value if there is one.
+    template<typename T>
+    void serialize(SF::Archive &ar, std::optional<T> &t)
+    {
+        if (ar.isRead())
+        {
+            bool hasValue = false;
+            ar & hasValue;
+            if (hasValue)
+            {
+                ar & t.emplace();
+            }
+            else
+            {
+                t.reset();
+            }
+        }
+        else if (ar.isWrite())
+        {
+            bool hasValue = t.has_value();
+            ar & hasValue;
+            if (hasValue)
+            {
+                ar & *t;
+            }
+        }
+    }
+
+} // namespace SF
+
+#endif // ! INCLUDE_SF_OPTIONAL_STD_HPP
@@ -0,0 +1,47 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_SF_UNORDERED_MAP_STD_HPP
+#define INCLUDE_SF_UNORDERED_MAP_STD_HPP
+
+#include <unordered_map>
+
+#include <SF/SerializeStl.hpp>
+#include <SF/utility.hpp>
+
+namespace SF {
+
+    // std::unordered_map and std::unordered_multimap have the same wire format as std::map and std::multimap.
+
+    // std::unordered_map
+    template<typename K, typename T, typename H, typename P, typename A>
+    inline void serialize_vc6(Archive &ar, std::unordered_map<K,T,H,P,A> &t, const unsigned int)
+    {
+        serializeStlContainer<EmplaceSemantics, ReserveSemantics>(ar, t);
+    }
+
+    // std::unordered_multimap
+    template<typename K, typename T, typename H, typename P, typename A>
+    inline void serialize_vc6(Archive &ar, std::unordered_multimap<K,T,H,P,A> &t, const unsigned int)
+    {
+        serializeStlContainer<EmplaceSemantics, ReserveSemantics>(ar, t);
+    }
+
+} // namespace SF
+
+#endif // ! INCLUDE_SF_UNORDERED_MAP_STD_HPP
@@ -0,0 +1,46 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_SF_UNORDERED_SET_STD_HPP
+#define INCLUDE_SF_UNORDERED_SET_STD_HPP
+
+#include <unordered_set>
+
+#include <SF/SerializeStl.hpp>
+
+namespace SF {
+
+    // std::unordered_set and std::unordered_multiset have the same wire format as std::set and std::multiset.
+
+    // std::unordered_set
+    template<typename K, typename H, typename P, typename A>
+    inline void serialize_vc6(SF::Archive &ar, std::unordered_set<K,H,P,A> &t, const unsigned int)
+    {
+        serializeStlContainer<EmplaceSemantics, ReserveSemantics>(ar, t);
+    }
+
+    // std::unordered_multiset
+    template<typename K, typename H, typename P, typename A>
+    inline void serialize_vc6(SF::Archive &ar, std::unordered_multiset<K,H,P,A> &t, const unsigned int)
+    {
+        serializeStlContainer<EmplaceSemantics, ReserveSemantics>(ar, t);
+    }
+
+} // namespace SF
+
+#endif // ! INCLUDE_SF_UNORDERED_SET_STD_HPP
@@ -0,0 +1,82 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#ifndef INCLUDE_SF_VARIANT_STD_HPP
+#define INCLUDE_SF_VARIANT_STD_HPP
+
+#include <variant>
+
+#include <RCF/Exception.hpp>
+#include <RCF/Tools.hpp>
+
+#include <SF/Archive.hpp>
+
+namespace SF {
+
+    // Deserializes alternative I of a variant, if which selects it, and otherwise tries the next alternative.
+    template<std::size_t I, typename Variant>
+    void loadVariantAlternative(SF::Archive &ar, std::size_t which, Variant &v)
+    {
+        if constexpr (I < std::variant_size<Variant>::value)
+        {
+            if (which == I)
+            {
+                ar & v.template emplace<I>();
+            }
+            else
+            {
+                loadVariantAlternative<I+1>(ar, which, v);
+            }
+        }
+    }
+
+    // std::variant - serialized as the index of the alternative, followed by its value. This is the same wire 
+    // format as boost::variant.
+    template<typename... Ts>
+    void serialize(SF::Archive &ar, std::variant<Ts...> &v)
+    {
+        if (ar.isRead())
+        {
+            int which = 0;
+            ar & which;
+
+            if (which < 0 || which >= static_cast<int>(sizeof...(Ts)))
+            {
+                RCF::Exception e( 
+                    RCF::RcfError_VariantDeserialization, 
+                    which, 
+                    sizeof...(Ts));
+
+                RCF_THROW(e);
+            }
+
+            loadVariantAlternative<0>(ar, static_cast<std::size_t>(which), v);
+        }
+        else if (ar.isWrite())
+        {
+            RCF_ASSERT(!v.valueless_by_exception());
+
+            int which = static_cast<int>(v.index());
+            ar & which;
+            std::visit([&ar](auto &t) { ar & t; }, v);
+        }
+    }
+
+} // namespace SF
+
+#endif // ! INCLUDE_SF_VARIANT_STD_HPP
@@ -0,0 +1,207 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#include <RCF/ArrayView.hpp>
+
+#include <RCF/ByteOrdering.hpp>
+#include <RCF/Exception.hpp>
+#include <RCF/SerializationProtocol.hpp>
+#include <RCF/Tools.hpp>
+
+#include <SF/Archive.hpp>
+#include <SF/Stream.hpp>
+#include <SF/vector.hpp>
+
+namespace RCF {
+
+    ArrayViewBase::ArrayViewBase() : mpData(NULL), mCount(0), mBorrowed(false)
+    {
+    }
+
+    ArrayViewBase::ArrayViewBase(const void * pData, std::size_t count) :
+        mpData( static_cast<const char *>(pData) ),
+        mCount(count),
+        mBorrowed(false)
+    {
+    }
+
+    const ByteBuffer & ArrayViewBase::getByteBuffer() const
+    {
+        return mBuffer;
+    }
+
+    bool ArrayViewBase::isBorrowed() const
+    {
+        return mBorrowed;
+    }
+
+} // namespace RCF
+
+namespace SF {
+
+    // Presents a view as a vector, so views are written exactly as vectors are.
+    class ArrayViewWriteWrapper : public I_VecWrapper
+    {
+    public:
+        ArrayViewWriteWrapper(const char * pData, std::size_t count, std::size_t elementSize) :
+            mpData(pData),
+            mCount(count),
+            mElementSize(elementSize)
+        {
+        }
+
+        void resize(std::size_t)
+        {
+            RCF_ASSERT_ALWAYS("");
+        }
+
+        std::uint32_t size()
+        {
+            return static_cast<std::uint32_t>(mCount);
+        }
+
+        char * addressOfElement(std::size_t idx)
+        {
+            return const_cast<char *>(mpData) + idx*mElementSize;
+        }
+
+        std::uint32_t sizeofElement()
+        {
+            return static_cast<std::uint32_t>(mElementSize);
+        }
+
+    private:
+        const char *    mpData;
+        std::size_t     mCount;
+        std::size_t     mElementSize;
+    };
+
+    // Reads a view into a separately allocated buffer, when it can't point into the message buffer.
+    class ArrayViewReadWrapper : public I_VecWrapper
+    {
+    public:
+        ArrayViewReadWrapper(std::vector<char> & vec, std::size_t elementSize) :
+            mVec(vec),
+            mElementSize(elementSize)
+        {
+        }
+
+        void resize(std::size_t newSize)
+        {
+            mVec.resize(newSize*mElementSize);
+        }
+
+        std::uint32_t size()
+        {
+            return static_cast<std::uint32_t>(mVec.size() / mElementSize);
+        }
+
+        char * addressOfElement(std::size_t idx)
+        {
+            return &mVec[idx*mElementSize];
+        }
+
+        std::uint32_t sizeofElement()
+        {
+            return static_cast<std::uint32_t>(mElementSize);
+        }
+
+    private:
+        std::vector<char> &     mVec;
+        std::size_t             mElementSize;
+    };
+
+    void serializeArrayView(
+        SF::Archive &           ar,
+        RCF::ArrayViewBase &    view,
+        std::size_t             elementSize,
+        std::size_t             elementAlign)
+    {
+        if (ar.isRead())
+        {
+            view.mpData = NULL;
+            view.mCount = 0;
+            view.mBuffer.clear();
+            view.mBorrowed = false;
+
+            // See if we have a remote call context, and whether the elements can be used as is.
+            RCF::SerializationProtocolIn *pIn =
+                ar.getIstream()->getRemoteCallContext();
+
+            bool needsReordering =
+                    elementSize > 1
+                &&  ar.getRuntimeVersion() >= 8
+                &&  !RCF::machineOrderEqualsNetworkOrder();
+
+            if (pIn && !needsReordering)
+            {
+                std::uint32_t count = 0;
+                ar & count;
+
+                RCF_VERIFY(
+                    count <= pIn->getRemainingArchiveLength() / elementSize,
+                    RCF::Exception(RCF::RcfError_SfReadFailure));
+
+                std::size_t len = count*elementSize;
+                RCF::ByteBuffer slice;
+                pIn->extractSlice(slice, len);
+
+                if (len == 0)
+                {
+                    return;
+                }
+
+                std::size_t addr = reinterpret_cast<std::size_t>(slice.getPtr());
+                if (addr % elementAlign == 0)
+                {
+                    view.mBuffer = slice;
+                    view.mBorrowed = true;
+                }
+                else
+                {
+                    std::shared_ptr< std::vector<char> > spvc(
+                        new std::vector<char>(slice.getPtr(), slice.getPtr() + len) );
+
+                    view.mBuffer = RCF::ByteBuffer(spvc);
+                }
+
+                view.mpData = view.mBuffer.getPtr();
+                view.mCount = count;
+            }
+            else
+            {
+                std::shared_ptr< std::vector<char> > spvc( new std::vector<char>() );
+                ArrayViewReadWrapper vecWrapper(*spvc, elementSize);
+                serializeVectorFastImpl(ar, vecWrapper);
+
+                if (!spvc->empty())
+                {
+                    view.mBuffer = RCF::ByteBuffer(spvc);
+                    view.mpData = view.mBuffer.getPtr();
+                    view.mCount = spvc->size() / elementSize;
+                }
+            }
+        }
+        else if (ar.isWrite())
+        {
+            ArrayViewWriteWrapper vecWrapper(view.mpData, view.mCount, elementSize);
+            serializeVectorFastImpl(ar, vecWrapper);
+        }
+    }
+
+} // namespace SF
@@ -28,10 +28,13 @@
 #include <RCF/CurrentSession.hpp>
 #include <RCF/HttpFrameFilter.hpp>
 #include <RCF/HttpSessionFilter.hpp>
+#include <RCF/MessageFraming.hpp>
 #include <RCF/MethodInvocation.hpp>
 #include <RCF/ObjectPool.hpp>
 #include <RCF/RcfServer.hpp>
 #include <RCF/RcfSession.hpp>
+#include <RCF/ThreadLocalData.hpp>
+#include <RCF/ThreadPool.hpp>
 #include <RCF/TimedBsdSockets.hpp>
 #include <RCF/Log.hpp>
 
@@ -92,6 +95,81 @@ namespace RCF {
         AsioNetworkSession &mNetworkSession;
     };
 
+    // AsioIncrementalRead
+
+    // Tracks how much of a request has been received, while the request is being deserialized on another thread.
+    class AsioIncrementalRead : public MemIstreamSource
+    {
+    public:
+        AsioIncrementalRead(
+            AsioServerTransport &   transport, 
+            const char *            pchBegin, 
+            std::size_t             len) :
+                mTransport(transport),
+                mpBegin(pchBegin),
+                mpEnd(pchBegin + len),
+                mpAvailable(pchBegin),
+                mDone(false)
+        {
+        }
+
+        const char * waitForData(const char * pchRequired)
+        {
+            Lock lock(mMutex);
+            while (mpAvailable < pchRequired && !mDone)
+            {
+                mCondition.wait(lock);
+            }
+            return mpAvailable;
+        }
+
+        void waitForCompletion()
+        {
+            Lock lock(mMutex);
+            while (!mDone)
+            {
+                mCondition.wait(lock);
+            }
+        }
+
+        void onDataReceived(std::size_t bytesReceived)
+        {
+            Lock lock(mMutex);
+            if (mpBegin + bytesReceived > mpAvailable)
+            {
+                mpAvailable = mpBegin + bytesReceived;
+                mCondition.notify_all();
+            }
+        }
+
+        // If the read failed, waiting readers get whatever has been received, and then run out of data.
+        void onCompleted(bool succeeded)
+        {
+            Lock lock(mMutex);
+            if (!mDone)
+            {
+                if (succeeded)
+                {
+                    mpAvailable = mpEnd;
+                }
+                mDone = true;
+                --mTransport.mIncrementalReadCount;
+                mCondition.notify_all();
+            }
+        }
+
+    private:
+        AsioServerTransport &   mTransport;
+        const char *            mpBegin;
+        const char *            mpEnd;
+        const char *            mpAvailable;
+        bool                    mDone;
+        Mutex                   mMutex;
+        Condition               mCondition;
+    };
+
+    typedef std::shared_ptr<AsioIncrementalRead> AsioIncrementalReadPtr;
+
 
     ReadHandler::ReadHandler(AsioNetworkSessionPtr networkSessionPtr) : 
         mNetworkSessionPtr(networkSessionPtr)
@@ -163,6 +241,8 @@ namespace RCF {
 
     void AsioNetworkSession::postRead()
     {
+        endIncrementalRead();
+
         if (mLastError)
         {
             return;
@@ -176,6 +256,11 @@ namespace RCF {
         mNetworkReadByteBuffer.clear();
         mNetworkReadBufferPtr.reset();
 
+        mReadChunks.resize(0);
+        mReadChunksLen = 0;
+        mReadChunked = false;
+        mReadFinalFrame = false;
+
         mReadBufferRemaining = 0;
         mIssueZeroByteRead = true;
         beginRead();
@@ -184,22 +269,40 @@ namespace RCF {
     void AsioNetworkSession::postWrite(
         std::vector<ByteBuffer> &byteBuffers)
     {
+        endIncrementalRead();
+
         if (mLastError)
         {
+            // The connection failed while an incremental read was in progress.
+            byteBuffers.resize(0);
             return;
         }
 
         mSlicedWriteByteBuffers.resize(0);
         mWriteByteBuffers.resize(0);
 
-        std::copy(
-            byteBuffers.begin(),
-            byteBuffers.end(),
-            std::back_inserter(mWriteByteBuffers));
+        // Clients that send chunked requests get chunked responses.
+        std::size_t chunkSize = 0;
+        if (mReadChunked && !mTransport.mCustomFraming)
+        {
+            chunkSize = mTransport.getMessageChunkSize();
+        }
+
+        if (chunkSize)
+        {
+            encodeChunkedFrames(mWriteByteBuffers, byteBuffers, chunkSize);
+        }
+        else
+        {
+            std::copy(
+                byteBuffers.begin(),
+                byteBuffers.end(),
+                std::back_inserter(mWriteByteBuffers));
+        }
 
         byteBuffers.resize(0);
 
-        if (!mTransport.mCustomFraming)
+        if (!mTransport.mCustomFraming && !chunkSize)
         {
             // Add frame (4 byte length prefix).
             int messageSize = 
@@ -222,9 +325,15 @@ namespace RCF {
 
     void AsioNetworkSession::postClose()
     {
+        endIncrementalRead();
         close();
     }
 
+    MemIstreamSourcePtr AsioNetworkSession::getIncrementalReadSource()
+    {
+        return mIncrementalReadPtr;
+    }
+
     ServerTransport & AsioNetworkSession::getServerTransport()
     {
         return mTransport;
@@ -263,7 +372,10 @@ namespace RCF {
             mWriteBufferRemaining(),
             mTransport(transport),
             mFilterAdapterPtr(new FilterAdapter(*this)),
-            mCloseAfterWrite()
+            mCloseAfterWrite(),
+            mReadChunksLen(0),
+            mReadChunked(false),
+            mReadFinalFrame(false)
     {
         std::vector<FilterPtr> wireFilters;
 
@@ -337,6 +449,10 @@ namespace RCF {
 
     ByteBuffer AsioNetworkSession::getReadByteBuffer()
     {
+        if (mReadChunked)
+        {
+            return mReadChunks.empty() ? ByteBuffer() : mReadChunks.front();
+        }
         if (!mAppReadBufferPtr)
         {
             return ByteBuffer();            
@@ -344,6 +460,18 @@ namespace RCF {
         return ByteBuffer(mAppReadBufferPtr);
     }
 
+    void AsioNetworkSession::getReadChunks(std::vector<ByteBuffer> & chunks)
+    {
+        if (mReadChunked)
+        {
+            chunks = mReadChunks;
+        }
+        else
+        {
+            chunks.resize(0);
+        }
+    }
+
     void AsioNetworkSession::read(
         const ByteBuffer &byteBuffer,
         std::size_t bytesRequested)
@@ -445,6 +573,12 @@ namespace RCF {
                     mTransportFilters.back()->onReadCompleted(mNetworkReadByteBuffer);
             }
         }
+        else if (mIncrementalReadPtr)
+        {
+            // Release the thread that is deserializing the request.
+            AsioIncrementalReadPtr incrementalReadPtr = mIncrementalReadPtr;
+            incrementalReadPtr->onCompleted(false);
+        }
     }
 
     void AsioNetworkSession::onNetworkWriteCompleted(
@@ -646,7 +780,18 @@ namespace RCF {
     {
         RCF_ASSERT(bytesTransferred <= mReadBufferRemaining);
         mReadBufferRemaining -= bytesTransferred;
-        if (mReadBufferRemaining > 0)
+        if (mReadBufferRemaining > 0 && mIncrementalReadPtr)
+        {
+            // Once the next read is issued, it may complete on another thread.
+            AsioIncrementalReadPtr incrementalReadPtr = mIncrementalReadPtr;
+            incrementalReadPtr->onDataReceived(mAppReadBufferPtr->size() - mReadBufferRemaining);
+            beginRead();
+        }
+        else if (mReadBufferRemaining > 0 && mState == ReadingData && !mReadChunked && shouldReadIncrementally())
+        {
+            beginIncrementalRead();
+        }
+        else if (mReadBufferRemaining > 0)
         {
             beginRead();
         }
@@ -674,7 +819,11 @@ namespace RCF {
                 memcpy(&packetLength, &readBuffer[0], 4);
                 networkToMachineOrder(&packetLength, 4, 1);
 
-                if (    mTransport.getMaxIncomingMessageLength()
+                if (mReadChunked || (packetLength & ChunkedFrameFlag))
+                {
+                    beginReadChunk(packetLength);
+                }
+                else if (    mTransport.getMaxIncomingMessageLength()
                     &&  packetLength > mTransport.getMaxIncomingMessageLength())
                 {
                     sendServerError(RcfError_ServerMessageLength_Id);
@@ -687,6 +836,19 @@ namespace RCF {
                     beginRead();
                 }
             }
+            else if (mState == ReadingData && mReadChunked)
+            {
+                onReadChunkCompleted();
+            }
+            else if (mState == ReadingData && mIncrementalReadPtr)
+            {
+                // The request is already being processed. After this, the session may be 
+                // written to by the processing thread, so nothing more can be done here.
+                mState = Ready;
+
+                AsioIncrementalReadPtr incrementalReadPtr = mIncrementalReadPtr;
+                incrementalReadPtr->onCompleted(true);
+            }
             else if (mState == ReadingData)
             {
                 mState = Ready;
@@ -697,6 +859,131 @@ namespace RCF {
         }
     }
 
+    void AsioNetworkSession::beginReadChunk(std::uint32_t frameLength)
+    {
+        mReadChunked = true;
+        mReadFinalFrame = (frameLength & ChunkedFrameFlag) == 0;
+
+        std::size_t chunkLen = frameLength & MaxFrameLength;
+        std::size_t maxMessageLength = mTransport.getMaxIncomingMessageLength();
+
+        if (!isValidChunkedFrame(frameLength, mReadChunks))
+        {
+            sendServerError(RcfError_ChunkedFraming_Id);
+        }
+        else if (maxMessageLength && mReadChunksLen + chunkLen > maxMessageLength)
+        {
+            sendServerError(RcfError_ServerMessageLength_Id);
+        }
+        else if (chunkLen == 0 && mReadFinalFrame)
+        {
+            mState = Ready;
+
+            mTransport.getSessionManager().onReadCompleted(
+                getSessionPtr());
+        }
+        else if (chunkLen == 0)
+        {
+            mReadBufferRemaining = 4;
+            mState = ReadingDataCount;
+            beginRead();
+        }
+        else
+        {
+            // Read the chunk into the buffer that held the length prefix.
+            mAppReadBufferPtr->resize(chunkLen);
+            mReadBufferRemaining = chunkLen;
+            mState = ReadingData;
+            beginRead();
+        }
+    }
+
+    void AsioNetworkSession::onReadChunkCompleted()
+    {
+        mReadChunks.push_back( ByteBuffer(mAppReadBufferPtr) );
+        mReadChunksLen += mAppReadBufferPtr->size();
+
+        if (mReadFinalFrame)
+        {
+            mState = Ready;
+
+            mTransport.getSessionManager().onReadCompleted(
+                getSessionPtr());
+        }
+        else
+        {
+            // The chunk keeps its buffer, so read the next length prefix into a new one.
+            mAppReadBufferPtr = getObjectPool().getReallocBufferPtr();
+            mAppReadBufferPtr->resize(4);
+            mReadBufferRemaining = 4;
+            mState = ReadingDataCount;
+            beginRead();
+        }
+    }
+
+    bool AsioNetworkSession::shouldReadIncrementally()
+    {
+        std::size_t threshold = mTransport.getIncrementalReadThreshold();
+        if (    threshold == 0 
+            ||  mAppReadBufferPtr->size() < threshold
+            ||  !mTransportFilters.empty())
+        {
+            return false;
+        }
+
+        // The thread processing the request blocks while waiting for data, so another thread needs to be 
+        // available to complete the reads. Without that, the server would deadlock.
+        ThreadInfoPtr threadInfoPtr = getTlsThreadInfoPtr();
+        if (!threadInfoPtr)
+        {
+            return false;
+        }
+
+        std::size_t threadMaxCount = threadInfoPtr->getThreadPool().getThreadMaxCount();
+        if (++mTransport.mIncrementalReadCount >= threadMaxCount)
+        {
+            --mTransport.mIncrementalReadCount;
+            return false;
+        }
+
+        return true;
+    }
+
+    void AsioNetworkSession::beginIncrementalRead()
+    {
+        ReallocBuffer & readBuffer = *mAppReadBufferPtr;
+
+        mIncrementalReadPtr.reset( new AsioIncrementalRead(
+            mTransport, 
+            readBuffer.getPtr(),
+            readBuffer.size()) );
+
+        mIncrementalReadPtr->onDataReceived(readBuffer.size() - mReadBufferRemaining);
+
+        RCF_LOG_3()(this)(readBuffer.size()) << "AsioNetworkSession - processing request while it is being received.";
+
+        ThreadInfoPtr threadInfoPtr = getTlsThreadInfoPtr();
+        if (threadInfoPtr)
+        {
+            threadInfoPtr->notifyBusy();
+        }
+
+        // The rest of the request is read on other threads, while this thread processes the request.
+        beginRead();
+
+        mTransport.getSessionManager().onReadCompleted(
+            getSessionPtr());
+    }
+
+    void AsioNetworkSession::endIncrementalRead()
+    {
+        if (mIncrementalReadPtr)
+        {
+            mIncrementalReadPtr->waitForCompletion();
+            mIncrementalReadPtr.reset();
+        }
+    }
+
     void AsioNetworkSession::doCustomFraming(size_t bytesTransferred)
     {
         RCF_ASSERT(bytesTransferred <= mReadBufferRemaining);
@@ -1086,7 +1373,8 @@ namespace RCF {
         mAcceptorPtr(),
         mWireProtocol(Wp_None),
         mStopFlag(),
-        mpServer()
+        mpServer(),
+        mIncrementalReadCount(0)
     {
     }
 
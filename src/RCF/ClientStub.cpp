@@ -158,6 +158,10 @@ namespace RCF {
             mArchiveVersion                 = rhs.mArchiveVersion;
             mEnableSfPointerTracking        = rhs.mEnableSfPointerTracking;
             mEnableNativeWstringSerialization = rhs.mEnableNativeWstringSerialization;
+            mEnableSizingPass               = rhs.mEnableSizingPass;
+            mMessageChunkSize               = rhs.mMessageChunkSize;
+            mEnableBindingIds               = rhs.mEnableBindingIds;
+            mBindingId                      = 0;
             mPingBackIntervalMs             = rhs.mPingBackIntervalMs;
             mSignalled                      = false;
 
@@ -231,6 +235,7 @@ namespace RCF {
     void ClientStub::setServerBindingName(const std::string & bindingName)
     {
         mServerBindingName = bindingName;
+        mBindingId = 0;
     }
 
     RemoteCallMode ClientStub::getRemoteCallMode() const
@@ -264,6 +269,37 @@ namespace RCF {
         return mEnableSfPointerTracking;
     }
 
+    void ClientStub::setEnableSizingPass(bool enable)
+    {
+        mEnableSizingPass = enable;
+    }
+
+    bool ClientStub::getEnableSizingPass() const
+    {
+        return mEnableSizingPass;
+    }
+
+    void ClientStub::setMessageChunkSize(std::size_t chunkSize)
+    {
+        mMessageChunkSize = chunkSize;
+    }
+
+    std::size_t ClientStub::getMessageChunkSize() const
+    {
+        return mMessageChunkSize;
+    }
+
+    void ClientStub::setEnableBindingIds(bool enable)
+    {
+        mEnableBindingIds = enable;
+        mBindingId = 0;
+    }
+
+    bool ClientStub::getEnableBindingIds() const
+    {
+        return mEnableBindingIds;
+    }
+
     void ClientStub::setEndpoint(const Endpoint &endpoint)
     {
         mEndpoint = endpoint.clone();
@@ -283,11 +319,13 @@ namespace RCF {
     {
         mTransport.reset( transport.release() );
         mConnected = mTransport.get() && mTransport->isConnected();
+        mBindingId = 0;
     }
 
     std::unique_ptr<ClientTransport> ClientStub::releaseTransport()
     {
         instantiateTransport();
+        mBindingId = 0;
         return std::move(mTransport);
     }
 
@@ -755,6 +793,7 @@ namespace RCF {
     void ClientStub::setOutofBandRequest(ByteBuffer requestBuffer)
     {
         mRequest.mOutOfBandRequest = requestBuffer;
+        mRequest.invalidateHeaderCache();
     }
 
     ByteBuffer ClientStub::getOutOfBandResponse()
@@ -1051,6 +1090,7 @@ namespace RCF {
     void ClientStub::setRequestUserData(const std::string & userData)
     {
         mRequest.mRequestUserData = ByteBuffer(userData);
+        mRequest.invalidateHeaderCache();
     }
 
     std::string ClientStub::getRequestUserData()
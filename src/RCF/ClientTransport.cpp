@@ -163,4 +163,9 @@ namespace RCF {
         RCF_UNUSED_VARIABLE(info);
     }
 
+    void ClientTransport::getReadChunks(std::vector<ByteBuffer> & chunks)
+    {
+        chunks.resize(0);
+    }
+
 } // namespace RCF
@@ -25,6 +25,7 @@
 #include <RCF/RcfSession.hpp>
 #include <RCF/ThreadLocalData.hpp>
 #include <RCF/Log.hpp>
+#include <RCF/MessageFraming.hpp>
 
 #include <chrono>
 
@@ -135,6 +136,9 @@ namespace RCF {
         mBytesToRead(),
         mBytesRequested(),
         mReadBuffer2(),
+        mReadChunksLen(0),
+        mReadChunked(false),
+        mReadFinalFrame(false),
         
         mOverlappedPtr( new OverlappedAmi(this) )
     {
@@ -160,6 +164,9 @@ namespace RCF {
             mBytesToRead(),
             mBytesRequested(),
             mReadBuffer2(),
+            mReadChunksLen(0),
+            mReadChunked(false),
+            mReadFinalFrame(false),
             
             mOverlappedPtr( new OverlappedAmi(this) )
             
@@ -415,6 +422,10 @@ namespace RCF {
 
         mPreState = Reading;
         mReadBufferPos = 0;
+        mReadChunks.resize(0);
+        mReadChunksLen = 0;
+        mReadChunked = false;
+        mReadFinalFrame = false;
         
         mpClientStub = &clientStub;
 
@@ -573,6 +584,12 @@ namespace RCF {
                 std::uint32_t length = *(std::uint32_t*)mReadBuffer.getPtr();
                 networkToMachineOrder(&length, sizeof(length), 1);
 
+                if (mReadChunked || (length & ChunkedFrameFlag))
+                {
+                    beginReadChunk(length);
+                    break;
+                }
+
                 if ( getMaxIncomingMessageLength())
                 {
                     RCF_VERIFY(
@@ -594,6 +611,23 @@ namespace RCF {
                     mReadBuffer.getLength() - mReadBufferPos);
 
             }
+            else if (mReadBufferPos == mReadBuffer.getLength() && mReadChunked)
+            {
+                mReadChunks.push_back( ByteBuffer(mReadBuffer, 4) );
+                mReadChunksLen += mReadBuffer.getLength() - 4;
+                mReadBuffer.clear();
+
+                if (mReadFinalFrame)
+                {
+                    onReadChunksCompleted();
+                }
+                else
+                {
+                    // Read the next frame into a new buffer, as the chunk holds on to this one.
+                    mReadBufferPos = 0;
+                    transition();
+                }
+            }
             else if (mReadBufferPos == mReadBuffer.getLength())
             {
                 fireProgressEvent();
@@ -642,6 +676,67 @@ namespace RCF {
         }
     }
 
+    void ConnectedClientTransport::beginReadChunk(std::uint32_t frameLength)
+    {
+        mReadChunked = true;
+        mReadFinalFrame = !(frameLength & ChunkedFrameFlag);
+
+        std::size_t chunkLength = frameLength & MaxFrameLength;
+
+        RCF_VERIFY(
+            isValidChunkedFrame(frameLength, mReadChunks),
+            Exception(RcfError_ChunkedFraming));
+
+        if ( getMaxIncomingMessageLength() )
+        {
+            RCF_VERIFY(
+                mReadChunksLen + chunkLength <= getMaxIncomingMessageLength(),
+                Exception(RcfError_ClientMessageLength));
+        }
+
+        if (chunkLength == 0 && mReadFinalFrame)
+        {
+            onReadChunksCompleted();
+        }
+        else if (chunkLength == 0)
+        {
+            mReadBuffer.clear();
+            mReadBufferPos = 0;
+            transition();
+        }
+        else
+        {
+            mReadBufferPtr->resize(4+chunkLength);
+            mReadBuffer = ByteBuffer(mReadBufferPtr);
+
+            issueRead(
+                ByteBuffer(mReadBuffer, mReadBufferPos), 
+                mReadBuffer.getLength() - mReadBufferPos);
+        }
+    }
+
+    void ConnectedClientTransport::onReadChunksCompleted()
+    {
+        fireProgressEvent();
+
+        RCF_VERIFY(mReadChunksLen > 0, Exception(RcfError_ClientMessageLength));
+
+        *mpClientStubReadBuffer = mReadChunks.front();
+        mReadBuffer.clear();
+        mRecursionState.clear();
+        mpClientStub->onReceiveCompleted();
+    }
+
+    void ConnectedClientTransport::getReadChunks(std::vector<ByteBuffer> & chunks)
+    {
+        chunks.resize(0);
+        if (mReadChunked)
+        {
+            chunks.swap(mReadChunks);
+            mReadChunked = false;
+        }
+    }
+
     void ConnectedClientTransport::getProgressInfo(RemoteCallProgressInfo & info)
     {
         if ( mPreState == Connecting )
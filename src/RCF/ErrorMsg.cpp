@@ -238,6 +238,9 @@ namespace RCF
         case 192   /*RcfError_HttpMessageVerificationAdmin   */: return "HTTP message verification failed. %1%"; 
         case 193   /*RcfError_HttpSessionNotAvailable        */: return "HTTP session not available."; 
         case 194   /*RcfError_HttpInvalidMessage             */: return "Invalid HTTP message."; 
+        case 195   /*RcfError_FileHashMismatch               */: return "File integrity check failed. The downloaded file does not match the file on the server. File: %1%."; 
+        case 196   /*RcfError_FileDelta                      */: return "Invalid file delta. %1%"; 
+        case 197   /*RcfError_ChunkedFraming                 */: return "Invalid chunked message framing."; 
 
         //[[[end]]]
 
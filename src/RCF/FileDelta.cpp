@@ -0,0 +1,555 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF 
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com 
+//
+//******************************************************************************
+
+#include <RCF/FileDelta.hpp>
+
+#include <cmath>
+#include <cstring>
+
+#include <RCF/Exception.hpp>
+#include <RCF/Log.hpp>
+
+#include <SF/Archive.hpp>
+#include <SF/string.hpp>
+
+namespace RCF {
+
+    // Sha256
+
+    static const std::uint32_t Sha256RoundConstants[64] = 
+    {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    static inline std::uint32_t rotateRight(std::uint32_t x, int n)
+    {
+        return (x >> n) | (x << (32 - n));
+    }
+
+    Sha256::Sha256() : mLength(0), mBlockLen(0)
+    {
+        mState[0] = 0x6a09e667;
+        mState[1] = 0xbb67ae85;
+        mState[2] = 0x3c6ef372;
+        mState[3] = 0xa54ff53a;
+        mState[4] = 0x510e527f;
+        mState[5] = 0x9b05688c;
+        mState[6] = 0x1f83d9ab;
+        mState[7] = 0x5be0cd19;
+    }
+
+    void Sha256::update(const void * pData, std::size_t len)
+    {
+        const unsigned char * pch = static_cast<const unsigned char *>(pData);
+        mLength += len;
+
+        while (len > 0)
+        {
+            if (mBlockLen == 0 && len >= 64)
+            {
+                transform(pch);
+                pch += 64;
+                len -= 64;
+                continue;
+            }
+
+            std::size_t bytesToCopy = RCF_MIN(len, 64 - mBlockLen);
+            memcpy(mBlock + mBlockLen, pch, bytesToCopy);
+            mBlockLen += bytesToCopy;
+            pch += bytesToCopy;
+            len -= bytesToCopy;
+
+            if (mBlockLen == 64)
+            {
+                transform(mBlock);
+                mBlockLen = 0;
+            }
+        }
+    }
+
+    std::string Sha256::final()
+    {
+        std::uint64_t bitLength = mLength * 8;
+
+        mBlock[mBlockLen++] = 0x80;
+        if (mBlockLen > 56)
+        {
+            memset(mBlock + mBlockLen, 0, 64 - mBlockLen);
+            transform(mBlock);
+            mBlockLen = 0;
+        }
+        memset(mBlock + mBlockLen, 0, 56 - mBlockLen);
+        for (int i = 0; i < 8; ++i)
+        {
+            mBlock[63 - i] = static_cast<unsigned char>(bitLength >> (8 * i));
+        }
+        transform(mBlock);
+        mBlockLen = 0;
+
+        std::string digest(32, '\0');
+        for (int i = 0; i < 8; ++i)
+        {
+            digest[4*i + 0] = static_cast<char>(mState[i] >> 24);
+            digest[4*i + 1] = static_cast<char>(mState[i] >> 16);
+            digest[4*i + 2] = static_cast<char>(mState[i] >> 8);
+            digest[4*i + 3] = static_cast<char>(mState[i]);
+        }
+        return digest;
+    }
+
+    void Sha256::transform(const unsigned char * pBlock)
+    {
+        std::uint32_t w[64];
+        for (int i = 0; i < 16; ++i)
+        {
+            w[i] = 
+                    (std::uint32_t(pBlock[4*i + 0]) << 24) 
+                |   (std::uint32_t(pBlock[4*i + 1]) << 16) 
+                |   (std::uint32_t(pBlock[4*i + 2]) << 8) 
+                |   (std::uint32_t(pBlock[4*i + 3]));
+        }
+        for (int i = 16; i < 64; ++i)
+        {
+            std::uint32_t s0 = rotateRight(w[i-15], 7) ^ rotateRight(w[i-15], 18) ^ (w[i-15] >> 3);
+            std::uint32_t s1 = rotateRight(w[i-2], 17) ^ rotateRight(w[i-2], 19) ^ (w[i-2] >> 10);
+            w[i] = w[i-16] + s0 + w[i-7] + s1;
+        }
+
+        std::uint32_t a = mState[0];
+        std::uint32_t b = mState[1];
+        std::uint32_t c = mState[2];
+        std::uint32_t d = mState[3];
+        std::uint32_t e = mState[4];
+        std::uint32_t f = mState[5];
+        std::uint32_t g = mState[6];
+        std::uint32_t h = mState[7];
+
+        for (int i = 0; i < 64; ++i)
+        {
+            std::uint32_t s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+            std::uint32_t ch = (e & f) ^ (~e & g);
+            std::uint32_t t1 = h + s1 + ch + Sha256RoundConstants[i] + w[i];
+            std::uint32_t s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+            std::uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            std::uint32_t t2 = s0 + maj;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        mState[0] += a;
+        mState[1] += b;
+        mState[2] += c;
+        mState[3] += d;
+        mState[4] += e;
+        mState[5] += f;
+        mState[6] += g;
+        mState[7] += h;
+    }
+
+    static std::string strongHash(const char * pData, std::size_t len)
+    {
+        Sha256 sha;
+        sha.update(pData, len);
+        std::string hash = sha.final();
+        hash.resize(FileSignature::StrongHashLength);
+        return hash;
+    }
+
+    // FileSignature
+
+    // Bounds the memory a signature can make the server allocate.
+    static const std::uint32_t MaxDeltaBlockSize = 64*1024*1024;
+
+    FileSignature::FileSignature() : mBlockSize(0), mFileSize(0)
+    {
+    }
+
+    std::size_t FileSignature::getBlockCount() const
+    {
+        if (mBlockSize == 0)
+        {
+            return 0;
+        }
+        return static_cast<std::size_t>( (mFileSize + mBlockSize - 1) / mBlockSize );
+    }
+
+    std::uint32_t FileSignature::getBlockLength(std::size_t blockIndex) const
+    {
+        std::uint64_t blockPos = std::uint64_t(blockIndex) * mBlockSize;
+        return static_cast<std::uint32_t>( RCF_MIN(std::uint64_t(mBlockSize), mFileSize - blockPos) );
+    }
+
+    FileDeltaOp::FileDeltaOp() : mBasisOffset(0), mLength(0)
+    {
+    }
+
+    bool FileDeltaOp::isCopy() const
+    {
+        return mData.isEmpty();
+    }
+
+#if RCF_FEATURE_SF==1
+
+    void FileSignature::serialize(SF::Archive & ar)
+    {
+        ar & mBlockSize & mFileSize & mWeakHashes & mStrongHashes;
+    }
+
+    void FileDeltaOp::serialize(SF::Archive & ar)
+    {
+        ar & mBasisOffset & mLength & mData;
+    }
+
+#endif
+
+    std::uint32_t chooseDeltaBlockSize(
+        std::uint64_t           fileSize, 
+        std::uint64_t           maxSignatureBytes)
+    {
+        const std::uint64_t BytesPerBlock = sizeof(std::uint32_t) + FileSignature::StrongHashLength;
+        const std::uint64_t MinBlockSize = 2*1024;
+
+        std::uint64_t blockSize = static_cast<std::uint64_t>( std::sqrt( static_cast<double>(fileSize) ) );
+        blockSize = RCF_MAX(blockSize, MinBlockSize);
+
+        std::uint64_t maxBlocks = RCF_MAX(maxSignatureBytes / BytesPerBlock, std::uint64_t(1));
+        blockSize = RCF_MAX(blockSize, (fileSize + maxBlocks - 1) / maxBlocks);
+
+        blockSize = (blockSize + 1023) / 1024 * 1024;
+        blockSize = RCF_MIN(blockSize, std::uint64_t(MaxDeltaBlockSize));
+        return static_cast<std::uint32_t>(blockSize);
+    }
+
+    void computeFileSignature(
+        const Path &            filePath, 
+        std::uint32_t           blockSize, 
+        FileSignature &         signature)
+    {
+        RCF_ASSERT(blockSize > 0);
+
+        FileHandle fin(filePath, FileHandle::Read);
+
+        signature.mBlockSize = blockSize;
+        signature.mFileSize = 0;
+        signature.mWeakHashes.clear();
+        signature.mStrongHashes.clear();
+
+        std::vector<char> block(blockSize);
+        while (true)
+        {
+            std::size_t bytesRead = fin.read( ByteBuffer(&block[0], block.size()) );
+            if (bytesRead == 0)
+            {
+                break;
+            }
+
+            RollingChecksum checksum;
+            checksum.reset(&block[0], bytesRead);
+            signature.mWeakHashes.push_back(checksum.value());
+            signature.mStrongHashes += strongHash(&block[0], bytesRead);
+            signature.mFileSize += bytesRead;
+
+            if (bytesRead < block.size())
+            {
+                break;
+            }
+        }
+
+        RCF_LOG_3()(filePath.u8string())(blockSize)(signature.mFileSize)(signature.mWeakHashes.size()) 
+            << "computeFileSignature() - computed file signature.";
+    }
+
+    // FileDeltaEncoder
+
+    static const std::uint32_t NoBlock = std::uint32_t(-1);
+
+    FileDeltaEncoder::FileDeltaEncoder(
+        const Path &            filePath, 
+        std::uint64_t           fileSize, 
+        const FileSignature &   signature) :
+            mSignature(signature),
+            mTags(0x10000, 0),
+            mFileSize(fileSize),
+            mDone(false),
+            mBufPos(0),
+            mReadPos(0),
+            mLitStart(0),
+            mWinPos(0),
+            mChecksumValid(false),
+            mLastCopyBlock(NoBlock)
+    {
+        std::size_t blockCount = mSignature.getBlockCount();
+
+        RCF_VERIFY(
+            mSignature.mBlockSize > 0 && mSignature.mBlockSize <= MaxDeltaBlockSize, 
+            Exception(RcfError_FileDelta, "Invalid block size."));
+
+        RCF_VERIFY(
+                mSignature.mWeakHashes.size() == blockCount 
+            &&  mSignature.mStrongHashes.size() == blockCount * FileSignature::StrongHashLength,
+            Exception(RcfError_FileDelta, "Block count does not match file size."));
+
+        // Chain blocks with the same weak hash together, in ascending order.
+        mNextBlock.resize(blockCount, NoBlock);
+        for (std::size_t i = blockCount; i > 0; --i)
+        {
+            std::uint32_t blockIndex = static_cast<std::uint32_t>(i - 1);
+            std::uint32_t weakHash = mSignature.mWeakHashes[blockIndex];
+            auto iter = mFirstBlock.find(weakHash);
+            if (iter != mFirstBlock.end())
+            {
+                mNextBlock[blockIndex] = iter->second;
+            }
+            mFirstBlock[weakHash] = blockIndex;
+            mTags[getTag(weakHash)] = 1;
+        }
+
+        mFile.open(filePath, FileHandle::Read);
+
+        RCF_LOG_3()(filePath.u8string())(fileSize)(mSignature.mBlockSize)(blockCount) 
+            << "FileDeltaEncoder - created encoder.";
+    }
+
+    std::size_t FileDeltaEncoder::getTag(std::uint32_t weakHash)
+    {
+        return (weakHash ^ (weakHash >> 16)) & 0xFFFF;
+    }
+
+    std::uint64_t FileDeltaEncoder::getPos() const
+    {
+        return mLitStart;
+    }
+
+    const std::string & FileDeltaEncoder::getFileHash() const
+    {
+        return mFileHash;
+    }
+
+    bool FileDeltaEncoder::encode(std::vector<FileDeltaOp> & ops, std::uint32_t maxLiteralBytes)
+    {
+        // Bounds the time spent in each call, when most of the file matches.
+        const std::uint64_t     MaxScanBytes = 32*1024*1024;
+        const std::size_t       MaxOps = 4096;
+
+        if (mDone)
+        {
+            return true;
+        }
+
+        const std::size_t blockSize = mSignature.mBlockSize;
+        std::uint64_t literalBudget = maxLiteralBytes;
+        std::uint64_t scanEnd = mWinPos + MaxScanBytes;
+
+        while (true)
+        {
+            if (    mWinPos - mLitStart >= literalBudget 
+                ||  mWinPos >= scanEnd 
+                ||  ops.size() >= MaxOps)
+            {
+                flushLiteral(ops);
+                return false;
+            }
+
+            std::size_t bytesAvailable = fill(blockSize + 1);
+            if (bytesAvailable == 0)
+            {
+                flushLiteral(ops);
+                mFile.close();
+                mFileHash = mHash.final();
+                mDone = true;
+
+                RCF_LOG_3()(mFile.getFilePath().u8string())(mLitStart) << "FileDeltaEncoder - encoding completed.";
+                return true;
+            }
+
+            const char * pWin = &mBuf[static_cast<std::size_t>(mWinPos - mBufPos)];
+            std::uint32_t blockIndex = NoBlock;
+
+            if (bytesAvailable >= blockSize)
+            {
+                if (!mChecksumValid)
+                {
+                    mChecksum.reset(pWin, blockSize);
+                    mChecksumValid = true;
+                }
+
+                if (findBlock(pWin, blockSize, mChecksum.value(), blockIndex))
+                {
+                    literalBudget -= flushLiteral(ops);
+                    addCopy(ops, blockIndex, blockSize);
+                    continue;
+                }
+
+                if (bytesAvailable > blockSize)
+                {
+                    mChecksum.roll(pWin[0], pWin[blockSize], blockSize);
+                    ++mWinPos;
+                    continue;
+                }
+            }
+            else if (   mSignature.getBlockCount() > 0 
+                    &&  bytesAvailable == mSignature.getBlockLength(mSignature.getBlockCount() - 1))
+            {
+                // The last block of the existing copy may be shorter than the others.
+                RollingChecksum checksum;
+                checksum.reset(pWin, bytesAvailable);
+                if (findBlock(pWin, bytesAvailable, checksum.value(), blockIndex))
+                {
+                    literalBudget -= flushLiteral(ops);
+                    addCopy(ops, blockIndex, bytesAvailable);
+                    continue;
+                }
+            }
+
+            mChecksumValid = false;
+            ++mWinPos;
+        }
+    }
+
+    std::size_t FileDeltaEncoder::fill(std::size_t bytesNeeded)
+    {
+        const std::size_t ReadSize = 1024*1024;
+
+        std::size_t winOffset = static_cast<std::size_t>(mWinPos - mBufPos);
+        while (mBuf.size() - winOffset < bytesNeeded && mReadPos < mFileSize)
+        {
+            // Discard data that has been encoded.
+            std::size_t bytesEncoded = static_cast<std::size_t>(mLitStart - mBufPos);
+            if (bytesEncoded > 0 && bytesEncoded >= mBuf.size() / 2)
+            {
+                mBuf.erase(mBuf.begin(), mBuf.begin() + bytesEncoded);
+                mBufPos += bytesEncoded;
+                winOffset -= bytesEncoded;
+            }
+
+            std::size_t bytesToRead = static_cast<std::size_t>( 
+                RCF_MIN(std::uint64_t(RCF_MAX(ReadSize, bytesNeeded)), mFileSize - mReadPos) );
+
+            std::size_t oldSize = mBuf.size();
+            mBuf.resize(oldSize + bytesToRead);
+            std::size_t bytesRead = mFile.read( ByteBuffer(&mBuf[oldSize], bytesToRead) );
+            mBuf.resize(oldSize + bytesRead);
+
+            if (bytesRead == 0)
+            {
+                // The file could not be read, or has been truncated since the download began.
+                RCF_THROW(mFile.err());
+            }
+
+            mHash.update(&mBuf[oldSize], bytesRead);
+            mReadPos += bytesRead;
+        }
+
+        return mBuf.size() - winOffset;
+    }
+
+    bool FileDeltaEncoder::findBlock(
+        const char *            pData, 
+        std::size_t             len, 
+        std::uint32_t           weakHash, 
+        std::uint32_t &         blockIndex)
+    {
+        if (!mTags[getTag(weakHash)])
+        {
+            return false;
+        }
+
+        auto iter = mFirstBlock.find(weakHash);
+        if (iter == mFirstBlock.end())
+        {
+            return false;
+        }
+
+        std::string hash = strongHash(pData, len);
+
+        blockIndex = NoBlock;
+        for (std::uint32_t i = iter->second; i != NoBlock; i = mNextBlock[i])
+        {
+            if (    mSignature.getBlockLength(i) == len 
+                &&  memcmp(&mSignature.mStrongHashes[i * FileSignature::StrongHashLength], hash.c_str(), hash.size()) == 0)
+            {
+                // Prefer the block following the last one copied, so the copies can be merged.
+                if (blockIndex == NoBlock || (mLastCopyBlock != NoBlock && i == mLastCopyBlock + 1))
+                {
+                    blockIndex = i;
+                }
+            }
+        }
+
+        return blockIndex != NoBlock;
+    }
+
+    std::uint64_t FileDeltaEncoder::flushLiteral(std::vector<FileDeltaOp> & ops)
+    {
+        std::uint64_t len = mWinPos - mLitStart;
+        if (len > 0)
+        {
+            const char * pLit = &mBuf[static_cast<std::size_t>(mLitStart - mBufPos)];
+
+            FileDeltaOp op;
+            op.mLength = len;
+            op.mData = ByteBuffer( static_cast<std::size_t>(len) );
+            memcpy(op.mData.getPtr(), pLit, static_cast<std::size_t>(len));
+            ops.push_back(op);
+
+            mLitStart = mWinPos;
+            mLastCopyBlock = NoBlock;
+        }
+        return len;
+    }
+
+    void FileDeltaEncoder::addCopy(std::vector<FileDeltaOp> & ops, std::uint32_t blockIndex, std::size_t len)
+    {
+        std::uint64_t basisOffset = std::uint64_t(blockIndex) * mSignature.mBlockSize;
+
+        if (    !ops.empty() 
+            &&  ops.back().isCopy() 
+            &&  mLastCopyBlock != NoBlock 
+            &&  blockIndex == mLastCopyBlock + 1)
+        {
+            ops.back().mLength += len;
+        }
+        else
+        {
+            FileDeltaOp op;
+            op.mBasisOffset = basisOffset;
+            op.mLength = len;
+            ops.push_back(op);
+        }
+
+        mLastCopyBlock = blockIndex;
+        mWinPos += len;
+        mLitStart = mWinPos;
+        mChecksumValid = false;
+    }
+
+} // namespace RCF
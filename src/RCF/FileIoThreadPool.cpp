@@ -62,6 +62,11 @@ namespace RCF {
         mThreadPool.stop();
     }
 
+    void FileIoThreadPool::setThreadMaxCount(std::size_t threadMaxCount)
+    {
+        mThreadPool.setThreadMaxCount(threadMaxCount);
+    }
+
     void FileIoThreadPool::registerOp(FileIoRequestPtr opPtr)
     {
         RCF::Lock lock(mOpsMutex);
@@ -72,49 +77,64 @@ namespace RCF {
             mThreadPool.start();
         }
 
-        if (    std::find(mOpsQueued.begin(), mOpsQueued.end(), opPtr) 
-            !=  mOpsQueued.end())
-        {
-            RCF_ASSERT_ALWAYS("");
-        }
-        else if (       std::find(mOpsInProgress.begin(), mOpsInProgress.end(), opPtr) 
-                    !=  mOpsInProgress.end())
-        {
-            RCF_ASSERT_ALWAYS("");
-        }
-        else
+        FileHandle * pFile = opPtr->getFileHandle();
+        OpQueue & fileOps = mFileOps[pFile];
+        fileOps.push_back(opPtr);
+
+        if (fileOps.size() == 1 && mFilesInProgress.find(pFile) == mFilesInProgress.end())
         {
-            mOpsQueued.push_back(opPtr);
-            mOpsCondition.notify_all();
+            mFilesReady.push_back(pFile);
+            mOpsCondition.notify_one();
         }
     }
 
     void FileIoThreadPool::unregisterOp(FileIoRequestPtr opPtr)
     {
         RCF::Lock lock(mOpsMutex);
-        RCF::eraseRemove(mOpsQueued, opPtr);
-        RCF::eraseRemove(mOpsInProgress, opPtr);
+
+        FileHandle * pFile = opPtr->getFileHandle();
+        auto iter = mFileOps.find(pFile);
+        if (iter != mFileOps.end())
+        {
+            RCF::eraseRemove(iter->second, opPtr);
+            if (iter->second.empty())
+            {
+                mFileOps.erase(iter);
+                RCF::eraseRemove(mFilesReady, pFile);
+            }
+        }
     }
 
     bool FileIoThreadPool::ioTask()
     {
         FileIoRequestPtr opPtr;
+        FileHandle * pFile = NULL;
 
         {
             RCF::Lock lock(mOpsMutex);
-            while (mOpsQueued.empty() && !mThreadPool.shouldStop())
+            while (mFilesReady.empty() && !mThreadPool.shouldStop())
             {
                 using namespace std::chrono_literals;
                 mOpsCondition.wait_for(lock, 1000ms);
             }
-            if (mOpsQueued.empty() || mThreadPool.shouldStop())
+            if (mFilesReady.empty() || mThreadPool.shouldStop())
             {
                 return false;
             }
-            RCF_ASSERT(mOpsQueued.size() > 0);
-            mOpsInProgress.push_back( mOpsQueued.front() );
-            mOpsQueued.pop_front();
-            opPtr = mOpsInProgress.back();
+
+            pFile = mFilesReady.front();
+            mFilesReady.pop_front();
+
+            auto iter = mFileOps.find(pFile);
+            RCF_ASSERT(iter != mFileOps.end() && !iter->second.empty());
+            opPtr = iter->second.front();
+            iter->second.pop_front();
+            if (iter->second.empty())
+            {
+                mFileOps.erase(iter);
+            }
+
+            mFilesInProgress.insert(pFile);
         }
 
         RCF::ThreadInfoPtr threadInfoPtr = RCF::getTlsThreadInfoPtr();
@@ -126,14 +146,22 @@ namespace RCF {
         // This is the part that blocks.
         opPtr->doTransfer();
 
-        // Unregister op.
-        unregisterOp(opPtr);
+        // Let the next request on the file run.
+        {
+            RCF::Lock lock(mOpsMutex);
+            mFilesInProgress.erase(pFile);
+            if (mFileOps.find(pFile) != mFileOps.end())
+            {
+                mFilesReady.push_back(pFile);
+                mOpsCondition.notify_one();
+            }
+        }
 
         // Notify completion.
         {
-            RCF::Lock lock(mCompletionMutex);
+            RCF::Lock lock(opPtr->mCompletionMutex);
             opPtr->mCompleted = true;
-            mCompletionCondition.notify_all();
+            opPtr->mCompletionCondition.notify_all();
         }
 
         return false;
@@ -163,7 +191,7 @@ namespace RCF {
     {
         RCF_LOG_4() << "FileIoRequest::isInitiated()";
 
-        RCF::Lock lock(mFts.mCompletionMutex);
+        RCF::Lock lock(mCompletionMutex);
         return mInitiated;
     }
 
@@ -171,7 +199,7 @@ namespace RCF {
     {
         RCF_LOG_4() << "FileIoRequest::isCompleted()";
 
-        RCF::Lock lock(mFts.mCompletionMutex);
+        RCF::Lock lock(mCompletionMutex);
         return mCompleted;
     }
 
@@ -179,11 +207,11 @@ namespace RCF {
     {
         RCF_LOG_4() << "FileIoRequest::complete() - entry";
 
-        RCF::Lock lock(mFts.mCompletionMutex);
+        RCF::Lock lock(mCompletionMutex);
         while (!mCompleted)
         {
             using namespace std::chrono_literals;
-            mFts.mCompletionCondition.wait_for(lock, 1000ms);
+            mCompletionCondition.wait_for(lock, 1000ms);
         }
         mInitiated = false;
 
@@ -194,50 +222,77 @@ namespace RCF {
     {
         RCF_LOG_4()(finPtr.get())((void*)buffer.getPtr())(buffer.getLength()) << "FileIoRequest::read()";
 
-        mFinPtr = finPtr;
-        mFoutPtr.reset();
-        mBuffer = buffer;
-        mBytesTransferred = 0;
-        mInitiated = true;
-        mCompleted = false;
+        {
+            RCF::Lock lock(mCompletionMutex);
+            RCF_ASSERT(mCompleted);
+
+            mFinPtr = finPtr;
+            mFoutPtr.reset();
+            mBuffer = buffer;
+            mCompressedChunkPtr.reset();
+            mBytesTransferred = 0;
+            mError = RCF::Exception();
+            mInitiated = true;
+            mCompleted = false;
+        }
 
         mFts.registerOp( shared_from_this() );
 
         // For debugging purposes, we can wait in this function until the file I/O is completed.
         if (mFts.mSerializeFileIo)
         {
-            RCF::Lock lock(mFts.mCompletionMutex);
-            while (!mCompleted)
-            {
-                mFts.mCompletionCondition.wait(lock);
-            }
+            waitForCompletion();
         }
     }
 
     void FileIoRequest::initateWrite(FileHandlePtr foutPtr, RCF::ByteBuffer buffer)
     {
-        RCF_LOG_4()(foutPtr.get())((void*)buffer.getPtr())(buffer.getLength()) << "FileIoRequest::write()";
+        FileChunk chunk;
+        chunk.mData = buffer;
+        initiateWrite(foutPtr, chunk);
+    }
+
+    void FileIoRequest::initiateWrite(FileHandlePtr foutPtr, const FileChunk & chunk)
+    {
+        RCF_LOG_4()(foutPtr.get())((void*)chunk.mData.getPtr())(chunk.mData.getLength())(chunk.mCompression) << "FileIoRequest::write()";
+
+        {
+            RCF::Lock lock(mCompletionMutex);
+            RCF_ASSERT(mCompleted);
 
-        mFinPtr.reset();
-        mFoutPtr = foutPtr;
-        mBuffer = buffer;
-        mBytesTransferred = 0;
-        mInitiated = true;
-        mCompleted = false;
+            mFinPtr.reset();
+            mFoutPtr = foutPtr;
+            mBuffer = chunk.mData;
+            mCompressedChunkPtr.reset( chunk.mCompression == Fcc_None ? NULL : new FileChunk(chunk) );
+            mBytesTransferred = 0;
+            mError = RCF::Exception();
+            mInitiated = true;
+            mCompleted = false;
+        }
 
         mFts.registerOp( shared_from_this() );
 
         // For debugging purposes, we can wait in this function until the file I/O is completed.
         if (mFts.mSerializeFileIo)
         {
-            RCF::Lock lock(mFts.mCompletionMutex);
-            while (!mCompleted)
-            {
-                mFts.mCompletionCondition.wait(lock);
-            }
+            waitForCompletion();
+        }
+    }
+
+    void FileIoRequest::waitForCompletion()
+    {
+        RCF::Lock lock(mCompletionMutex);
+        while (!mCompleted)
+        {
+            mCompletionCondition.wait(lock);
         }
     }
 
+    FileHandle * FileIoRequest::getFileHandle()
+    {
+        return mFinPtr ? mFinPtr.get() : mFoutPtr.get();
+    }
+
     void FileIoRequest::doTransfer()
     {
         if (mFinPtr)
@@ -245,6 +300,10 @@ namespace RCF {
             RCF_LOG_4()(mBuffer.getLength()) << "FileIoRequest::doTransfer() - initiate read.";
 
             mBytesTransferred = mFinPtr->read(mBuffer);
+            if (mBytesTransferred == 0)
+            {
+                mError = mFinPtr->err();
+            }
             mFinPtr.reset();
 
             RCF_LOG_4()(mBytesTransferred) << "FileIoRequest::doTransfer() - read complete.";
@@ -253,8 +312,42 @@ namespace RCF {
         {
             RCF_LOG_4()(mBuffer.getLength()) << "FileIoRequest::doTransfer() - initiate write.";
 
+            // Compressed data is decompressed here, so the thread that received it can carry on.
+            if (mCompressedChunkPtr)
+            {
+                try
+                {
+                    mCompressedChunkPtr->decompress();
+                }
+                catch (const RCF::Exception & e)
+                {
+                    RCF_LOG_3()(e.getErrorMessage()) << "FileIoRequest::doTransfer() - decompression failed.";
+                    mError = e;
+                    mBytesTransferred = 0;
+                    mCompressedChunkPtr.reset();
+                    mFoutPtr.reset();
+                    return;
+                }
+                catch (const std::exception & e)
+                {
+                    // E.g. std::bad_alloc. The request still has to complete, or the file stays in progress.
+                    RCF_LOG_3()(e.what()) << "FileIoRequest::doTransfer() - decompression failed.";
+                    mError = Exception(e.what());
+                    mBytesTransferred = 0;
+                    mCompressedChunkPtr.reset();
+                    mFoutPtr.reset();
+                    return;
+                }
+                mBuffer = mCompressedChunkPtr->mData;
+                mCompressedChunkPtr.reset();
+            }
+
             mBytesTransferred = mFoutPtr->write(mBuffer);
             RCF_ASSERT(mBytesTransferred == mBuffer.getLength());
+            if (mBytesTransferred == 0)
+            {
+                mError = mFoutPtr->err();
+            }
             mFoutPtr->flush();
             mFoutPtr.reset();
 
@@ -274,6 +367,11 @@ namespace RCF {
         return mBytesTransferred;
     }
 
+    RCF::Exception FileIoRequest::getError()
+    {
+        return mError;
+    }
+
     static FileIoThreadPool * gpFileIoThreadPool = NULL;
 
     void initFileIoThreadPool()
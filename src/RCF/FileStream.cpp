@@ -33,6 +33,16 @@
 
 #include <RCF/BsdSockets.hpp>
 
+#include <chrono>
+#include <sstream>
+
+#ifdef RCF_WINDOWS
+#include <io.h>
+#else
+#include <errno.h>
+#include <unistd.h>
+#endif
+
 namespace fs = RCF_FILESYSTEM_NS;
 
 namespace RCF {
@@ -70,6 +80,7 @@ namespace RCF {
         mFilePath = filePath;
         mOpenMode = mode;
         mBeginPos = 0;
+        mPos = 0;
 
         std::wstring wFilePath = filePath.wstring();
         std::string uFilePath = filePath.u8string();
@@ -96,6 +107,15 @@ namespace RCF {
             mpFile = _wfsopen(wFilePath.c_str(), L"ab", _SH_DENYWR);            
 #else
             mpFile = fopen(uFilePath.c_str(), "ab");
+#endif
+        }
+        else if ( mode == OpenMode::WriteExisting )
+        {
+            // Several handles may write to different parts of the file at once.
+#ifdef RCF_WINDOWS
+            mpFile = _wfsopen(wFilePath.c_str(), L"r+b", _SH_DENYNO);
+#else
+            mpFile = fopen(uFilePath.c_str(), "r+b");
 #endif
         }
         if ( !mpFile )
@@ -106,8 +126,8 @@ namespace RCF {
 
         if ( mode == OpenMode::WriteAppend )
         {
-            // Do an explicit seek to the end so that ftell() returns predictable results.
-            // Without this ftell() returns 0 initially, but after writing, returns results relative to beginning of file.
+            // Writes start at the end of the file, so that tell() returns positions relative to the beginning of 
+            // the file.
 
 #ifdef RCF_WINDOWS
             struct _stat64i32 st = { 0 };
@@ -152,38 +172,67 @@ namespace RCF {
 
     void FileHandle::seek(std::uint64_t newPos)
     {
-
-#ifdef RCF_WINDOWS
-        int ret = _fseeki64(mpFile, newPos, SEEK_SET);
-#else
-        int ret = fseeko64(mpFile, newPos, SEEK_SET);
-#endif
-
-        if ( ret != 0 )
+        if ( !mpFile )
         {
-            int err = Platform::OS::BsdSockets::GetLastError();
-            RCF_THROW(RCF::Exception(RcfError_FileSeek, mFilePath.u8string(), newPos, Platform::OS::GetErrorString(err)));
+            RCF_THROW(RCF::Exception(RcfError_FileSeek, mFilePath.u8string(), newPos, "File is not open."));
         }
+
+        mPos = newPos;
     }
 
     std::uint64_t FileHandle::tell()
     {
+        return mPos;
+    }
 
-#ifdef RCF_WINDOWS
-        std::uint64_t ret = _ftelli64(mpFile);
-#else
-        std::uint64_t ret = ftello64(mpFile);
-#endif
+    std::size_t FileHandle::read(const ByteBuffer& buffer)
+    {
+        std::size_t ret = readAt(buffer, mPos);
+        mPos += ret;
+        return ret;
+    }
 
+    std::size_t FileHandle::write(const ByteBuffer& buffer)
+    {
+        std::size_t ret = writeAt(buffer, mPos);
+        mPos += ret;
         return ret;
     }
 
-    std::size_t FileHandle::read(const ByteBuffer& buffer)
+    // Reads and writes go straight to the OS, so no lock is taken on the FILE, and transfers on different parts 
+    // of a file don't need to seek.
+
+    std::size_t FileHandle::readAt(const ByteBuffer& buffer, std::uint64_t pos)
     {
         std::size_t ret = 0;
         if ( mpFile && buffer.getLength() > 0)
         {
-            ret = fread(buffer.getPtr(), 1, buffer.getLength(), mpFile);
+            char * pch = buffer.getPtr();
+            std::size_t len = buffer.getLength();
+            bool ok = true;
+            while ( ret < len && ok )
+            {
+#ifdef RCF_WINDOWS
+                HANDLE hFile = (HANDLE) _get_osfhandle( _fileno(mpFile) );
+                std::uint64_t offset = pos + ret;
+                OVERLAPPED overlapped = { 0 };
+                overlapped.Offset = static_cast<DWORD>(offset);
+                overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+                DWORD bytesToRead = static_cast<DWORD>( RCF_MIN(len - ret, std::size_t(0x40000000)) );
+                DWORD bytesRead = 0;
+                ok = ReadFile(hFile, pch + ret, bytesToRead, &bytesRead, &overlapped) && bytesRead > 0;
+                ret += bytesRead;
+#else
+                ssize_t bytesRead = pread(fileno(mpFile), pch + ret, len - ret, static_cast<off_t>(pos + ret));
+                if ( bytesRead < 0 && errno == EINTR )
+                {
+                    continue;
+                }
+                ok = bytesRead > 0;
+                ret += ok ? static_cast<std::size_t>(bytesRead) : 0;
+#endif
+            }
+
             if ( ret == 0 )
             {
                 int err = Platform::OS::BsdSockets::GetLastError();
@@ -193,12 +242,37 @@ namespace RCF {
         return ret;
     }
 
-    std::size_t FileHandle::write(const ByteBuffer& buffer)
+    std::size_t FileHandle::writeAt(const ByteBuffer& buffer, std::uint64_t pos)
     {
         std::size_t ret = 0;
         if ( mpFile && buffer.getLength() > 0)
         {
-            ret = fwrite(buffer.getPtr(), 1, buffer.getLength(), mpFile);
+            const char * pch = buffer.getPtr();
+            std::size_t len = buffer.getLength();
+            bool ok = true;
+            while ( ret < len && ok )
+            {
+#ifdef RCF_WINDOWS
+                HANDLE hFile = (HANDLE) _get_osfhandle( _fileno(mpFile) );
+                std::uint64_t offset = pos + ret;
+                OVERLAPPED overlapped = { 0 };
+                overlapped.Offset = static_cast<DWORD>(offset);
+                overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+                DWORD bytesToWrite = static_cast<DWORD>( RCF_MIN(len - ret, std::size_t(0x40000000)) );
+                DWORD bytesWritten = 0;
+                ok = WriteFile(hFile, pch + ret, bytesToWrite, &bytesWritten, &overlapped) && bytesWritten > 0;
+                ret += bytesWritten;
+#else
+                ssize_t bytesWritten = pwrite(fileno(mpFile), pch + ret, len - ret, static_cast<off_t>(pos + ret));
+                if ( bytesWritten < 0 && errno == EINTR )
+                {
+                    continue;
+                }
+                ok = bytesWritten > 0;
+                ret += ok ? static_cast<std::size_t>(bytesWritten) : 0;
+#endif
+            }
+
             if ( ret == 0 )
             {
                 int err = Platform::OS::BsdSockets::GetLastError();
@@ -587,6 +661,7 @@ namespace RCF {
         std::uint32_t chunkSize = 1024 * 1024;
         std::uint32_t transferRateBps = 0;
         std::uint32_t sessionLocalId = 0;
+        bool compressChunks = false;
 
         if ( pOptions )
         {
@@ -598,9 +673,10 @@ namespace RCF {
             {
                 transferRateBps = pOptions->mBandwidthLimitBps;
             }
+            compressChunks = pOptions->mCompressChunks;
         }
         
-        uploadFiles(manifest, uploadId, chunkSize, transferRateBps, sessionLocalId);
+        uploadFiles(manifest, uploadId, chunkSize, transferRateBps, sessionLocalId, compressChunks);
     }
 
     void ClientStub::uploadFiles(
@@ -608,9 +684,10 @@ namespace RCF {
         std::string & uploadId,
         std::uint32_t chunkSize,
         std::uint32_t transferRateBps,
-        std::uint32_t sessionLocalId)
+        std::uint32_t sessionLocalId,
+        bool compressChunks)
     {
-        RCF_LOG_3()(manifest.mFiles.size())(chunkSize)(sessionLocalId) 
+        RCF_LOG_3()(manifest.mFiles.size())(chunkSize)(sessionLocalId)(compressChunks) 
             << "ClientStub::uploadFiles() - entry.";
 
         ClientStub & clientStub = *this;
@@ -653,8 +730,11 @@ namespace RCF {
             serverBps,
             sessionLocalId);
 
-        RCF_LOG_3()(startPos.mFileIndex)(startPos.mOffset)(maxMessageLength)(uploadId)(serverBps) 
+        RCF_LOG_3()(startPos.mFileIndex)(startPos.mOffset)(maxMessageLength)(uploadId)(serverBps)(startPos.mCompression) 
             << "ClientStub::uploadFiles() - BeginUpload() returned.";
+
+        // Chunks are only compressed if the server has said it can decompress them.
+        compressChunks = compressChunks && startPos.mCompression == Fcc_Zlib;
         
         std::uint64_t totalByteSize = manifest.getTotalByteSize();
 
@@ -778,15 +858,21 @@ namespace RCF {
                     chunk.mFileIndex = (std::uint32_t) currentFile;
                     chunk.mOffset = filePos;
                     chunk.mData = ByteBuffer(bufferRead, bufferReadPos, bytesRead);
+                    if (compressChunks)
+                    {
+                        chunk.compress();
+                    }
 
-                    RCF_LOG_3()(chunk.mFileIndex)(chunk.mOffset)(chunk.mData.getLength())
+                    RCF_LOG_3()(chunk.mFileIndex)(chunk.mOffset)(chunk.mData.getLength())(chunk.mCompression)
                         << "ClientStub::uploadFiles() - adding chunk.";
 
                     chunks.push_back( chunk );
 
                     bufferReadPos += bytesRead;
                     filePos += bytesRead;
-                    windowBytesSoFar += (std::uint32_t) bytesRead;
+
+                    // Bandwidth is measured in bytes sent, so compressed chunks count for less.
+                    windowBytesSoFar += (std::uint32_t) chunk.mData.getLength();
 
                     if (bufferReadPos == bufferRead.getLength())
                     {
@@ -873,7 +959,7 @@ namespace RCF {
                     std::size_t bytesSent = 0;
                     for (std::size_t i=0; i<chunks.size(); ++i)
                     {
-                        bytesSent += chunks[i].mData.getLength();
+                        bytesSent += chunks[i].getDataLength();
                     }
                     totalBytesUploadedSoFar += bytesSent;
 
@@ -937,6 +1023,760 @@ namespace RCF {
             << "ClientStub::uploadFiles() - exit.";
     }
 
+    // Compression to ask the server for, on downloaded chunks.
+    static FileChunkCompression getDownloadCompression(bool compressChunks)
+    {
+
+#if RCF_FEATURE_ZLIB==1
+
+        return compressChunks ? Fcc_Zlib : Fcc_None;
+
+#else
+
+        RCF_UNUSED_VARIABLE(compressChunks);
+        return Fcc_None;
+
+#endif
+
+    }
+
+    // A byte range of a striped download, downloaded over a connection of its own.
+    class DownloadStripe
+    {
+    public:
+        std::uint64_t       mBegin = 0;
+        std::uint64_t       mEnd = 0;
+        std::uint64_t       mPos = 0;
+    };
+
+    // Downloads a file over several connections at once, each connection downloading one stripe of the file. The 
+    // position of each stripe is recorded in a .stripes file alongside the download, at most once a second and when 
+    // the download stops, so an interrupted download resumes each stripe where it left off.
+    class StripedDownload : Noncopyable
+    {
+    public:
+
+        typedef RcfClient<I_FileTransferService> FtsClient;
+
+        StripedDownload(
+            ClientStub &            clientStub, 
+            FtsClient &             ftsClient,
+            const std::string &     downloadId,
+            const Path &            filePath,
+            const FileInfo &        fileInfo,
+            std::uint32_t           chunkSize,
+            std::uint32_t           transferRateBps,
+            FileChunkCompression    compression) :
+                mClientStub(clientStub),
+                mFtsClient(ftsClient),
+                mDownloadId(downloadId),
+                mFilePath(filePath),
+                mStripesPath(getStripesPath(filePath)),
+                mFileInfo(fileInfo),
+                mChunkSize(chunkSize),
+                mTransferRateBps(transferRateBps),
+                mCompression(compression),
+                mBasePos(0),
+                mEndPos(0),
+                mBytesDone(0),
+                mActiveStripes(0),
+                mAbort(false),
+                mLastSaveMs(0)
+        {
+        }
+
+        ~StripedDownload()
+        {
+            RCF_DTOR_BEGIN
+                stop();
+            RCF_DTOR_END
+        }
+
+        static Path getStripesPath(const Path & filePath)
+        {
+            Path stripesPath = filePath;
+            stripesPath += ".stripes";
+            return stripesPath;
+        }
+
+        // Loads the stripes of an interrupted download. Returns false if they don't match the file being downloaded.
+        bool loadStripes(std::uint64_t basePos, std::uint64_t endPos)
+        {
+            std::string text;
+            {
+                FileHandle fin(mStripesPath, FileHandle::Read);
+                std::uint64_t fileSize = fs::file_size(mStripesPath);
+                ByteBuffer buffer( static_cast<std::size_t>(fileSize) );
+                std::size_t bytesRead = fin.read(buffer);
+                text.assign(buffer.getPtr(), bytesRead);
+            }
+
+            std::istringstream is(text);
+            std::string tag;
+            std::uint64_t fileSize = 0;
+            std::uint64_t lastWriteTime = 0;
+            std::uint64_t stripesBasePos = 0;
+            std::uint64_t stripesEndPos = 0;
+            std::size_t stripeCount = 0;
+            is >> tag >> fileSize >> lastWriteTime >> stripesBasePos >> stripesEndPos >> stripeCount;
+
+            if (    !is
+                ||  tag != "RCF-STRIPES-1"
+                ||  fileSize != mFileInfo.mFileSize
+                ||  lastWriteTime != mFileInfo.mLastWriteTime
+                ||  stripesBasePos != basePos
+                ||  stripesEndPos != endPos
+                ||  !fs::exists(mFilePath))
+            {
+                RCF_LOG_2()(mStripesPath.u8string()) << "StripedDownload - discarding stripes of a different download.";
+                return false;
+            }
+
+            std::vector<DownloadStripe> stripes(stripeCount);
+            for (std::size_t i = 0; i < stripes.size(); ++i)
+            {
+                DownloadStripe & stripe = stripes[i];
+                is >> stripe.mBegin >> stripe.mEnd >> stripe.mPos;
+                if (    !is 
+                    ||  stripe.mBegin < basePos 
+                    ||  stripe.mEnd > endPos 
+                    ||  stripe.mPos < stripe.mBegin 
+                    ||  stripe.mPos > stripe.mEnd)
+                {
+                    return false;
+                }
+            }
+
+            mBasePos = basePos;
+            mEndPos = endPos;
+            mStripes.swap(stripes);
+            mBytesDone = (endPos - basePos) - remainingBytes(mStripes);
+
+            RCF_LOG_3()(mStripesPath.u8string())(mStripes.size())(mBytesDone) << "StripedDownload - resuming stripes.";
+            return true;
+        }
+
+        // Splits [beginPos, endPos) into stripes. Bytes from basePos to beginPos have already been downloaded.
+        void createStripes(
+            std::uint64_t           basePos, 
+            std::uint64_t           beginPos, 
+            std::uint64_t           endPos, 
+            std::uint32_t           stripeCount,
+            bool                    keepExisting)
+        {
+            mBasePos = basePos;
+            mEndPos = endPos;
+            mStripes.clear();
+
+            // Stripes are a whole number of chunks, apart from the last.
+            std::uint64_t stripeSize = (endPos - beginPos + stripeCount - 1) / stripeCount;
+            stripeSize = RCF_MAX(stripeSize, std::uint64_t(mChunkSize));
+            stripeSize = (stripeSize + mChunkSize - 1) / mChunkSize * mChunkSize;
+
+            for (std::uint64_t pos = beginPos; pos < endPos; pos += stripeSize)
+            {
+                DownloadStripe stripe;
+                stripe.mBegin = pos;
+                stripe.mEnd = RCF_MIN(pos + stripeSize, endPos);
+                stripe.mPos = pos;
+                mStripes.push_back(stripe);
+            }
+
+            mBytesDone = beginPos - basePos;
+
+            // The stripes are recorded before anything is written out of order.
+            saveStripes();
+
+            if (!keepExisting)
+            {
+                FileHandle().open(mFilePath, FileHandle::WriteTruncate);
+            }
+
+            RCF_LOG_3()(mFilePath.u8string())(mStripes.size())(stripeSize) << "StripedDownload - created stripes.";
+        }
+
+        void download(FileTransferProgress & progressInfo)
+        {
+            progressInfo.mBytesTotalToTransfer = mEndPos - mBasePos;
+            progressInfo.mBytesTransferredSoFar = mBytesDone;
+            mClientStub.runFileProgressNotifications(progressInfo);
+
+            std::vector<std::size_t> stripeIndexes;
+            for (std::size_t i = 0; i < mStripes.size(); ++i)
+            {
+                if (mStripes[i].mPos < mStripes[i].mEnd)
+                {
+                    stripeIndexes.push_back(i);
+                }
+            }
+
+            mActiveStripes = stripeIndexes.size();
+
+            for (std::size_t i = 0; i < stripeIndexes.size(); ++i)
+            {
+                // The first stripe uses the connection that the download was begun on.
+                mThreads.push_back( ThreadPtr( new Thread( std::bind(
+                    &StripedDownload::stripeTask, 
+                    this, 
+                    stripeIndexes[i], 
+                    i == 0) ) ) );
+            }
+
+            std::uint64_t bytesReported = mBytesDone;
+            while (true)
+            {
+                {
+                    Lock lock(mMutex);
+                    if (mActiveStripes > 0 && !mErrorPtr && mBytesDone == bytesReported)
+                    {
+                        using namespace std::chrono_literals;
+                        mCondition.wait_for(lock, 1000ms);
+                    }
+                    if (mActiveStripes == 0 || mErrorPtr)
+                    {
+                        break;
+                    }
+                    bytesReported = mBytesDone;
+                }
+
+                progressInfo.mBytesTransferredSoFar = bytesReported;
+                mClientStub.runFileProgressNotifications(progressInfo);
+            }
+
+            stop();
+
+            if (mErrorPtr)
+            {
+                mErrorPtr->throwSelf();
+            }
+
+            fs::remove(mStripesPath);
+            setLastWriteTime(mFilePath, mFileInfo.mLastWriteTime);
+
+            progressInfo.mBytesTransferredSoFar = mBytesDone;
+            mClientStub.runFileProgressNotifications(progressInfo);
+        }
+
+    private:
+
+        static std::uint64_t remainingBytes(const std::vector<DownloadStripe> & stripes)
+        {
+            std::uint64_t bytes = 0;
+            for (std::size_t i = 0; i < stripes.size(); ++i)
+            {
+                bytes += stripes[i].mEnd - stripes[i].mPos;
+            }
+            return bytes;
+        }
+
+        void stop()
+        {
+            {
+                Lock lock(mMutex);
+                mAbort = true;
+                mCondition.notify_all();
+            }
+
+            for (std::size_t i = 0; i < mThreads.size(); ++i)
+            {
+                mThreads[i]->join();
+            }
+
+            // Record where each stripe got to, if the download is being abandoned.
+            if (!mThreads.empty() && remainingBytes(mStripes) > 0)
+            {
+                saveStripes();
+            }
+
+            mThreads.clear();
+        }
+
+        // Written to a temporary file first, so an interruption never leaves a partially written .stripes file.
+        void saveStripes()
+        {
+            std::ostringstream os;
+            os 
+                << "RCF-STRIPES-1 " 
+                << mFileInfo.mFileSize << " " 
+                << mFileInfo.mLastWriteTime << " " 
+                << mBasePos << " " 
+                << mEndPos << " " 
+                << mStripes.size() << "\n";
+
+            for (std::size_t i = 0; i < mStripes.size(); ++i)
+            {
+                os << mStripes[i].mBegin << " " << mStripes[i].mEnd << " " << mStripes[i].mPos << "\n";
+            }
+
+            std::string text = os.str();
+
+            Path tempPath = mStripesPath;
+            tempPath += ".tmp";
+
+            {
+                FileHandle fout(tempPath, FileHandle::WriteTruncate);
+                std::size_t bytesWritten = fout.write( ByteBuffer(&text[0], text.size()) );
+                if (bytesWritten != text.size())
+                {
+                    RCF_THROW(fout.err());
+                }
+            }
+
+            fs::rename(tempPath, mStripesPath);
+
+            mLastSaveMs = getCurrentTimeMs();
+        }
+
+        void stripeTask(std::size_t stripeIndex, bool useDownloadConnection)
+        {
+            try
+            {
+                if (useDownloadConnection)
+                {
+                    downloadStripe(mFtsClient, stripeIndex);
+                }
+                else
+                {
+                    FtsClient ftsClient( mFtsClient.getClientStub() );
+
+                    FileManifest manifest;
+                    FileTransferRequest request;
+                    std::vector<FileChunk> chunks;
+                    std::uint32_t maxMessageLength = 0;
+                    std::uint32_t serverBps = 0;
+
+                    ftsClient.BeginDownload(
+                        manifest, 
+                        request, 
+                        chunks, 
+                        maxMessageLength, 
+                        serverBps, 
+                        0, 
+                        mDownloadId);
+
+                    downloadStripe(ftsClient, stripeIndex);
+                }
+            }
+            catch (const Exception & e)
+            {
+                onStripeError( ExceptionPtr(e.clone().release()) );
+            }
+            catch (const std::exception & e)
+            {
+                onStripeError( ExceptionPtr(new Exception(e.what())) );
+            }
+
+            Lock lock(mMutex);
+            --mActiveStripes;
+            mCondition.notify_all();
+        }
+
+        void onStripeError(ExceptionPtr ePtr)
+        {
+            Lock lock(mMutex);
+            if (!mErrorPtr)
+            {
+                mErrorPtr = ePtr;
+            }
+            mAbort = true;
+            mCondition.notify_all();
+        }
+
+        void downloadStripe(FtsClient & ftsClient, std::size_t stripeIndex)
+        {
+            std::uint64_t pos = 0;
+            std::uint64_t end = 0;
+            std::size_t stripeCount = 0;
+            {
+                Lock lock(mMutex);
+                pos = mStripes[stripeIndex].mPos;
+                end = mStripes[stripeIndex].mEnd;
+                stripeCount = mActiveStripes;
+            }
+
+            RCF_LOG_3()(stripeIndex)(pos)(end) << "StripedDownload - downloading stripe.";
+
+            FileChunk startPos;
+            startPos.mOffset = pos;
+            ftsClient.TrimDownload(startPos);
+
+            FileHandle fout(mFilePath, FileHandle::WriteExisting);
+            fout.seek(pos - mBasePos);
+
+            // The server releases the download once its last byte has been sent, so the last byte of the file 
+            // is downloaded once all the other stripes are complete.
+            bool holdLastByte = (end == mFileInfo.mFileSize);
+            if (holdLastByte)
+            {
+                downloadRange(ftsClient, fout, stripeIndex, pos, end - 1, stripeCount);
+
+                Lock lock(mMutex);
+                while (mActiveStripes > 1 && !mAbort)
+                {
+                    using namespace std::chrono_literals;
+                    mCondition.wait_for(lock, 1000ms);
+                }
+            }
+
+            downloadRange(ftsClient, fout, stripeIndex, pos, end, stripeCount);
+            fout.close();
+        }
+
+        void downloadRange(
+            FtsClient &             ftsClient, 
+            FileHandle &            fout, 
+            std::size_t             stripeIndex, 
+            std::uint64_t &         pos, 
+            std::uint64_t           end,
+            std::size_t             stripeCount)
+        {
+            // The client bandwidth limit is shared between the stripes.
+            const std::uint32_t     TransferWindowS = 5;
+            std::uint32_t           transferRateBps = mTransferRateBps / static_cast<std::uint32_t>(stripeCount);
+            Timer                   transferWindowTimer;
+            std::uint32_t           transferWindowBytes = 0;
+            std::uint32_t           adviseWaitMs = 0;
+            std::uint32_t           serverBps = 0;
+
+            if (mTransferRateBps && transferRateBps == 0)
+            {
+                transferRateBps = 1;
+            }
+
+            while (pos < end)
+            {
+                {
+                    Lock lock(mMutex);
+                    if (mAbort)
+                    {
+                        return;
+                    }
+                }
+
+                FileTransferRequest request;
+                request.mFile       = 0;
+                request.mPos        = pos;
+                request.mChunkSize  = static_cast<std::uint32_t>( RCF_MIN(std::uint64_t(mChunkSize), end - pos) );
+                request.mCompression = mCompression;
+
+                // Respect server throttle settings.
+                if (adviseWaitMs)
+                {
+                    sleepMs(adviseWaitMs);
+                    adviseWaitMs = 0;
+                }
+
+                // Respect local throttle setting.
+                if (transferRateBps)
+                {
+                    if (transferWindowTimer.elapsed(TransferWindowS*1000))
+                    {
+                        transferWindowTimer.restart();
+                        transferWindowBytes = 0;
+                    }
+
+                    std::uint32_t bytesTotal = transferRateBps * TransferWindowS;
+                    if (transferWindowBytes >= bytesTotal)
+                    {
+                        std::uint32_t elapsedMs = transferWindowTimer.getDurationMs();
+                        if (elapsedMs < TransferWindowS*1000)
+                        {
+                            sleepMs(TransferWindowS*1000 - elapsedMs);
+                        }
+                        transferWindowTimer.restart();
+                        transferWindowBytes = 0;
+                    }
+
+                    request.mChunkSize = RCF_MIN(request.mChunkSize, bytesTotal - transferWindowBytes);
+                }
+
+                std::vector<FileChunk> chunks;
+                ftsClient.DownloadChunks(request, chunks, adviseWaitMs, serverBps);
+
+                if (    chunks.size() != 1 
+                    ||  chunks[0].mOffset != pos 
+                    ||  chunks[0].getDataLength() > end - pos 
+                    ||  chunks[0].getDataLength() > request.mChunkSize)
+                {
+                    RCF_THROW( Exception(RcfError_FileOffset, pos, chunks.empty() ? 0 : chunks[0].mOffset) );
+                }
+
+                // Each stripe has a thread of its own, so compressed chunks are decompressed here.
+                std::uint32_t bytesReceived = static_cast<std::uint32_t>(chunks[0].mData.getLength());
+                chunks[0].decompress();
+
+                const ByteBuffer & data = chunks[0].mData;
+                if (data.getLength() > 0)
+                {
+                    std::size_t bytesWritten = fout.write(data);
+                    if (bytesWritten != data.getLength())
+                    {
+                        RCF_THROW(fout.err());
+                    }
+                    fout.flush();
+                }
+
+                pos += data.getLength();
+                transferWindowBytes += bytesReceived;
+
+                Lock lock(mMutex);
+                mStripes[stripeIndex].mPos = pos;
+                mBytesDone += data.getLength();
+                if (getCurrentTimeMs() - mLastSaveMs >= 1000)
+                {
+                    saveStripes();
+                }
+                mCondition.notify_all();
+            }
+        }
+
+        ClientStub &                    mClientStub;
+        FtsClient &                     mFtsClient;
+        std::string                     mDownloadId;
+        Path                            mFilePath;
+        Path                            mStripesPath;
+        FileInfo                        mFileInfo;
+        std::uint32_t                   mChunkSize;
+        std::uint32_t                   mTransferRateBps;
+        FileChunkCompression            mCompression;
+
+        // Bytes from mBasePos to mEndPos on the server are written to the file, from the start of the file.
+        std::uint64_t                   mBasePos;
+        std::uint64_t                   mEndPos;
+
+        Mutex                           mMutex;
+        Condition                       mCondition;
+        std::vector<DownloadStripe>     mStripes;
+        std::uint64_t                   mBytesDone;
+        std::size_t                     mActiveStripes;
+        bool                            mAbort;
+        ExceptionPtr                    mErrorPtr;
+        std::uint32_t                   mLastSaveMs;
+
+        std::vector<ThreadPtr>          mThreads;
+    };
+
+    // Downloads a file as a delta against an existing copy of it. The signatures of the blocks of the existing copy 
+    // are sent to the server, and the server sends back the parts of the file that don't match any block. The new 
+    // copy is built in a .delta file alongside the existing one, and replaces it once its hash has been verified.
+    class DeltaDownload : Noncopyable
+    {
+    public:
+
+        typedef RcfClient<I_FileTransferService> FtsClient;
+
+        DeltaDownload(
+            ClientStub &            clientStub,
+            FtsClient &             ftsClient,
+            const Path &            filePath,
+            const FileInfo &        fileInfo,
+            std::uint32_t           chunkSize,
+            std::uint32_t           transferRateBps) :
+                mClientStub(clientStub),
+                mFtsClient(ftsClient),
+                mFilePath(filePath),
+                mDeltaPath(filePath),
+                mFileInfo(fileInfo),
+                mChunkSize(chunkSize),
+                mTransferRateBps(transferRateBps),
+                mBasisSize(0)
+        {
+            mDeltaPath += ".delta";
+        }
+
+        void download(std::uint32_t maxSignatureBytes, std::uint32_t serverBps)
+        {
+            mBasisSize = fs::file_size(mFilePath);
+
+            FileSignature signature;
+            computeFileSignature(
+                mFilePath, 
+                chooseDeltaBlockSize(mBasisSize, maxSignatureBytes), 
+                signature);
+
+            RCF_LOG_3()(mFilePath.u8string())(signature.mBlockSize)(signature.mWeakHashes.size())
+                << "DeltaDownload - calling BeginDeltaDownload().";
+
+            mFtsClient.BeginDeltaDownload(signature);
+
+            try
+            {
+                downloadDelta(serverBps);
+            }
+            catch(...)
+            {
+                mBasis.close();
+                mOut.close();
+                std::error_code ec;
+                fs::remove(mDeltaPath, ec);
+                throw;
+            }
+
+            fs::rename(mDeltaPath, mFilePath);
+            setLastWriteTime(mFilePath, mFileInfo.mLastWriteTime);
+
+            RCF_LOG_3()(mFilePath.u8string()) << "DeltaDownload - download completed.";
+        }
+
+    private:
+
+        void downloadDelta(std::uint32_t serverBps)
+        {
+            const std::uint32_t     TransferWindowS = 5;
+            Timer                   transferWindowTimer;
+            std::uint32_t           transferWindowBytes = 0;
+            std::uint32_t           adviseWaitMs = 0;
+            std::uint64_t           pos = 0;
+            std::uint64_t           literalBytes = 0;
+            std::string             fileHash;
+
+            mBasis.open(mFilePath, FileHandle::Read);
+            mOut.open(mDeltaPath, FileHandle::WriteTruncate);
+
+            FileTransferProgress progressInfo;
+            progressInfo.mDownloadPath              = mFilePath;
+            progressInfo.mBytesTotalToTransfer      = mFileInfo.mFileSize;
+            progressInfo.mBytesTransferredSoFar     = 0;
+            progressInfo.mServerLimitBps            = serverBps;
+            mClientStub.runFileProgressNotifications(progressInfo);
+
+            while (fileHash.empty())
+            {
+                FileTransferRequest request;
+                request.mFile       = 0;
+                request.mPos        = pos;
+                request.mChunkSize  = mChunkSize;
+
+                // Respect server throttle settings.
+                if (adviseWaitMs)
+                {
+                    sleepMs(adviseWaitMs);
+                    adviseWaitMs = 0;
+                }
+
+                // Respect local throttle setting. Only literal data counts against it.
+                if (mTransferRateBps)
+                {
+                    if (transferWindowTimer.elapsed(TransferWindowS*1000))
+                    {
+                        transferWindowTimer.restart();
+                        transferWindowBytes = 0;
+                    }
+
+                    std::uint32_t bytesTotal = mTransferRateBps * TransferWindowS;
+                    if (transferWindowBytes >= bytesTotal)
+                    {
+                        std::uint32_t elapsedMs = transferWindowTimer.getDurationMs();
+                        if (elapsedMs < TransferWindowS*1000)
+                        {
+                            sleepMs(TransferWindowS*1000 - elapsedMs);
+                        }
+                        transferWindowTimer.restart();
+                        transferWindowBytes = 0;
+                    }
+
+                    request.mChunkSize = RCF_MIN(request.mChunkSize, bytesTotal - transferWindowBytes);
+                }
+
+                std::vector<FileDeltaOp> ops;
+                mFtsClient.DownloadDeltaChunks(request, ops, fileHash, adviseWaitMs, serverBps);
+
+                for (std::size_t i = 0; i < ops.size(); ++i)
+                {
+                    const FileDeltaOp & op = ops[i];
+
+                    RCF_VERIFY(
+                        op.mLength <= mFileInfo.mFileSize - pos, 
+                        Exception(RcfError_FileDelta, "Delta exceeds file size."));
+
+                    if (op.isCopy())
+                    {
+                        RCF_VERIFY(
+                            op.mBasisOffset <= mBasisSize && op.mLength <= mBasisSize - op.mBasisOffset,
+                            Exception(RcfError_FileDelta, "Block outside of existing file."));
+
+                        copyFromBasis(op.mBasisOffset, op.mLength);
+                    }
+                    else
+                    {
+                        RCF_VERIFY(
+                            op.mLength == op.mData.getLength(), 
+                            Exception(RcfError_FileDelta, "Invalid literal length."));
+
+                        write(op.mData);
+                        literalBytes += op.mLength;
+                        transferWindowBytes += static_cast<std::uint32_t>(op.mLength);
+                    }
+
+                    pos += op.mLength;
+                }
+
+                progressInfo.mBytesTransferredSoFar = pos;
+                progressInfo.mServerLimitBps = serverBps;
+                mClientStub.runFileProgressNotifications(progressInfo);
+            }
+
+            mBasis.close();
+            mOut.close();
+
+            RCF_LOG_3()(mFilePath.u8string())(pos)(literalBytes) << "DeltaDownload - delta applied.";
+
+            if (pos != mFileInfo.mFileSize || mHash.final() != fileHash)
+            {
+                RCF_THROW( Exception(RcfError_FileHashMismatch, mFilePath.u8string()) );
+            }
+        }
+
+        void copyFromBasis(std::uint64_t offset, std::uint64_t length)
+        {
+            if (mCopyBuffer.empty())
+            {
+                mCopyBuffer.resize(RCF_MIN(mChunkSize, std::uint32_t(1024*1024)));
+            }
+
+            mBasis.seek(offset);
+            while (length > 0)
+            {
+                std::size_t bytesToRead = static_cast<std::size_t>( 
+                    RCF_MIN(length, std::uint64_t(mCopyBuffer.size())) );
+
+                ByteBuffer data(&mCopyBuffer[0], bytesToRead);
+                std::size_t bytesRead = mBasis.read(data);
+                if (bytesRead != bytesToRead)
+                {
+                    RCF_THROW(mBasis.err());
+                }
+
+                write(data);
+                length -= bytesRead;
+            }
+        }
+
+        void write(const ByteBuffer & data)
+        {
+            std::size_t bytesWritten = mOut.write(data);
+            if (bytesWritten != data.getLength())
+            {
+                RCF_THROW(mOut.err());
+            }
+            mHash.update(data.getPtr(), data.getLength());
+        }
+
+        ClientStub &                    mClientStub;
+        FtsClient &                     mFtsClient;
+        Path                            mFilePath;
+        Path                            mDeltaPath;
+        FileInfo                        mFileInfo;
+        std::uint32_t                   mChunkSize;
+        std::uint32_t                   mTransferRateBps;
+
+        std::uint64_t                   mBasisSize;
+        FileHandle                      mBasis;
+        FileHandle                      mOut;
+        Sha256                          mHash;
+        std::vector<char>               mCopyBuffer;
+    };
+
     void ClientStub::downloadFile(
         const std::string&      downloadId,
         const Path&             downloadToPath,
@@ -949,6 +1789,9 @@ namespace RCF {
         std::uint32_t transferRateBps = 0;
         std::uint64_t startPosition = 0;
         std::uint64_t endPosition = std::uint64_t(-1);
+        std::uint32_t stripeCount = 1;
+        bool deltaSync = false;
+        bool compressChunks = false;
 
         if ( pOptions )
         {
@@ -968,6 +1811,12 @@ namespace RCF {
             {
                 endPosition = pOptions->mEndPos;
             }
+            if ( pOptions->mStripeCount )
+            {
+                stripeCount = pOptions->mStripeCount;
+            }
+            deltaSync = pOptions->mDeltaSync;
+            compressChunks = pOptions->mCompressChunks;
         }
 
         std::uint32_t sessionLocalDownloadId = 0;
@@ -979,7 +1828,10 @@ namespace RCF {
             sessionLocalDownloadId, 
             downloadId, 
             startPosition, 
-            endPosition);
+            endPosition,
+            stripeCount,
+            deltaSync,
+            compressChunks);
     }
 
     void ClientStub::downloadFiles(
@@ -990,9 +1842,12 @@ namespace RCF {
         std::uint32_t sessionLocalId,
         const std::string & downloadId,
         std::uint64_t startPosition,
-        std::uint64_t endPosition)
+        std::uint64_t endPosition,
+        std::uint32_t stripeCount,
+        bool deltaSync,
+        bool compressChunks)
     {
-        RCF_LOG_3()(downloadToPath.u8string())(chunkSize)(transferRateBps)(sessionLocalId)(downloadId)(startPosition)(endPosition)
+        RCF_LOG_3()(downloadToPath.u8string())(chunkSize)(transferRateBps)(sessionLocalId)(downloadId)(startPosition)(endPosition)(stripeCount)(deltaSync)(compressChunks)
             << "ClientStub::downloadFiles() - entry.";
 
         ClientStub & clientStub = *this;
@@ -1065,9 +1920,34 @@ namespace RCF {
             currentPos = startPosition;
         }
         
+        // A striped download that was interrupted, is resumed stripe by stripe, as the file may have gaps.
+        Path stripesPath = StripedDownload::getStripesPath(filePath);
+        bool resumeStripes = fs::exists(stripesPath);
+
+        // Download only the differences from an existing copy of the whole file. A partially downloaded file is 
+        // also verified this way, rather than being appended to.
+        if (    deltaSync 
+            &&  !resumeStripes 
+            &&  startPosition == 0 
+            &&  endPosition == fileInfo.mFileSize 
+            &&  fs::exists(filePath) 
+            &&  fs::file_size(filePath) > 0 )
+        {
+            DeltaDownload deltaDownload(
+                *this, 
+                ftsClient, 
+                filePath, 
+                fileInfo, 
+                chunkSize, 
+                transferRateBps);
+
+            deltaDownload.download(serverMaxMessageLength*8/10, serverBps);
+            return;
+        }
+
         // Adjust download position for any previously downloaded fragment.
         bool resumeExisting = false;
-        if ( fs::exists(filePath) )
+        if ( !resumeStripes && fs::exists(filePath) )
         {
             std::uint64_t fileSize = fs::file_size(filePath);
             if ( fileSize )
@@ -1085,7 +1965,7 @@ namespace RCF {
         progressInfo.mBytesTransferredSoFar     = currentPos - startPosition;
         progressInfo.mServerLimitBps            = serverBps;        
 
-        if ( currentPos == endPosition )
+        if ( currentPos == endPosition && !resumeStripes )
         {
             // No downloading needed.
             if ( !fs::exists(filePath) )
@@ -1099,6 +1979,41 @@ namespace RCF {
             return;
         }
 
+        // Download over several connections, if there is enough left to download.
+        if (    resumeStripes 
+            ||  (stripeCount > 1 && endPosition - currentPos >= 2*chunkSize && ftsClient.getClientStub().getEndpoint()) )
+        {
+            StripedDownload stripedDownload(
+                *this, 
+                ftsClient, 
+                downloadId, 
+                filePath, 
+                fileInfo, 
+                chunkSize, 
+                transferRateBps,
+                getDownloadCompression(compressChunks));
+
+            if ( !resumeStripes || !stripedDownload.loadStripes(startPosition, endPosition) )
+            {
+                if ( resumeStripes )
+                {
+                    // The stripes don't match the file on the server, so start over.
+                    currentPos = startPosition;
+                    resumeExisting = false;
+                }
+
+                stripedDownload.createStripes(
+                    startPosition, 
+                    currentPos, 
+                    endPosition, 
+                    RCF_MAX(stripeCount, std::uint32_t(1)), 
+                    resumeExisting);
+            }
+
+            stripedDownload.download(progressInfo);
+            return;
+        }
+
         // Inform server of download position.
         if ( currentPos )
         {
@@ -1156,6 +2071,7 @@ namespace RCF {
                 request.mFile       = 0;
                 request.mPos        = currentPos;
                 request.mChunkSize  = chunkSize;
+                request.mCompression = getDownloadCompression(compressChunks);
 
                 if ( endPosition - currentPos < chunkSize )
                 {
@@ -1227,11 +2143,17 @@ namespace RCF {
                     }
                 }
 
-                RCF_LOG_3()(chunk.mData.getLength())(adviseWaitMs)(serverBps)
+                // Don't trust the decompressed length of a chunk, beyond what we asked for.
+                if ( chunk.getDataLength() > request.mChunkSize )
+                {
+                    RCF_THROW( Exception(RcfError_FileOffset, currentPos + request.mChunkSize, chunk.mOffset + chunk.getDataLength()) );
+                }
+
+                RCF_LOG_3()(chunk.mData.getLength())(chunk.mCompression)(adviseWaitMs)(serverBps)
                     << "ClientStub::downloadFiles() - DownloadChunks() returned.";
 
                 // Update byte totals.
-                totalBytesReadSoFar += chunk.mData.getLength();
+                totalBytesReadSoFar += chunk.getDataLength();
                 transferWindowBytes += (std::uint32_t) chunk.mData.getLength();
             }
 
@@ -1252,22 +2174,23 @@ namespace RCF {
                 {
                     fout->close();
                     setLastWriteTime(filePath, fileInfo.mLastWriteTime);
-                    Exception e = fout->err();
+                    Exception e = writeOp->getError();
                     RCF_ASSERT(e.bad());
                     RCF_THROW(e);
                 }
             }
 
             // Initiate write of current chunk.
-            RCF_ASSERT(currentPos + chunk.mData.getLength() <= endPosition);
+            RCF_ASSERT(currentPos + chunk.getDataLength() <= endPosition);
 
-            RCF_LOG_3()(chunk.mData.getLength())
+            RCF_LOG_3()(chunk.getDataLength())
                 << "ClientStub::downloadFiles() - file write initiated.";
 
             if ( chunk.mData.getLength() > 0 )
             {
-                writeOp->initateWrite(fout, chunk.mData);
-                currentPos += chunk.mData.getLength();
+                // Compressed chunks are decompressed by the write, on the file I/O threads.
+                writeOp->initiateWrite(fout, chunk);
+                currentPos += chunk.getDataLength();
             }
 
             // Check if this was the last chunk.
@@ -1288,7 +2211,7 @@ namespace RCF {
                 {
                     fout->close();
                     setLastWriteTime(filePath, fileInfo.mLastWriteTime);
-                    Exception e = fout->err();
+                    Exception e = writeOp->getError();
                     RCF_ASSERT(e.bad());
                     RCF_THROW(e);
                 }
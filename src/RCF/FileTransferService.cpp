@@ -20,6 +20,7 @@
 
 #include <functional>
 
+#include <cmath>
 #include <cstdio>
 #include <iomanip>
 
@@ -39,6 +40,10 @@
 
 #include <RCF/FileSystem.hpp>
 
+#if RCF_FEATURE_ZLIB==1
+#include <RCF/ZlibCompressionFilter.hpp>
+#endif
+
 namespace SF {
 
 #if RCF_FEATURE_SF==1
@@ -220,6 +225,14 @@ namespace RCF {
 
         bps = uploadInfoPtr->mQuotaPtr->calculateLineSpeedLimit();
 
+#if RCF_FEATURE_ZLIB==1
+        // Let the client know it can upload compressed chunks.
+        if (getTlsRcfSession().getRuntimeVersion() >= 14)
+        {
+            startPos.mCompression = Fcc_Zlib;
+        }
+#endif
+
         checkForUploadCompletion(uploadInfoPtr);
 
         if (mUploadProgressCb)
@@ -266,6 +279,14 @@ namespace RCF {
 
         const FileChunk & chunk = chunks[0];
 
+        // The client never sends chunks larger than our max message length, so a compressed 
+        // chunk can't legitimately decompress to more than that either.
+        std::size_t maxMessageLength = getTlsRcfSession().getNetworkSession().getServerTransport().getMaxIncomingMessageLength();
+        if (maxMessageLength && chunk.getDataLength() > maxMessageLength)
+        {
+            RCF_THROW( Exception(RcfError_UploadFileSize) );
+        }
+
         if (chunk.mFileIndex != uploadInfo.mCurrentFile)
         {
             if (chunk.mFileIndex != uploadInfo.mCurrentFile)
@@ -329,7 +350,7 @@ namespace RCF {
             std::uint64_t bytesWritten = uploadInfo.mWriteOp->getBytesTransferred();
             if (bytesWritten == 0)
             {
-                Exception e = fout->err();
+                Exception e = uploadInfo.mWriteOp->getError();
                 fout->close();
                 RCF_ASSERT(e.bad());
                 RCF_THROW(e);
@@ -349,23 +370,32 @@ namespace RCF {
         // Check the chunk size.
         std::uint64_t fileSize = file.mFileSize;
         std::uint64_t remainingFileSize = fileSize - uploadInfo.mCurrentPos;
-        if (chunk.mData.getLength() > remainingFileSize)
+        if (chunk.getDataLength() > remainingFileSize)
         {
             RCF_THROW( Exception(RcfError_UploadFileSize) );
         }
 
-        uploadInfo.mWriteOp->initateWrite(uploadInfo.mFileHandle, chunk.mData);
+        // Compressed chunks are decompressed by the write, on the file I/O threads.
+        uploadInfo.mWriteOp->initiateWrite(uploadInfo.mFileHandle, chunk);
 
         uploadInfoPtr->mTimeStampMs = RCF::getCurrentTimeMs();
 
         // Check if last chunk.
-        uploadInfo.mCurrentPos += chunk.mData.getLength();
+        uploadInfo.mCurrentPos += chunk.getDataLength();
         if (uploadInfo.mCurrentPos == fileSize)
         {
             RCF_LOG_3()(uploadInfo.mCurrentFile) 
                 << "FileTransferService::UploadChunks() - closing file.";
 
             uploadInfo.mWriteOp->complete();
+            if (uploadInfo.mWriteOp->getBytesTransferred() == 0 && !chunk.isEmpty())
+            {
+                Exception e = uploadInfo.mWriteOp->getError();
+                fout->close();
+                RCF_ASSERT(e.bad());
+                RCF_THROW(e);
+            }
+
             fout->close();
 
             // Rename to drop the ".tmp" extension.
@@ -572,58 +602,7 @@ namespace RCF {
         std::uint32_t chunkSize = request.mChunkSize;
 
         // Trim the chunk size, according to throttle settings.
-        bps = di.mQuotaPtr->calculateLineSpeedLimit();
-
-        if (bps)
-        {
-            RCF_LOG_3()(bps)(mTransferWindowS)(di.mTransferWindowBytesTotal)(di.mTransferWindowBytesSoFar) 
-                << "FileTransferService::DownloadChunks() - checking throttle setting.";
-
-            if (di.mTransferWindowTimer.elapsed(mTransferWindowS*1000))
-            {
-                RCF_ASSERT(di.mTransferWindowBytesTotal >= di.mTransferWindowBytesSoFar);
-
-                std::uint32_t carryOver = 
-                    di.mTransferWindowBytesTotal - di.mTransferWindowBytesSoFar;
-
-                di.mTransferWindowTimer.restart();
-
-                di.mTransferWindowBytesTotal = bps * mTransferWindowS;
-                di.mTransferWindowBytesTotal += carryOver;
-
-                di.mTransferWindowBytesSoFar = 0;
-
-                RCF_LOG_3()(mTransferWindowS)(di.mTransferWindowBytesTotal)(di.mTransferWindowBytesSoFar)(carryOver) 
-                    << "FileTransferService::DownloadChunks() - new throttle transfer window.";
-            }
-
-            if (di.mTransferWindowBytesTotal == 0)
-            {
-                di.mTransferWindowBytesTotal = bps * mTransferWindowS;
-            }
-
-            std::uint32_t bytesWindowRemaining = 
-                di.mTransferWindowBytesTotal - di.mTransferWindowBytesSoFar;
-
-            if (bytesWindowRemaining < chunkSize)
-            {
-                std::uint32_t windowStartMs = di.mTransferWindowTimer.getStartTimeMs();
-                std::uint32_t windowEndMs = windowStartMs + 1000*mTransferWindowS;
-                std::uint32_t nowMs = getCurrentTimeMs();
-                if (nowMs < windowEndMs)
-                {
-                    adviseWaitMs = windowEndMs - nowMs;
-
-                    RCF_LOG_3()(adviseWaitMs) 
-                        << "FileTransferService::DownloadChunks() - advising client wait.";
-                }
-            }
-
-            RCF_LOG_3()(chunkSize)(bytesWindowRemaining)(di.mTransferWindowBytesTotal) 
-                << "FileTransferService::DownloadChunks() - trimming chunk size to transfer window.";
-
-            chunkSize = RCF_MIN(chunkSize, bytesWindowRemaining);
-        }
+        trimToTransferWindow(di, chunkSize, adviseWaitMs, bps);
 
         std::uint32_t totalBytesRead = 0;
 
@@ -716,9 +695,12 @@ namespace RCF {
         fileChunk.mFileIndex = di.mCurrentFile;
         fileChunk.mOffset = di.mCurrentPos;
         fileChunk.mData = byteBuffer;
+        if (request.mCompression == Fcc_Zlib)
+        {
+            fileChunk.compress();
+        }
         chunks.push_back(fileChunk);
 
-        totalBytesRead += (std::uint32_t) byteBuffer.getLength();
         diPtr->mCurrentPos += byteBuffer.getLength();
 
         // Close the file if we got to the end.
@@ -732,33 +714,11 @@ namespace RCF {
             di.mCurrentPos = 0;
         }
 
-        di.mTransferWindowBytesSoFar += totalBytesRead;
+        // Bandwidth is measured in bytes sent, so compressed chunks count for less.
+        di.mTransferWindowBytesSoFar += (std::uint32_t) fileChunk.mData.getLength();
 
         // If we got to the end of the file, clean up the download.
-        if (di.mCurrentFile == di.mManifest.mFiles.size())
-        {
-            RCF_LOG_3()(di.mCurrentFile) 
-                << "FileTransferService::DownloadChunks() - download completed.";
-
-            // TODO: this is broken if there is more than one FileStream.
-            if (diPtr->mSessionLocalId)
-            {
-                std::map<std::uint32_t, FileDownload> & downloads = 
-                    getTlsRcfSession().mSessionDownloads;
-
-                std::map<std::uint32_t, FileDownload>::iterator iter = 
-                    downloads.find(diPtr->mSessionLocalId);
-
-                RCF_ASSERT(iter != downloads.end());
-
-                downloads.erase(iter);
-            }
-            else if ( diPtr->mServerDownloadId.size() > 0 )
-            {
-                removeFileTransfer(diPtr->mServerDownloadId);
-            }
-            diPtr.reset();
-        }
+        checkForDownloadCompletion(diPtr);
 
         // Initiate read for next chunk.
         if (    diPtr.get()
@@ -801,6 +761,191 @@ namespace RCF {
             << "FileTransferService::DownloadChunks() - exit.";
     }
 
+    void FileTransferService::trimToTransferWindow(
+        FileDownloadInfo & di, 
+        std::uint32_t & chunkSize, 
+        std::uint32_t & adviseWaitMs, 
+        std::uint32_t & bps)
+    {
+        bps = di.mQuotaPtr->calculateLineSpeedLimit();
+
+        if (bps)
+        {
+            RCF_LOG_3()(bps)(mTransferWindowS)(di.mTransferWindowBytesTotal)(di.mTransferWindowBytesSoFar) 
+                << "FileTransferService::trimToTransferWindow() - checking throttle setting.";
+
+            if (di.mTransferWindowTimer.elapsed(mTransferWindowS*1000))
+            {
+                RCF_ASSERT(di.mTransferWindowBytesTotal >= di.mTransferWindowBytesSoFar);
+
+                std::uint32_t carryOver = 
+                    di.mTransferWindowBytesTotal - di.mTransferWindowBytesSoFar;
+
+                di.mTransferWindowTimer.restart();
+
+                di.mTransferWindowBytesTotal = bps * mTransferWindowS;
+                di.mTransferWindowBytesTotal += carryOver;
+
+                di.mTransferWindowBytesSoFar = 0;
+
+                RCF_LOG_3()(mTransferWindowS)(di.mTransferWindowBytesTotal)(di.mTransferWindowBytesSoFar)(carryOver) 
+                    << "FileTransferService::trimToTransferWindow() - new throttle transfer window.";
+            }
+
+            if (di.mTransferWindowBytesTotal == 0)
+            {
+                di.mTransferWindowBytesTotal = bps * mTransferWindowS;
+            }
+
+            std::uint32_t bytesWindowRemaining = 
+                di.mTransferWindowBytesTotal - di.mTransferWindowBytesSoFar;
+
+            if (bytesWindowRemaining < chunkSize)
+            {
+                std::uint32_t windowStartMs = di.mTransferWindowTimer.getStartTimeMs();
+                std::uint32_t windowEndMs = windowStartMs + 1000*mTransferWindowS;
+                std::uint32_t nowMs = getCurrentTimeMs();
+                if (nowMs < windowEndMs)
+                {
+                    adviseWaitMs = windowEndMs - nowMs;
+
+                    RCF_LOG_3()(adviseWaitMs) 
+                        << "FileTransferService::trimToTransferWindow() - advising client wait.";
+                }
+            }
+
+            RCF_LOG_3()(chunkSize)(bytesWindowRemaining)(di.mTransferWindowBytesTotal) 
+                << "FileTransferService::trimToTransferWindow() - trimming chunk size to transfer window.";
+
+            chunkSize = RCF_MIN(chunkSize, bytesWindowRemaining);
+        }
+    }
+
+    void FileTransferService::checkForDownloadCompletion(FileDownloadInfoPtr & diPtr)
+    {
+        FileDownloadInfo & di = *diPtr;
+
+        if (di.mCurrentFile == di.mManifest.mFiles.size())
+        {
+            RCF_LOG_3()(di.mCurrentFile) 
+                << "FileTransferService - download completed.";
+
+            // TODO: this is broken if there is more than one FileStream.
+            if (diPtr->mSessionLocalId)
+            {
+                std::map<std::uint32_t, FileDownload> & downloads = 
+                    getTlsRcfSession().mSessionDownloads;
+
+                std::map<std::uint32_t, FileDownload>::iterator iter = 
+                    downloads.find(diPtr->mSessionLocalId);
+
+                RCF_ASSERT(iter != downloads.end());
+
+                downloads.erase(iter);
+            }
+            else if ( diPtr->mServerDownloadId.size() > 0 )
+            {
+                removeFileTransfer(diPtr->mServerDownloadId);
+            }
+            diPtr.reset();
+        }
+    }
+
+    void FileTransferService::BeginDeltaDownload(
+        const FileSignature & signature)
+    {
+        RCF_LOG_3()(signature.mBlockSize)(signature.mFileSize) 
+            << "FileTransferService::BeginDeltaDownload() - entry.";
+
+        FileDownloadInfoPtr downloadInfoPtr = getTlsRcfSession().mDownloadInfoPtr;
+
+        if (!downloadInfoPtr || downloadInfoPtr->mCurrentFile >= downloadInfoPtr->mManifest.mFiles.size())
+        {
+            RCF_THROW( Exception(RcfError_NoDownload) );
+        }
+
+        FileDownloadInfo & di = * downloadInfoPtr;
+
+        // The delta rebuilds the whole of the current file.
+        const FileInfo & fileInfo = di.mManifest.mFiles[di.mCurrentFile];
+        Path filePath = di.mDownloadPath / fileInfo.mFilePath;
+
+        di.mFileHandle->close();
+        di.mCurrentPos = 0;
+        di.mDeltaEncoderPtr.reset( new FileDeltaEncoder(filePath, fileInfo.mFileSize, signature) );
+
+        RCF_LOG_3()(filePath.u8string()) << "FileTransferService::BeginDeltaDownload() - exit.";
+    }
+
+    void FileTransferService::DownloadDeltaChunks(
+        const FileTransferRequest & request,
+        std::vector<FileDeltaOp> & ops,
+        std::string & fileHash,
+        std::uint32_t & adviseWaitMs,
+        std::uint32_t & bps)
+    {
+        RCF_LOG_3()(request.mFile)(request.mPos)(request.mChunkSize) 
+            << "FileTransferService::DownloadDeltaChunks() - entry.";
+
+        FileDownloadInfoPtr & diPtr = getTlsRcfSession().mDownloadInfoPtr;
+
+        if (!diPtr || !diPtr->mDeltaEncoderPtr)
+        {
+            RCF_THROW( Exception(RcfError_NoDownload) );
+        }
+
+        FileDownloadInfo & di = *diPtr;
+
+        if (di.mCancel)
+        {
+            RCF_THROW( Exception(RcfError_DownloadCancelled) );
+        }
+
+        adviseWaitMs = 0;
+        ops.clear();
+        fileHash.clear();
+
+        FileDeltaEncoder & encoder = *di.mDeltaEncoderPtr;
+
+        if (request.mPos != encoder.getPos())
+        {
+            RCF_THROW( Exception(RcfError_FileOffset, encoder.getPos(), request.mPos) );
+        }
+
+        // Only literal data counts against the throttle settings.
+        std::uint32_t chunkSize = request.mChunkSize;
+        trimToTransferWindow(di, chunkSize, adviseWaitMs, bps);
+
+        bool done = encoder.encode(ops, chunkSize);
+
+        for (std::size_t i = 0; i < ops.size(); ++i)
+        {
+            di.mTransferWindowBytesSoFar += static_cast<std::uint32_t>(ops[i].mData.getLength());
+        }
+
+        di.mCurrentPos = encoder.getPos();
+
+        if (done)
+        {
+            fileHash = encoder.getFileHash();
+            di.mDeltaEncoderPtr.reset();
+            ++di.mCurrentFile;
+            di.mCurrentPos = 0;
+        }
+
+        // Progress notifications.
+        if (mDownloadProgressCb)
+        {
+            mDownloadProgressCb(getCurrentRcfSession(), di);
+        }
+
+        // If we got to the end of the file, clean up the download.
+        checkForDownloadCompletion(diPtr);
+
+        RCF_LOG_3()(ops.size())(done) 
+            << "FileTransferService::DownloadDeltaChunks() - exit.";
+    }
+
     void FileTransferService::onServerStart(RcfServer & server)
     {
         mUploadDirectory = server.getUploadDirectory();
@@ -830,10 +975,18 @@ namespace RCF {
 
     }
 
-    FileChunk::FileChunk() : mFileIndex(0), mOffset(0)
+    FileChunk::FileChunk() : 
+        mFileIndex(0), 
+        mOffset(0), 
+        mCompression(Fcc_None), 
+        mUncompressedLength(0)
     {}
 
-    FileTransferRequest::FileTransferRequest() : mFile(0), mPos(0), mChunkSize(0)
+    FileTransferRequest::FileTransferRequest() : 
+        mFile(0), 
+        mPos(0), 
+        mChunkSize(0), 
+        mCompression(Fcc_None)
     {}
 
 #if RCF_FEATURE_SF==1
@@ -870,11 +1023,25 @@ namespace RCF {
     void FileChunk::serialize(SF::Archive & ar)
     {
         ar & mFileIndex & mOffset & mData;
+
+        if (ar.getRuntimeVersion() >= 14)
+        {
+            ar & mCompression & mUncompressedLength;
+        }
+        else
+        {
+            RCF_ASSERT(mCompression == Fcc_None);
+        }
     }
 
     void FileTransferRequest::serialize(SF::Archive & ar)
     {
         ar & mFile & mPos & mChunkSize;
+
+        if (ar.getRuntimeVersion() >= 14)
+        {
+            ar & mCompression;
+        }
     }
 
 #endif
@@ -884,6 +1051,103 @@ namespace RCF {
         return mData.isEmpty();
     }
 
+    std::uint64_t FileChunk::getDataLength() const
+    {
+        return mCompression == Fcc_None ? mData.getLength() : mUncompressedLength;
+    }
+
+#if RCF_FEATURE_ZLIB==1
+
+    // Estimates the entropy of the data, in bits per byte, from the byte frequencies of a few samples spread 
+    // across it. Data that is already compressed or encrypted, comes out at close to 8.
+    static double estimateEntropy(const ByteBuffer & data)
+    {
+        const std::size_t SampleCount = 8;
+        const std::size_t SampleLength = 512;
+
+        const unsigned char * pch = reinterpret_cast<const unsigned char *>(data.getPtr());
+        std::size_t length = data.getLength();
+
+        std::uint32_t counts[256] = { 0 };
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < SampleCount && total < length; ++i)
+        {
+            std::size_t begin = length > SampleLength ? (length - SampleLength) / (SampleCount - 1) * i : 0;
+            std::size_t end = RCF_MIN(begin + SampleLength, length);
+            for (std::size_t j = begin; j < end; ++j)
+            {
+                ++counts[pch[j]];
+            }
+            total += end - begin;
+        }
+
+        double entropy = 0;
+        for (std::size_t i = 0; i < 256; ++i)
+        {
+            if (counts[i])
+            {
+                double p = double(counts[i]) / double(total);
+                entropy -= p * std::log2(p);
+            }
+        }
+        return entropy;
+    }
+
+#endif
+
+    void FileChunk::compress()
+    {
+
+#if RCF_FEATURE_ZLIB==1
+
+        // Small chunks, and chunks whose sample doesn't look compressible, are sent as they are.
+        const std::size_t   MinCompressLength   = 4*1024;
+        const double        MaxEntropy          = 7.5;
+
+        std::size_t length = mData.getLength();
+        if (mCompression != Fcc_None || length < MinCompressLength || estimateEntropy(mData) > MaxEntropy)
+        {
+            return;
+        }
+
+        // The compressed data has to be at least an eighth smaller, to be worth decompressing.
+        ByteBuffer compressed;
+        if (zlibCompress(mData, compressed, length - length / 8))
+        {
+            mData = compressed;
+            mCompression = Fcc_Zlib;
+            mUncompressedLength = static_cast<std::uint32_t>(length);
+        }
+
+#endif
+
+    }
+
+    void FileChunk::decompress()
+    {
+        if (mCompression == Fcc_None)
+        {
+            return;
+        }
+
+#if RCF_FEATURE_ZLIB==1
+
+        if (mCompression == Fcc_Zlib)
+        {
+            ByteBuffer data;
+            zlibDecompress(mData, data, mUncompressedLength);
+            mData = data;
+            mCompression = Fcc_None;
+            mUncompressedLength = 0;
+            return;
+        }
+
+#endif
+
+        Exception e("Unsupported file chunk compression.");
+        RCF_THROW(e);
+    }
+
     FileManifest::FileManifest() 
     {}
 
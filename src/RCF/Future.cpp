@@ -58,6 +58,10 @@ namespace RCF {
             mSzArity(szArity),
             mOwn(true)
     {
+        // Any continuations left over from a previous call are stale. This is only done when a call begins, 
+        // as init() also runs on the internal retries of a call, which keep the continuations of the call.
+        clientStub.mCompletionHandlers.clear();
+
         // TODO: put this in the initializer list instead?
         clientStub.init(fnId, rcs);
     }
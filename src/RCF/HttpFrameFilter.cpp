@@ -1061,12 +1061,15 @@ namespace RCF  {
 
         mOsPtr->rewind();
 
-        // Check if a message verifier is in place.
+        // Check if a message verifier is in place. Chunked responses don't carry the verification header, so 
+        // skip it for those. Publishers send each message as a chunked response to every HTTP subscriber, and 
+        // would otherwise hash the whole message once per subscriber.
         ClientStub* pStub = RCF::getTlsClientStubPtr();
         RCF::RcfSession* pSession = getCurrentRcfSessionPtr();
         std::string verifierHeaderName;
         std::string verifierHeaderValue;
         HttpMessageVerifierPtr verifierPtr;
+        bool chunkedResponse = mServerAddr.empty() && mChunkedResponseMode;
         if ( pStub )
         {
             verifierPtr = pStub->getHttpMessageVerifier();
@@ -1075,7 +1078,7 @@ namespace RCF  {
         {
             verifierPtr = pSession->getRcfServer().getHttpMessageVerifier();
         }
-        if ( verifierPtr )
+        if ( verifierPtr && !chunkedResponse )
         {
             verifierPtr->applyHeader(mWriteBuffers, verifierHeaderName, verifierHeaderValue);
         }
@@ -1134,7 +1137,10 @@ namespace RCF  {
             // Server-side response.
 
             char dateHeader[1000] = {};
-            makeHttpDateHeaderValue(dateHeader, sizeof(dateHeader));
+            if ( !mChunkedResponseMode || mChunkedResponseCounter == 0 )
+            {
+                makeHttpDateHeaderValue(dateHeader, sizeof(dateHeader));
+            }
 
             if ( mChunkedResponseMode && mChunkedResponseCounter == 0 )
             {
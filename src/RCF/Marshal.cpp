@@ -34,6 +34,7 @@
 #include <RCF/ServerTransport.hpp>
 #include <RCF/ThreadLocalData.hpp>
 #include <RCF/Log.hpp>
+#include <RCF/MessageFraming.hpp>
 
 namespace RCF {
 
@@ -113,6 +114,23 @@ namespace RCF {
         pFuture->setClientStub(this);
     }
 
+    void ClientStub::addCompletionHandler(std::function<void()> handler)
+    {
+        RCF_ASSERT(mSignalledMutexPtr);
+
+        {
+            Lock lock(*mSignalledMutexPtr);
+            if (!mSignalled)
+            {
+                mCompletionHandlers.push_back(handler);
+                return;
+            }
+        }
+
+        // Call has already completed.
+        handler();
+    }
+
     void ClientStub::init( 
         int fnId, 
         RCF::RemoteCallMode rcs)
@@ -130,6 +148,17 @@ namespace RCF {
             mEnableSfPointerTracking,
             mEnableNativeWstringSerialization);
 
+        // Binding IDs are only understood by servers with runtime version 12 or later, and are only valid
+        // on the connection they were assigned on. The header is encoded before connect(), which may yet
+        // reconnect, and a oneway call with a stale ID would fail without a response to retry on, so oneway 
+        // calls always send the binding name.
+        int bindingId = 0;
+        if (mEnableBindingIds && getRuntimeVersion() >= 12 && rcs == RCF::Twoway)
+        {
+            bindingId = (mConnected && mBindingId) ? mBindingId : BindingId_Request;
+        }
+        mRequest.setBindingId(bindingId);
+
         ::RCF::CurrentClientStubSentry sentry(*this);
 
         mOut.reset(
@@ -141,7 +170,7 @@ namespace RCF {
             mEnableSfPointerTracking);
 
         bool asyncParameters = false;
-        mpParameters->write(mOut);
+        mOut.writeParameters(*mpParameters, fnId, mEnableSizingPass);
         mFutures.clear();
         asyncParameters = mpParameters->enrolFutures(this);
 
@@ -176,6 +205,9 @@ namespace RCF {
 
         if (shouldReconnect)
         {
+            // Binding IDs don't carry over to a new connection.
+            mBindingId = 0;
+
             std::string endpoint;
             if (mEndpoint.get())
             {
@@ -341,16 +373,36 @@ namespace RCF {
             mAsyncOpType = Write;
         }
 
-        // Add framing (4 byte length prefix).
-        int messageSize = 
-            static_cast<int>(RCF::lengthByteBuffers(mEncodedByteBuffers));
+        TransportType transportType = getTransport().getTransportType();
+
+        bool chunkedFraming = 
+                mMessageChunkSize > 0
+            &&  !mBatchMode
+            &&  (   transportType == Tt_Tcp 
+                ||  transportType == Tt_UnixNamedPipe 
+                ||  transportType == Tt_Win32NamedPipe);
+
+        if (chunkedFraming)
+        {
+            ThreadLocalCached< std::vector<ByteBuffer> > tlcFrames;
+            std::vector<ByteBuffer> & frames = tlcFrames.get();
+            encodeChunkedFrames(frames, mEncodedByteBuffers, mMessageChunkSize);
+            mEncodedByteBuffers.swap(frames);
+            frames.resize(0);
+        }
+        else
+        {
+            // Add framing (4 byte length prefix).
+            int messageSize = 
+                static_cast<int>(RCF::lengthByteBuffers(mEncodedByteBuffers));
 
-        ByteBuffer &byteBuffer = mEncodedByteBuffers.front();
+            ByteBuffer &byteBuffer = mEncodedByteBuffers.front();
 
-        RCF_ASSERT(byteBuffer.getLeftMargin() >= 4);
-        byteBuffer.expandIntoLeftMargin(4);
-        memcpy(byteBuffer.getPtr(), &messageSize, 4);
-        RCF::machineToNetworkOrder(byteBuffer.getPtr(), 4, 1);
+            RCF_ASSERT(byteBuffer.getLeftMargin() >= 4);
+            byteBuffer.expandIntoLeftMargin(4);
+            memcpy(byteBuffer.getPtr(), &messageSize, 4);
+            RCF::machineToNetworkOrder(byteBuffer.getPtr(), 4, 1);
+        }
 
         if (mBatchMode)
         {
@@ -551,6 +603,49 @@ namespace RCF {
         }
     }
 
+    // Decodes a response that was received with chunked framing. On return, chunks holds the response body.
+    void ClientStub::decodeChunkedResponse(
+        std::vector<ByteBuffer> &       chunks,
+        MethodInvocationResponse &      response)
+    {
+        ByteBuffer unfilteredByteBuffer;
+
+        // The header normally fits in the first chunk, and the body is then read directly from the chunks.
+        const ByteBuffer & firstChunk = chunks.front();
+        if (firstChunk.getLength() > 0 && firstChunk.getPtr()[0] != Descriptor_FilteredPayload)
+        {
+            try
+            {
+                mRequest.decodeResponse(
+                    firstChunk,
+                    unfilteredByteBuffer,
+                    response,
+                    getMessageFilters());
+
+                chunks.front() = unfilteredByteBuffer;
+                return;
+            }
+            catch(const Exception &)
+            {
+                // Header extends past the first chunk.
+                response = MethodInvocationResponse();
+            }
+        }
+
+        // Filtered responses are decoded from a single buffer.
+        ByteBuffer message;
+        copyByteBuffers(chunks, message);
+
+        mRequest.decodeResponse(
+            message,
+            unfilteredByteBuffer,
+            response,
+            getMessageFilters());
+
+        chunks.resize(0);
+        chunks.push_back(unfilteredByteBuffer);
+    }
+
     void ClientStub::onReceiveCompleted()
     {
         if (mAsync)
@@ -562,20 +657,58 @@ namespace RCF {
 
         MethodInvocationResponse response;
 
-        mRequest.decodeResponse(
-            mEncodedByteBuffer,
-            unfilteredByteBuffer,
-            response,
-            getMessageFilters());
+        ThreadLocalCached< std::vector<ByteBuffer> > tlcReadChunks;
+        std::vector<ByteBuffer> & readChunks = tlcReadChunks.get();
+        getTransport().getReadChunks(readChunks);
+
+        if (readChunks.size() > 1)
+        {
+            decodeChunkedResponse(readChunks, response);
+        }
+        else
+        {
+            readChunks.resize(0);
+            mRequest.decodeResponse(
+                mEncodedByteBuffer,
+                unfilteredByteBuffer,
+                response,
+                getMessageFilters());
+        }
 
         mEncodedByteBuffer.clear();
 
-        mIn.reset(
-            unfilteredByteBuffer,
-            mOut.getSerializationProtocol(),
-            mRuntimeVersion,
-            mArchiveVersion,
-            response.getEnableSfPointerTracking());
+        if (mEnableBindingIds)
+        {
+            // Fall back to the binding name if the call fails, in case the binding ID is no longer valid.
+            bool failed = response.isException() || response.isError();
+            mBindingId = failed ? 0 : response.getBindingId();
+        }
+
+        if (readChunks.size() > 1)
+        {
+            mIn.reset(
+                readChunks,
+                mOut.getSerializationProtocol(),
+                mRuntimeVersion,
+                mArchiveVersion,
+                response.getEnableSfPointerTracking());
+        }
+        else
+        {
+            if (readChunks.size() == 1)
+            {
+                unfilteredByteBuffer = readChunks.front();
+            }
+
+            mIn.reset(
+                unfilteredByteBuffer,
+                mOut.getSerializationProtocol(),
+                mRuntimeVersion,
+                mArchiveVersion,
+                response.getEnableSfPointerTracking());
+        }
+
+        readChunks.resize(0);
 
         RCF_LOG_3()(this)(response) << "RcfClient - received response.";
 
@@ -599,7 +732,20 @@ namespace RCF {
                 }
             }
 
-            onException(*remoteExceptionUniquePtr);
+            if (    mRequest.getBindingId() > 0
+                &&  remoteExceptionUniquePtr->getErrorId() == RcfError_NoServerStub_Id
+                &&  getTries() == 0)
+            {
+                // The binding ID may be from a previous connection, so try again with the binding name.
+                setTries(1);
+
+                init(mRequest.getFnId(), mRcs);
+                beginCall();
+            }
+            else
+            {
+                onException(*remoteExceptionUniquePtr);
+            }
         }
         else if (response.isError())
         {
@@ -721,6 +867,27 @@ namespace RCF {
             mAsyncCallback = std::function<void()>();
         }
 
+        // Future<>::then() continuations run after the user callback, once the lock has been released.
+        if (!mCompletionHandlers.empty())
+        {
+            typedef std::vector< std::function<void()> > Handlers;
+            std::shared_ptr<Handlers> handlersPtr( new Handlers() );
+            handlersPtr->swap(mCompletionHandlers);
+
+            std::function<void()> asyncCb = cb;
+            cb = [asyncCb, handlersPtr]()
+            {
+                if (asyncCb)
+                {
+                    asyncCb();
+                }
+                for (std::size_t i=0; i<handlersPtr->size(); ++i)
+                {
+                    (*handlersPtr)[i]();
+                }
+            };
+        }
+
         getTlsAmiNotification().set(cb, mSignalledLockPtr, mSignalledMutexPtr);
     }
 
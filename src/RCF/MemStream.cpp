@@ -28,7 +28,12 @@ namespace RCF {
         char * buffer, 
         std::size_t bufferLen) : 
             mBuffer(buffer),
-            mBufferLen(bufferLen)
+            mBufferLen(bufferLen),
+            mpSource(NULL),
+            mpChunks(NULL),
+            mChunkIndex(0),
+            mChunkOffset(0),
+            mChunksLen(0)
     {   
         setg(mBuffer, mBuffer, mBuffer + mBufferLen);
     }   
@@ -37,11 +42,73 @@ namespace RCF {
     {
     }
 
-    void MemIstreamBuf::reset(char * buffer, std::size_t bufferLen)
+    void MemIstreamBuf::reset(char * buffer, std::size_t bufferLen, MemIstreamSource * pSource)
     {
         mBuffer = buffer;
         mBufferLen = bufferLen;
+        mpSource = pSource;
+        mpChunks = NULL;
         setg(mBuffer, mBuffer, mBuffer + mBufferLen);
+
+        if (mpSource)
+        {
+            // Only expose what has been filled in so far.
+            setg(mBuffer, mBuffer, mBuffer);
+            waitForData(mBuffer);
+        }
+    }
+
+    void MemIstreamBuf::reset(const std::vector<ByteBuffer> & chunks)
+    {
+        mpSource = NULL;
+        mpChunks = &chunks;
+        mChunksLen = lengthByteBuffers(chunks);
+        setChunk(0, 0, 0);
+    }
+
+    // Moves the get area to the given chunk. chunkOffset is the position of the chunk within the chain.
+    void MemIstreamBuf::setChunk(std::size_t chunkIndex, std::size_t chunkOffset, std::size_t posInChunk)
+    {
+        mChunkIndex = chunkIndex;
+        mChunkOffset = chunkOffset;
+
+        mBuffer = NULL;
+        mBufferLen = 0;
+        if (chunkIndex < mpChunks->size())
+        {
+            const ByteBuffer & chunk = (*mpChunks)[chunkIndex];
+            mBuffer = chunk.getPtr();
+            mBufferLen = chunk.getLength();
+        }
+
+        RCF_ASSERT(posInChunk <= mBufferLen);
+        setg(mBuffer, mBuffer + posInChunk, mBuffer + mBufferLen);
+    }
+
+    // Waits for the buffer to be filled up to pchRequired, and extends the get area over whatever has arrived.
+    char * MemIstreamBuf::waitForData(char * pchRequired)
+    {
+        char * pEnd = mBuffer + mBufferLen;
+        if (pchRequired > pEnd)
+        {
+            pchRequired = pEnd;
+        }
+
+        char * pAvailable = const_cast<char *>( mpSource->waitForData(pchRequired) );
+        if (pAvailable > pEnd)
+        {
+            pAvailable = pEnd;
+        }
+        if (pAvailable > egptr())
+        {
+            setg(mBuffer, gptr(), pAvailable);
+        }
+        if (pAvailable == pEnd)
+        {
+            // Fully received.
+            mpSource = NULL;
+        }
+        return egptr();
     }
 
     std::streambuf::int_type MemIstreamBuf::underflow()   
@@ -51,9 +118,37 @@ namespace RCF {
             return traits_type::to_int_type(*gptr());
         }
 
+        if (mpSource && waitForData(gptr() + 1) > gptr())
+        {
+            return traits_type::to_int_type(*gptr());
+        }
+
+        if (mpChunks)
+        {
+            while (mChunkIndex + 1 < mpChunks->size())
+            {
+                setChunk(mChunkIndex + 1, mChunkOffset + mBufferLen, 0);
+                if (gptr() < egptr())
+                {
+                    return traits_type::to_int_type(*gptr());
+                }
+            }
+        }
+
         return traits_type::eof();   
     }
 
+    // Lets readsome() continue into the following chunks.
+    std::streamsize MemIstreamBuf::showmanyc()
+    {
+        if (mpChunks)
+        {
+            std::size_t pos = mChunkOffset + (gptr() - eback());
+            return static_cast<std::streamsize>(mChunksLen - pos);
+        }
+        return 0;
+    }
+
     MemIstreamBuf::pos_type MemIstreamBuf::seekoff(
         MemIstreamBuf::off_type offset, 
         std::ios_base::seekdir dir,
@@ -61,6 +156,11 @@ namespace RCF {
     {
         RCF_UNUSED_VARIABLE(mode);
 
+        if (mpChunks)
+        {
+            return seekChunks(offset, dir);
+        }
+
         char * pBegin = mBuffer;
         char * pEnd = mBuffer + mBufferLen;
         
@@ -74,6 +174,20 @@ namespace RCF {
         }
 
         char * pNewPos = pBase + offset;
+
+        if (mpSource)
+        {
+            // Can't move past the data that has been received.
+            if (pNewPos > egptr())
+            {
+                pEnd = waitForData(pNewPos);
+            }
+            else
+            {
+                pEnd = egptr();
+            }
+        }
+
         if (pBegin <= pNewPos && pNewPos <= pEnd)
         {
             setg(pBegin, pNewPos, pEnd);
@@ -85,6 +199,48 @@ namespace RCF {
         }
     }
 
+    MemIstreamBuf::pos_type MemIstreamBuf::seekChunks(
+        MemIstreamBuf::off_type offset, 
+        std::ios_base::seekdir dir)
+    {
+        std::size_t pos = mChunkOffset + (gptr() - eback());
+
+        off_type newPos = 0;
+        switch(dir)
+        {
+            case std::ios::cur: newPos = static_cast<off_type>(pos) + offset; break;
+            case std::ios::beg: newPos = offset; break;
+            case std::ios::end: newPos = static_cast<off_type>(mChunksLen) + offset; break;
+            default: RCF_ASSERT_ALWAYS(""); break; 
+        }
+
+        if (newPos < 0 || newPos > static_cast<off_type>(mChunksLen))
+        {
+            return pos_type(-1);
+        }
+
+        std::size_t target = static_cast<std::size_t>(newPos);
+
+        // Seeks are mostly forward, so start from the current chunk where possible.
+        std::size_t chunkIndex = 0;
+        std::size_t chunkOffset = 0;
+        if (target >= mChunkOffset)
+        {
+            chunkIndex = mChunkIndex;
+            chunkOffset = mChunkOffset;
+        }
+
+        while (     chunkIndex + 1 < mpChunks->size() 
+                &&  target > chunkOffset + (*mpChunks)[chunkIndex].getLength())
+        {
+            chunkOffset += (*mpChunks)[chunkIndex].getLength();
+            ++chunkIndex;
+        }
+
+        setChunk(chunkIndex, chunkOffset, target - chunkOffset);
+        return pos_type(newPos);
+    }
+
     // MemOstreamBuf implementation
 
     MemOstreamBuf::MemOstreamBuf()
@@ -154,6 +310,70 @@ namespace RCF {
         }
     }
 
+    void MemOstreamBuf::reserve(std::size_t newCapacity)
+    {
+        if (newCapacity > mWriteBuffer.size())
+        {
+            std::size_t nextPos = pptr() - pbase();
+
+            mWriteBuffer.resize(newCapacity);
+
+            setp( 
+                &mWriteBuffer[0],
+                &mWriteBuffer[0] + mWriteBuffer.size());
+
+            pbump( static_cast<int>(nextPos) );
+        }
+    }
+
+    // CountingOstreamBuf implementation
+
+    CountingOstreamBuf::CountingOstreamBuf() : mCount(0)
+    {
+    }
+
+    std::size_t CountingOstreamBuf::getCount() const
+    {
+        return mCount;
+    }
+
+    void CountingOstreamBuf::resetCount()
+    {
+        mCount = 0;
+    }
+
+    std::streamsize CountingOstreamBuf::xsputn(const char * pch, std::streamsize count)
+    {
+        RCF_UNUSED_VARIABLE(pch);
+        mCount += static_cast<std::size_t>(count);
+        return count;
+    }
+
+    std::streambuf::int_type CountingOstreamBuf::overflow(std::streambuf::int_type ch)
+    {
+        if (ch == traits_type::eof())
+        {
+            return traits_type::eof();
+        }
+
+        ++mCount;
+        return ch;
+    }
+
+    CountingOstreamBuf::pos_type CountingOstreamBuf::seekoff(
+        CountingOstreamBuf::off_type offset, 
+        std::ios_base::seekdir dir,
+        std::ios_base::openmode mode)
+    {
+        RCF_UNUSED_VARIABLE(mode);
+
+        if (offset == 0 && dir == std::ios::cur)
+        {
+            return static_cast<pos_type>(mCount);
+        }
+        return pos_type(-1);
+    }
+
     // MemIstream
     MemIstream::MemIstream(const char * buffer, std::size_t bufferLen) :
         std::basic_istream<char>(new MemIstreamBuf(const_cast<char *>(buffer), bufferLen))
@@ -166,10 +386,16 @@ namespace RCF {
         delete mpBuf;
     }
 
-    void MemIstream::reset(const char * buffer, std::size_t bufferLen)
+    void MemIstream::reset(const char * buffer, std::size_t bufferLen, MemIstreamSource * pSource)
+    {
+        clear();
+        mpBuf->reset(const_cast<char *>(buffer), bufferLen, pSource);
+    }
+
+    void MemIstream::reset(const std::vector<ByteBuffer> & chunks)
     {
         clear();
-        mpBuf->reset(const_cast<char *>(buffer), bufferLen);
+        mpBuf->reset(chunks);
     }
 
     std::istream::pos_type MemIstream::getReadPos()
@@ -386,6 +612,29 @@ namespace RCF {
         return mpBuf->mWriteBuffer.capacity();
     }
 
+    void MemOstream::reserve(std::size_t newCapacity)
+    {
+        mpBuf->reserve(newCapacity);
+    }
+
+    // CountingOstream
+
+    CountingOstream::CountingOstream() :
+        std::basic_ostream<char>(NULL)
+    {
+        rdbuf(&mBuf);
+    }
+
+    std::size_t CountingOstream::getCount() const
+    {
+        return mBuf.getCount();
+    }
+
+    void CountingOstream::resetCount()
+    {
+        mBuf.resetCount();
+    }
+
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable: 4995) // 'sprintf': name was marked as #pragma deprecated
@@ -0,0 +1,81 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#include <RCF/MessageFraming.hpp>
+
+#include <cstring>
+
+#include <RCF/ByteOrdering.hpp>
+#include <RCF/Tools.hpp>
+
+namespace RCF {
+
+    void encodeChunkedFrames(
+        std::vector<ByteBuffer> &           frames,
+        const std::vector<ByteBuffer> &     message,
+        std::size_t                         chunkSize)
+    {
+        RCF_ASSERT(chunkSize > 0);
+        chunkSize = RCF_MAX(chunkSize, MinMessageChunkSize);
+        chunkSize = RCF_MIN(chunkSize, std::size_t(MaxFrameLength));
+
+        std::size_t messageLen = lengthByteBuffers(message);
+        std::size_t chunkCount = (messageLen + chunkSize - 1) / chunkSize;
+
+        // One length prefix for each chunk, and one for the terminating frame.
+        ByteBuffer prefixes( 4*(chunkCount + 1) );
+        memset(prefixes.getPtr(), 0, prefixes.getLength());
+
+        frames.resize(0);
+        for (std::size_t i=0; i<chunkCount; ++i)
+        {
+            std::size_t offset = i*chunkSize;
+            std::size_t len = RCF_MIN(chunkSize, messageLen - offset);
+
+            ByteBuffer prefix(prefixes, 4*i, 4);
+            std::uint32_t frameLen = static_cast<std::uint32_t>(len) | ChunkedFrameFlag;
+            memcpy(prefix.getPtr(), &frameLen, 4);
+            machineToNetworkOrder(prefix.getPtr(), 4, 1);
+            frames.push_back(prefix);
+
+            forEachByteBuffer(
+                [&](const ByteBuffer & byteBuffer) { frames.push_back(byteBuffer); }, 
+                message, 
+                offset, 
+                len);
+        }
+
+        frames.push_back( ByteBuffer(prefixes, 4*chunkCount, 4) );
+    }
+
+    bool isValidChunkedFrame(
+        std::uint32_t                       frameLength,
+        const std::vector<ByteBuffer> &     chunks)
+    {
+        // The terminating frame.
+        if ((frameLength & ChunkedFrameFlag) == 0)
+        {
+            return true;
+        }
+
+        // Empty frames are never sent, and a short one has to be the last one.
+        std::size_t chunkLen = frameLength & MaxFrameLength;
+        return chunkLen > 0 && (chunks.empty() || chunks.back().getLength() >= MinMessageChunkSize);
+    }
+
+} // namespace RCF
@@ -127,17 +127,34 @@ namespace RCF {
         bool                    enableSfPointerTracking,
         bool                    enableNativeWstringSerialization)
     {
-        mService                            = service;
-        mFnId                               = fnId;
-        mSerializationProtocol              = serializationProtocol;
-        mOneway                             = oneway;
-        mClose                              = close;
-        mRuntimeVersion                     = runtimeVersion;
-        mIgnoreRuntimeVersion               = ignoreRuntimeVersion;
-        mPingBackIntervalMs                 = pingBackIntervalMs;
-        mArchiveVersion                     = archiveVersion;
-        mEnableSfPointerTracking            = enableSfPointerTracking;
-        mEnableNativeWstringSerialization   = enableNativeWstringSerialization;
+        // Only the function ID and the oneway and close flags vary from call to call. If anything else
+        // has changed, the cached header fields need to be encoded again.
+        bool invariantsChanged = 
+                mService != service
+            ||  mSerializationProtocol != serializationProtocol
+            ||  mRuntimeVersion != static_cast<std::uint32_t>(runtimeVersion)
+            ||  mIgnoreRuntimeVersion != ignoreRuntimeVersion
+            ||  mPingBackIntervalMs != static_cast<int>(pingBackIntervalMs)
+            ||  mArchiveVersion != static_cast<std::uint32_t>(archiveVersion)
+            ||  mEnableSfPointerTracking != enableSfPointerTracking
+            ||  mEnableNativeWstringSerialization != enableNativeWstringSerialization;
+
+        if (invariantsChanged)
+        {
+            mService                            = service;
+            mSerializationProtocol              = serializationProtocol;
+            mRuntimeVersion                     = runtimeVersion;
+            mIgnoreRuntimeVersion               = ignoreRuntimeVersion;
+            mPingBackIntervalMs                 = pingBackIntervalMs;
+            mArchiveVersion                     = archiveVersion;
+            mEnableSfPointerTracking            = enableSfPointerTracking;
+            mEnableNativeWstringSerialization   = enableNativeWstringSerialization;
+            mHeaderCacheValid                   = false;
+        }
+
+        mFnId                                   = fnId;
+        mOneway                                 = oneway;
+        mClose                                  = close;
     }
 
     void MethodInvocationRequest::init(
@@ -145,6 +162,7 @@ namespace RCF {
     {
         mRuntimeVersion             = runtimeVersion;
         mOneway                     = true;
+        mHeaderCacheValid           = false;
     }
 
     void MethodInvocationRequest::init(
@@ -187,6 +205,31 @@ namespace RCF {
     void MethodInvocationRequest::setService(const std::string &service)
     {
         mService = service;
+        mHeaderCacheValid = false;
+    }
+
+    int MethodInvocationRequest::getBindingId() const
+    {
+        return mBindingId;
+    }
+
+    void MethodInvocationRequest::setBindingId(int bindingId)
+    {
+        if (bindingId != mBindingId)
+        {
+            mBindingId = bindingId;
+            mHeaderCacheValid = false;
+        }
+    }
+
+    const std::string & MethodInvocationRequest::getMessageKey() const
+    {
+        return mMessageKey;
+    }
+
+    void MethodInvocationRequest::setMessageKey(const std::string & messageKey)
+    {
+        mMessageKey = messageKey;
     }
 
     int MethodInvocationRequest::getPingBackIntervalMs()
@@ -228,18 +271,34 @@ namespace RCF {
         // For backwards compatibility.
         mEnableSfPointerTracking = true;
 
+        mHeaderCacheValid = false;
+
         SF::decodeInt(msgId, buffer, pos);
         RCF_VERIFY(msgId == Descriptor_Request, Exception(RcfError_Decoding));
         SF::decodeInt(messageVersion, buffer, pos);
             
-        if (messageVersion > 7)
+        if (messageVersion > 8)
         {
             return false;
         }
 
+        mMessageKey.clear();
+
         SF::decodeString(mService, buffer, pos);
         SF::decodeInt(tokenId, buffer, pos);
 
+        // The client may be asking for a binding ID, or referring to the binding by a previously assigned ID.
+        mBindingId = 0;
+        if (tokenId == BindingId_Request && mService.size() > 0)
+        {
+            mBindingId = rcfSessionPtr->getBindingId(mService);
+        }
+        else if (tokenId > 0)
+        {
+            mBindingId = tokenId;
+            rcfSessionPtr->getBindingName(mBindingId, mService);
+        }
+
         std::string subInterface; // Unused
         SF::decodeString(subInterface, buffer, pos);
 
@@ -309,8 +368,18 @@ namespace RCF {
             SF::decodeBool(mEnableSfPointerTracking, buffer, pos);
             SF::decodeByteBuffer(mOutOfBandRequest, buffer, pos);
         }
-            
-        RCF_UNUSED_VARIABLE(tokenId);
+        else if (messageVersion == 8)
+        {
+            SF::decodeInt(mRuntimeVersion, buffer, pos);
+            SF::decodeBool(ignoreRuntimeVersion, buffer, pos);
+            SF::decodeInt(mPingBackIntervalMs, buffer, pos);
+            SF::decodeInt(mArchiveVersion, buffer, pos);
+            SF::decodeByteBuffer(mRequestUserData, buffer, pos);
+            SF::decodeBool(mEnableNativeWstringSerialization, buffer, pos);
+            SF::decodeBool(mEnableSfPointerTracking, buffer, pos);
+            SF::decodeByteBuffer(mOutOfBandRequest, buffer, pos);
+            SF::decodeString(mMessageKey, buffer, pos);
+        }
 
         // Check runtime version.
         if (mRuntimeVersion > rcfServer.getRuntimeVersion())
@@ -371,6 +440,12 @@ namespace RCF {
             messageVersion = 3;
         }
 
+        // Binding IDs are only sent to clients that have asked for them.
+        if (messageVersion == 3 && mBindingId != 0)
+        {
+            messageVersion = 4;
+        }
+
         std::size_t pos = 0;
         static_assert(0 <= Descriptor_Response && Descriptor_Response < 255, "Invalid message descriptor.");
         SF::encodeInt(Descriptor_Response, *mVecPtr, pos);
@@ -392,6 +467,13 @@ namespace RCF {
             SF::encodeBool(enableSfPointerTracking, *mVecPtr, pos);
             SF::encodeByteBuffer(mOutOfBandResponse, *mVecPtr, pos);
         }
+        else if (messageVersion == 4)
+        {
+            SF::encodeByteBuffer(mResponseUserData, *mVecPtr, pos);
+            SF::encodeBool(enableSfPointerTracking, *mVecPtr, pos);
+            SF::encodeByteBuffer(mOutOfBandResponse, *mVecPtr, pos);
+            SF::encodeInt(mBindingId, *mVecPtr, pos);
+        }
 
         mVecPtr->resize(pos);
 
@@ -411,6 +493,48 @@ namespace RCF {
             mVecPtr.reset(new std::vector<char>(50));
         }
 
+        if (!mHeaderCacheValid)
+        {
+            encodeHeaderCache();
+        }
+
+        // Only the function ID, the oneway and close flags, and the message key, vary from call to call. 
+        // The rest of the header is copied from the cache.
+        std::vector<char> & vec = *mVecPtr;
+        vec.resize(mHeaderPrefix.size() + 12 + mHeaderSuffix.size() + 5 + mMessageKey.size());
+
+        std::size_t pos = mHeaderPrefix.size();
+        memcpy(&vec[0], &mHeaderPrefix[0], pos);
+
+        SF::encodeInt(mFnId, vec, pos);
+        SF::encodeInt(mSerializationProtocol, vec, pos);
+        SF::encodeBool(mOneway, vec, pos);
+        SF::encodeBool(mClose, vec, pos);
+
+        if (!mHeaderSuffix.empty())
+        {
+            memcpy(&vec[pos], &mHeaderSuffix[0], mHeaderSuffix.size());
+            pos += mHeaderSuffix.size();
+        }
+
+        // Message version 8.
+        if (mRuntimeVersion >= 14)
+        {
+            SF::encodeString(mMessageKey, vec, pos);
+        }
+
+        vec.resize(pos);
+
+        return ByteBuffer(mVecPtr);
+    }
+
+    void MethodInvocationRequest::invalidateHeaderCache()
+    {
+        mHeaderCacheValid = false;
+    }
+
+    void MethodInvocationRequest::encodeHeaderCache()
+    {
         int runtimeVersion = mRuntimeVersion;
         int messageVersion = 0;
 
@@ -442,85 +566,101 @@ namespace RCF {
         {
             messageVersion = 6;
         }
-        else
+        else if (runtimeVersion <= 13)
         {
             messageVersion = 7;
         }
+        else
+        {
+            messageVersion = 8;
+        }
 
+        mHeaderPrefix.resize(50);
         std::size_t pos = 0;
-        SF::encodeInt(Descriptor_Request, *mVecPtr, pos);
-        SF::encodeInt(messageVersion, *mVecPtr, pos);
-        SF::encodeString(mService, *mVecPtr, pos);
-        SF::encodeInt(0, *mVecPtr, pos);
+        SF::encodeInt(Descriptor_Request, mHeaderPrefix, pos);
+        SF::encodeInt(messageVersion, mHeaderPrefix, pos);
+        if (mBindingId > 0)
+        {
+            // The server already knows the binding name for this binding ID.
+            SF::encodeString(EmptyString, mHeaderPrefix, pos);
+        }
+        else
+        {
+            SF::encodeString(mService, mHeaderPrefix, pos);
+        }
+
+        // Legacy token ID field. Carries the binding ID, and is ignored by servers that don't support binding IDs.
+        SF::encodeInt(mBindingId, mHeaderPrefix, pos);
 
         // mSubInterface - unused
-        SF::encodeString(EmptyString, *mVecPtr, pos);
+        SF::encodeString(EmptyString, mHeaderPrefix, pos);
+
+        mHeaderPrefix.resize(pos);
 
-        SF::encodeInt(mFnId, *mVecPtr, pos);
-        SF::encodeInt(mSerializationProtocol, *mVecPtr, pos);
-        SF::encodeBool(mOneway, *mVecPtr, pos);
-        SF::encodeBool(mClose, *mVecPtr, pos);
+        mHeaderSuffix.resize(50);
+        pos = 0;
 
         if (messageVersion == 1)
         {
-            SF::encodeInt(mRuntimeVersion, *mVecPtr, pos);
-            SF::encodeBool(mIgnoreRuntimeVersion, *mVecPtr, pos);
+            SF::encodeInt(mRuntimeVersion, mHeaderSuffix, pos);
+            SF::encodeBool(mIgnoreRuntimeVersion, mHeaderSuffix, pos);
         }
         else if (messageVersion == 2)
         {
-            SF::encodeInt(mRuntimeVersion, *mVecPtr, pos);
-            SF::encodeBool(mIgnoreRuntimeVersion, *mVecPtr, pos);
-            SF::encodeInt(mPingBackIntervalMs, *mVecPtr, pos);
+            SF::encodeInt(mRuntimeVersion, mHeaderSuffix, pos);
+            SF::encodeBool(mIgnoreRuntimeVersion, mHeaderSuffix, pos);
+            SF::encodeInt(mPingBackIntervalMs, mHeaderSuffix, pos);
         }
         else if (messageVersion == 3)
         {
-            SF::encodeInt(mRuntimeVersion, *mVecPtr, pos);
-            SF::encodeBool(mIgnoreRuntimeVersion, *mVecPtr, pos);
-            SF::encodeInt(mPingBackIntervalMs, *mVecPtr, pos);
-            SF::encodeInt(mArchiveVersion, *mVecPtr, pos);
+            SF::encodeInt(mRuntimeVersion, mHeaderSuffix, pos);
+            SF::encodeBool(mIgnoreRuntimeVersion, mHeaderSuffix, pos);
+            SF::encodeInt(mPingBackIntervalMs, mHeaderSuffix, pos);
+            SF::encodeInt(mArchiveVersion, mHeaderSuffix, pos);
         }
         else if (messageVersion == 4)
         {
-            SF::encodeInt(mRuntimeVersion, *mVecPtr, pos);
-            SF::encodeBool(mIgnoreRuntimeVersion, *mVecPtr, pos);
-            SF::encodeInt(mPingBackIntervalMs, *mVecPtr, pos);
-            SF::encodeInt(mArchiveVersion, *mVecPtr, pos);
-            SF::encodeByteBuffer(mRequestUserData, *mVecPtr, pos);
+            SF::encodeInt(mRuntimeVersion, mHeaderSuffix, pos);
+            SF::encodeBool(mIgnoreRuntimeVersion, mHeaderSuffix, pos);
+            SF::encodeInt(mPingBackIntervalMs, mHeaderSuffix, pos);
+            SF::encodeInt(mArchiveVersion, mHeaderSuffix, pos);
+            SF::encodeByteBuffer(mRequestUserData, mHeaderSuffix, pos);
         }
         else if (messageVersion == 5)
         {
-            SF::encodeInt(mRuntimeVersion, *mVecPtr, pos);
-            SF::encodeBool(mIgnoreRuntimeVersion, *mVecPtr, pos);
-            SF::encodeInt(mPingBackIntervalMs, *mVecPtr, pos);
-            SF::encodeInt(mArchiveVersion, *mVecPtr, pos);
-            SF::encodeByteBuffer(mRequestUserData, *mVecPtr, pos);
-            SF::encodeBool(mEnableNativeWstringSerialization, *mVecPtr, pos);
+            SF::encodeInt(mRuntimeVersion, mHeaderSuffix, pos);
+            SF::encodeBool(mIgnoreRuntimeVersion, mHeaderSuffix, pos);
+            SF::encodeInt(mPingBackIntervalMs, mHeaderSuffix, pos);
+            SF::encodeInt(mArchiveVersion, mHeaderSuffix, pos);
+            SF::encodeByteBuffer(mRequestUserData, mHeaderSuffix, pos);
+            SF::encodeBool(mEnableNativeWstringSerialization, mHeaderSuffix, pos);
         }
         else if (messageVersion == 6)
         {
-            SF::encodeInt(mRuntimeVersion, *mVecPtr, pos);
-            SF::encodeBool(mIgnoreRuntimeVersion, *mVecPtr, pos);
-            SF::encodeInt(mPingBackIntervalMs, *mVecPtr, pos);
-            SF::encodeInt(mArchiveVersion, *mVecPtr, pos);
-            SF::encodeByteBuffer(mRequestUserData, *mVecPtr, pos);
-            SF::encodeBool(mEnableNativeWstringSerialization, *mVecPtr, pos);
-            SF::encodeBool(mEnableSfPointerTracking, *mVecPtr, pos);
+            SF::encodeInt(mRuntimeVersion, mHeaderSuffix, pos);
+            SF::encodeBool(mIgnoreRuntimeVersion, mHeaderSuffix, pos);
+            SF::encodeInt(mPingBackIntervalMs, mHeaderSuffix, pos);
+            SF::encodeInt(mArchiveVersion, mHeaderSuffix, pos);
+            SF::encodeByteBuffer(mRequestUserData, mHeaderSuffix, pos);
+            SF::encodeBool(mEnableNativeWstringSerialization, mHeaderSuffix, pos);
+            SF::encodeBool(mEnableSfPointerTracking, mHeaderSuffix, pos);
         }
-        else if (messageVersion == 7)
+        else if (messageVersion == 7 || messageVersion == 8)
         {
-            SF::encodeInt(mRuntimeVersion, *mVecPtr, pos);
-            SF::encodeBool(mIgnoreRuntimeVersion, *mVecPtr, pos);
-            SF::encodeInt(mPingBackIntervalMs, *mVecPtr, pos);
-            SF::encodeInt(mArchiveVersion, *mVecPtr, pos);
-            SF::encodeByteBuffer(mRequestUserData, *mVecPtr, pos);
-            SF::encodeBool(mEnableNativeWstringSerialization, *mVecPtr, pos);
-            SF::encodeBool(mEnableSfPointerTracking, *mVecPtr, pos);
-            SF::encodeByteBuffer(mOutOfBandRequest, *mVecPtr, pos);
+            // Message version 8 appends the message key, which isn't cached.
+            SF::encodeInt(mRuntimeVersion, mHeaderSuffix, pos);
+            SF::encodeBool(mIgnoreRuntimeVersion, mHeaderSuffix, pos);
+            SF::encodeInt(mPingBackIntervalMs, mHeaderSuffix, pos);
+            SF::encodeInt(mArchiveVersion, mHeaderSuffix, pos);
+            SF::encodeByteBuffer(mRequestUserData, mHeaderSuffix, pos);
+            SF::encodeBool(mEnableNativeWstringSerialization, mHeaderSuffix, pos);
+            SF::encodeBool(mEnableSfPointerTracking, mHeaderSuffix, pos);
+            SF::encodeByteBuffer(mOutOfBandRequest, mHeaderSuffix, pos);
         }
 
-        mVecPtr->resize(pos);
+        mHeaderSuffix.resize(pos);
 
-        return ByteBuffer(mVecPtr);
+        mHeaderCacheValid = true;
     }
 
     void MethodInvocationRequest::encodeRequest(
@@ -579,7 +719,7 @@ namespace RCF {
         else
         {
             RCF_VERIFY(msgId == Descriptor_Response, Exception(RcfError_Decoding));
-            RCF_VERIFY(ver <= 3, Exception(RcfError_Decoding));
+            RCF_VERIFY(ver <= 4, Exception(RcfError_Decoding));
 
             // For backwards compatibility.
             response.mEnableSfPointerTracking = true;
@@ -601,6 +741,13 @@ namespace RCF {
                 SF::decodeBool(response.mEnableSfPointerTracking, buffer, pos);
                 SF::decodeByteBuffer(mOutOfBandResponse, buffer, pos);
             }
+            else if (ver == 4)
+            {
+                SF::decodeByteBuffer(mResponseUserData, buffer, pos);
+                SF::decodeBool(response.mEnableSfPointerTracking, buffer, pos);
+                SF::decodeByteBuffer(mOutOfBandResponse, buffer, pos);
+                SF::decodeInt(response.mBindingId, buffer, pos);
+            }
 
             response.mError = false;
             response.mErrorCode = 0;
@@ -619,7 +766,12 @@ namespace RCF {
         RcfClientPtr stubEntryPtr;
         RcfSession * pRcfSession = getTlsRcfSessionPtr();
 
-        if (targetName.size() > 0)
+        if (mBindingId > 0)
+        {
+            // Resolved through the binding table of the session, without locking the stub map.
+            stubEntryPtr = pRcfSession->getBoundStubEntryPtr(mBindingId);
+        }
+        else if (targetName.size() > 0)
         {
             ReadLock readLock(rcfServer.mStubMapMutex);
             const std::string & servantName = getService();
@@ -647,7 +799,8 @@ namespace RCF {
         mErrorCode(),
         mArg0(),
         mArg1(),
-        mEnableSfPointerTracking(false)
+        mEnableSfPointerTracking(false),
+        mBindingId(0)
     {}
 
     bool MethodInvocationResponse::isException() const
@@ -685,6 +838,11 @@ namespace RCF {
         return mEnableSfPointerTracking;
     }
 
+    int MethodInvocationResponse::getBindingId() const
+    {
+        return mBindingId;
+    }
+
     //*******************************************
 
     void MethodInvocationRequest::encodeToMessage(
@@ -1078,6 +1236,10 @@ namespace RCF {
             msgPtr.reset( new OobRequestProxyConnection(msgVersion) );
             break;
 
+        case Omt_RequestRetransmit:
+            msgPtr.reset( new OobRequestRetransmit(msgVersion) );
+            break;
+
         default:
             RCF_THROW( Exception(RcfError_Decoding) );
         }
@@ -1178,18 +1340,23 @@ namespace RCF {
         OobMessage(runtimeVersion),
         mPublisherName(),
         mSubToPubPingIntervalMs(0),
-        mPubToSubPingIntervalMs(0)
+        mPubToSubPingIntervalMs(0),
+        mMulticastDelivery(false)
     {
     }
 
     OobRequestSubscription::OobRequestSubscription(
         int                     runtimeVersion,
         const std::string &     publisherName, 
-        std::uint32_t         subToPubPingIntervalMs) :
+        std::uint32_t         subToPubPingIntervalMs,
+        const SubscriptionFilter & filter,
+        bool                    multicastDelivery) :
             OobMessage(runtimeVersion),
             mPublisherName(publisherName),
             mSubToPubPingIntervalMs(subToPubPingIntervalMs),
-            mPubToSubPingIntervalMs(0)
+            mPubToSubPingIntervalMs(0),
+            mFilter(filter),
+            mMulticastDelivery(multicastDelivery)
     {
     }
 
@@ -1207,6 +1374,16 @@ namespace RCF {
         SF::encodeString(mPublisherName, *vecPtr, pos);
         SF::encodeInt(mSubToPubPingIntervalMs, *vecPtr, pos);
 
+        // The filter and the multicast flag are appended only if needed, and older publishers ignore them.
+        if (!mFilter.isEmpty() || mMulticastDelivery)
+        {
+            mFilter.encode(*vecPtr, pos);
+        }
+        if (mMulticastDelivery)
+        {
+            SF::encodeInt(1, *vecPtr, pos);
+        }
+
         vecPtr->resize(pos);
         buffer = ByteBuffer(vecPtr);
     }
@@ -1217,6 +1394,19 @@ namespace RCF {
     {
         SF::decodeString(mPublisherName, buffer, pos);
         SF::decodeInt(mSubToPubPingIntervalMs, buffer, pos);
+
+        if (pos < buffer.getLength())
+        {
+            mFilter.decode(buffer, pos);
+        }
+
+        mMulticastDelivery = false;
+        if (pos < buffer.getLength())
+        {
+            int multicastDelivery = 0;
+            SF::decodeInt(multicastDelivery, buffer, pos);
+            mMulticastDelivery = (multicastDelivery != 0);
+        }
     }
 
     void OobRequestSubscription::encodeResponse(ByteBuffer & buffer)
@@ -1226,6 +1416,10 @@ namespace RCF {
 
         encodeResponseCommon(vecPtr, pos);
         SF::encodeInt(mPubToSubPingIntervalMs, *vecPtr, pos);
+        if (mMulticastDelivery)
+        {
+            SF::encodeInt(1, *vecPtr, pos);
+        }
 
         vecPtr->resize(pos);
         buffer = ByteBuffer(vecPtr);
@@ -1236,6 +1430,128 @@ namespace RCF {
         std::size_t pos = 0;
         decodeResponseCommon(buffer, pos);
         SF::decodeInt(mPubToSubPingIntervalMs, buffer, pos);
+
+        mMulticastDelivery = false;
+        if (pos < buffer.getLength())
+        {
+            int multicastDelivery = 0;
+            SF::decodeInt(multicastDelivery, buffer, pos);
+            mMulticastDelivery = (multicastDelivery != 0);
+        }
+    }
+
+    // OobRequestRetransmit
+
+    static void encodeUint64(std::uint64_t value, std::vector<char> & vec, std::size_t & pos)
+    {
+        SF::encodeInt( static_cast<int>(value >> 32), vec, pos);
+        SF::encodeInt( static_cast<int>(value & 0xFFFFFFFF), vec, pos);
+    }
+
+    static void decodeUint64(std::uint64_t & value, const ByteBuffer & buffer, std::size_t & pos)
+    {
+        std::uint32_t hi = 0;
+        std::uint32_t lo = 0;
+        SF::decodeInt(hi, buffer, pos);
+        SF::decodeInt(lo, buffer, pos);
+        value = (std::uint64_t(hi) << 32) | lo;
+    }
+
+    OobRequestRetransmit::OobRequestRetransmit(int runtimeVersion) :
+        OobMessage(runtimeVersion),
+        mStreamId(0),
+        mFirstSeq(0),
+        mLastSeq(0),
+        mMaxResponseLength(0)
+    {
+    }
+
+    OobRequestRetransmit::OobRequestRetransmit(
+        int                     runtimeVersion,
+        const std::string &     publisherName,
+        std::uint64_t           streamId,
+        std::uint64_t           firstSeq,
+        std::uint64_t           lastSeq,
+        std::uint32_t           maxResponseLength) :
+            OobMessage(runtimeVersion),
+            mPublisherName(publisherName),
+            mStreamId(streamId),
+            mFirstSeq(firstSeq),
+            mLastSeq(lastSeq),
+            mMaxResponseLength(maxResponseLength)
+    {
+    }
+
+    OobMessageType OobRequestRetransmit::getMessageType()
+    {
+        return Omt_RequestRetransmit;
+    }
+
+    void OobRequestRetransmit::encodeRequest(ByteBuffer & buffer)
+    {
+        std::shared_ptr< std::vector<char> > vecPtr( new std::vector<char>(50) );
+        std::size_t pos = 0;
+        encodeRequestCommon(vecPtr, pos);
+
+        SF::encodeString(mPublisherName, *vecPtr, pos);
+        encodeUint64(mStreamId, *vecPtr, pos);
+        encodeUint64(mFirstSeq, *vecPtr, pos);
+        encodeUint64(mLastSeq, *vecPtr, pos);
+        SF::encodeInt(static_cast<int>(mMaxResponseLength), *vecPtr, pos);
+
+        vecPtr->resize(pos);
+        buffer = ByteBuffer(vecPtr);
+    }
+
+    void OobRequestRetransmit::decodeRequest(const ByteBuffer & buffer, std::size_t & pos)
+    {
+        SF::decodeString(mPublisherName, buffer, pos);
+        decodeUint64(mStreamId, buffer, pos);
+        decodeUint64(mFirstSeq, buffer, pos);
+        decodeUint64(mLastSeq, buffer, pos);
+        SF::decodeInt(mMaxResponseLength, buffer, pos);
+    }
+
+    void OobRequestRetransmit::encodeResponse(ByteBuffer & buffer)
+    {
+        std::size_t datagramsLen = lengthByteBuffers(mDatagrams);
+
+        std::shared_ptr< std::vector<char> > vecPtr( 
+            new std::vector<char>(50 + datagramsLen + 5*mDatagrams.size()) );
+
+        std::size_t pos = 0;
+
+        encodeResponseCommon(vecPtr, pos);
+        SF::encodeInt(static_cast<int>(mDatagrams.size()), *vecPtr, pos);
+        for (std::size_t i=0; i<mDatagrams.size(); ++i)
+        {
+            SF::encodeByteBuffer(mDatagrams[i], *vecPtr, pos);
+        }
+
+        vecPtr->resize(pos);
+        buffer = ByteBuffer(vecPtr);
+    }
+
+    void OobRequestRetransmit::decodeResponse(const ByteBuffer & buffer)
+    {
+        std::size_t pos = 0;
+        decodeResponseCommon(buffer, pos);
+
+        mDatagrams.clear();
+        if (mResponseError == RcfError_Ok_Id)
+        {
+            int datagramCount = 0;
+            SF::decodeInt(datagramCount, buffer, pos);
+            RCF_VERIFY(
+                0 <= datagramCount && static_cast<std::size_t>(datagramCount) <= buffer.getLength() - pos,
+                Exception(RcfError_Decoding));
+
+            mDatagrams.resize(datagramCount);
+            for (int i=0; i<datagramCount; ++i)
+            {
+                SF::decodeByteBuffer(mDatagrams[i], buffer, pos);
+            }
+        }
     }
 
 
@@ -18,10 +18,17 @@
 
 #include <RCF/MulticastClientTransport.hpp>
 
+#include <deque>
+#include <random>
+#include <set>
+#include <unordered_map>
+
+#include <RCF/ByteOrdering.hpp>
 #include <RCF/ClientStub.hpp>
 #include <RCF/Exception.hpp>
 #include <RCF/Future.hpp>
 #include <RCF/Globals.hpp>
+#include <RCF/PublishingService.hpp>
 #include <RCF/RcfClient.hpp>
 #include <RCF/RcfSession.hpp>
 #include <RCF/ServerTransport.hpp>
@@ -31,6 +38,89 @@
 
 namespace RCF {
 
+    MulticastTrailer::MulticastTrailer() :
+        mStreamId(0),
+        mSeq(0)
+    {
+    }
+
+    void MulticastTrailer::encode(std::vector<char> & vec) const
+    {
+        std::uint32_t magic = Magic;
+        std::uint64_t streamId = mStreamId;
+        std::uint64_t seq = mSeq;
+        std::uint32_t keyLen = static_cast<std::uint32_t>(mKey.size());
+
+        std::size_t pos = vec.size();
+        vec.resize(pos + FixedLength + mKey.size());
+        char * pch = &vec[pos];
+
+        machineToNetworkOrder(&magic, 4, 1);
+        machineToNetworkOrder(&streamId, 8, 1);
+        machineToNetworkOrder(&seq, 8, 1);
+        machineToNetworkOrder(&keyLen, 4, 1);
+
+        memcpy(pch, &magic, 4);
+        memcpy(pch + 4, &streamId, 8);
+        memcpy(pch + 12, &seq, 8);
+        memcpy(pch + 20, &keyLen, 4);
+        if (mKey.size() > 0)
+        {
+            memcpy(pch + FixedLength, mKey.c_str(), mKey.size());
+        }
+    }
+
+    bool MulticastTrailer::decode(const char * pDatagram, std::size_t datagramLen, std::size_t messageLen)
+    {
+        if (messageLen > datagramLen || datagramLen - messageLen < FixedLength)
+        {
+            return false;
+        }
+
+        const char * pch = pDatagram + messageLen;
+
+        std::uint32_t magic = 0;
+        std::uint32_t keyLen = 0;
+        memcpy(&magic, pch, 4);
+        memcpy(&mStreamId, pch + 4, 8);
+        memcpy(&mSeq, pch + 12, 8);
+        memcpy(&keyLen, pch + 20, 4);
+
+        networkToMachineOrder(&magic, 4, 1);
+        networkToMachineOrder(&mStreamId, 8, 1);
+        networkToMachineOrder(&mSeq, 8, 1);
+        networkToMachineOrder(&keyLen, 4, 1);
+
+        if (magic != Magic || keyLen != datagramLen - messageLen - FixedLength)
+        {
+            return false;
+        }
+
+        mKey.assign(pch + FixedLength, keyLen);
+        return true;
+    }
+
+    MulticastClientTransport::MulticastClientTransport() :
+        mQueueLimit(0),
+        mOverflowPolicy(Qop_DropOldest),
+        mDroppedCount(0),
+        mOverflowDisconnectCount(0),
+        mStreamId(0),
+        mNextSeq(1),
+        mHistoryLength(0),
+        mLastValueLimit(0),
+        mLastValueMaxBytes(0),
+        mLastValueBytes(0)
+    {
+    }
+
+    MulticastClientTransport::~MulticastClientTransport()
+    {
+        RCF_DTOR_BEGIN
+            close();
+        RCF_DTOR_END
+    }
+
     TransportType MulticastClientTransport::getTransportType()
     {
         return Tt_Unknown;
@@ -185,6 +275,277 @@ namespace RCF {
         std::string             mError;
     };
 
+    // Completion handler for the synchronous sends on the multicast group transport.
+    class GroupSendHandler : public ClientTransportCallback
+    {
+    public:
+
+        void onConnectCompleted(bool alreadyConnected = false)
+        {
+            RCF_UNUSED_VARIABLE(alreadyConnected);
+        }
+
+        void onSendCompleted()
+        {
+        }
+
+        void onReceiveCompleted()
+        {
+            RCF_ASSERT_ALWAYS("");
+        }
+
+        void onTimerExpired()
+        {
+            RCF_ASSERT_ALWAYS("");
+        }
+
+        void onError(const std::exception &e)
+        {
+            RCF_UNUSED_VARIABLE(e);
+        }
+    };
+
+    // Outbound queue of a subscriber, for non-blocking publishing. Messages are sent one at a time, with the 
+    // next send started from the completion of the previous one, on the server I/O threads.
+    //
+    // Completions run with the transport's completion mutex held, and lock the queue mutex. So the queue 
+    // mutex is never held while calling into the transport.
+    class SubscriberQueue : public ClientTransportCallback
+    {
+    public:
+
+        SubscriberQueue(
+            ClientTransportUniquePtrPtr     transportPtr, 
+            std::size_t                     queueLimit, 
+            QueueOverflowPolicy             policy) :
+                mTransportPtr(transportPtr),
+                mQueueLimit(queueLimit),
+                mPolicy(policy),
+                mFrontSeq(0),
+                mSending(false),
+                mFailed(false),
+                mClosed(false),
+                mSentCount(0),
+                mDroppedCount(0),
+                mConflatedCount(0)
+        {
+        }
+
+        // Returns false if the subscriber should be disconnected. Snapshot messages are queued regardless of the 
+        // queue limit.
+        bool push(const ByteBuffer & message, const std::string & conflationKey, bool snapshot = false)
+        {
+            {
+                Lock lock(mMutex);
+
+                if (mFailed || mClosed)
+                {
+                    return true;
+                }
+
+                if (mPolicy == Qop_Conflate && conflationKey.size() > 0)
+                {
+                    KeySeqs::iterator iter = mKeySeqs.find(conflationKey);
+                    if (iter != mKeySeqs.end())
+                    {
+                        mPending[iter->second - mFrontSeq].mMessage = message;
+                        ++mConflatedCount;
+                        return true;
+                    }
+                }
+
+                if (mPending.size() >= mQueueLimit && !snapshot)
+                {
+                    if (mPolicy == Qop_DropNewest)
+                    {
+                        ++mDroppedCount;
+                        return true;
+                    }
+                    else if (mPolicy == Qop_Disconnect)
+                    {
+                        ++mDroppedCount;
+                        return false;
+                    }
+
+                    popFront();
+                    ++mDroppedCount;
+                }
+
+                mPending.push_back( QueuedMessage() );
+                mPending.back().mMessage = message;
+                if (mPolicy == Qop_Conflate && conflationKey.size() > 0)
+                {
+                    mPending.back().mConflationKey = conflationKey;
+                    mKeySeqs[conflationKey] = mFrontSeq + mPending.size() - 1;
+                }
+
+                if (mSending)
+                {
+                    return true;
+                }
+                mSending = true;
+            }
+
+            sendNext();
+            return true;
+        }
+
+        // Discards queued messages and cancels any send in progress. No callbacks are made once this returns.
+        void close()
+        {
+            bool sending = false;
+            {
+                Lock lock(mMutex);
+                mClosed = true;
+                mPending.clear();
+                mKeySeqs.clear();
+                sending = mSending;
+            }
+
+            if (sending)
+            {
+                (*mTransportPtr)->cancel();
+            }
+        }
+
+        bool isFailed()
+        {
+            Lock lock(mMutex);
+            return mFailed || mClosed;
+        }
+
+        std::uint64_t getDroppedCount()
+        {
+            Lock lock(mMutex);
+            return mDroppedCount;
+        }
+
+        void getStats(SubscriberQueueStats & stats)
+        {
+            {
+                Lock lock(mMutex);
+                stats.mQueueDepth       = mPending.size();
+                stats.mSentCount        = mSentCount;
+                stats.mDroppedCount     = mDroppedCount;
+                stats.mConflatedCount   = mConflatedCount;
+            }
+
+            RcfSessionPtr rcfSessionPtr = (*mTransportPtr)->getRcfSession().lock();
+            if (rcfSessionPtr)
+            {
+                stats.mSubscriberAddress = rcfSessionPtr->getClientAddress().string();
+            }
+        }
+
+        void onConnectCompleted(bool alreadyConnected = false)
+        {
+            RCF_UNUSED_VARIABLE(alreadyConnected);
+            RCF_ASSERT_ALWAYS("");
+        }
+
+        void onSendCompleted()
+        {
+            {
+                Lock lock(mMutex);
+                ++mSentCount;
+            }
+            sendNext();
+        }
+
+        void onReceiveCompleted()
+        {
+            RCF_ASSERT_ALWAYS("");
+        }
+
+        void onTimerExpired()
+        {
+            RCF_ASSERT_ALWAYS("");
+        }
+
+        void onError(const std::exception &e)
+        {
+            Lock lock(mMutex);
+
+            if (!mClosed)
+            {
+                RCF_LOG_2()(e.what()) << "SubscriberQueue - send failed.";
+            }
+
+            mFailed = true;
+            mSending = false;
+            mPending.clear();
+            mKeySeqs.clear();
+        }
+
+    private:
+
+        // Starts sending the next queued message. Only called by the thread that set mSending.
+        void sendNext()
+        {
+            {
+                Lock lock(mMutex);
+                if (mFailed || mClosed || mPending.empty())
+                {
+                    mSending = false;
+                    return;
+                }
+
+                mSendBuffers.resize(1);
+                mSendBuffers[0] = mPending.front().mMessage;
+                popFront();
+            }
+
+            try
+            {
+                ClientTransport & transport = **mTransportPtr;
+                transport.setAsync(true);
+                transport.send(*this, mSendBuffers, 0);
+            }
+            catch (const Exception & e)
+            {
+                Exception err(RcfError_SyncPublishError, e.what());
+                onError(err);
+            }
+        }
+
+        void popFront()
+        {
+            const std::string & conflationKey = mPending.front().mConflationKey;
+            if (conflationKey.size() > 0)
+            {
+                mKeySeqs.erase(conflationKey);
+            }
+            mPending.pop_front();
+            ++mFrontSeq;
+        }
+
+        struct QueuedMessage
+        {
+            ByteBuffer      mMessage;
+            std::string     mConflationKey;
+        };
+
+        // Maps conflation keys to the sequence number of the queued message with that key.
+        typedef std::unordered_map<std::string, std::uint64_t> KeySeqs;
+
+        ClientTransportUniquePtrPtr     mTransportPtr;
+        const std::size_t               mQueueLimit;
+        const QueueOverflowPolicy       mPolicy;
+
+        Mutex                           mMutex;
+        std::deque<QueuedMessage>       mPending;
+        std::uint64_t                   mFrontSeq;
+        KeySeqs                         mKeySeqs;
+        std::vector<ByteBuffer>         mSendBuffers;
+        bool                            mSending;
+        bool                            mFailed;
+        bool                            mClosed;
+
+        std::uint64_t                   mSentCount;
+        std::uint64_t                   mDroppedCount;
+        std::uint64_t                   mConflatedCount;
+    };
+
     void MulticastClientTransport::doSendOnTransports(
         Lock&                           lock, 
         ClientTransportList&            transportList,
@@ -290,45 +651,101 @@ namespace RCF {
         mLastRequestSize = lengthByteBuffers(data);
         mRunningTotalBytesSent += mLastRequestSize;
 
-        bringInNewTransports();
+        bringInNewTransports(timeoutMs);
 
         Lock lock(mClientTransportsMutex);
 
-        std::size_t transportsInitial = mClientTransports.size();
+        std::string messageKey;
+        messageKey.swap(mMessageKey);
+
+        // The caller reuses its buffers once we return, so the queues and the last value cache share a single 
+        // copy of the message.
+        bool cacheMessage = mLastValueLimit > 0 && messageKey.size() > 0;
 
-        std::size_t MaxTransportsToSendOn = globals().getSimultaneousPublishLimit();
-        if (MaxTransportsToSendOn <= 0)
+        ByteBuffer message;
+        if (mQueueLimit > 0 || cacheMessage)
         {
-            MaxTransportsToSendOn = mClientTransports.size();
+            copyByteBuffers(data, message);
         }
 
-        mClientTransportsTemp.reserve(mClientTransports.size());
-        mClientTransportsTemp.resize(0);
+        if (cacheMessage)
+        {
+            updateLastValue(messageKey, message);
+        }
 
-        mClientTransportsSending.reserve(MaxTransportsToSendOn);
-        mClientTransportsSending.resize(0);
+        // Transports whose filter doesn't match the message key, and transports of subscribers receiving from 
+        // the multicast group, are set aside for the duration of the send.
+        bool filtering = 
+                (messageKey.size() > 0 && mSubscriberFilters.size() > 0)
+            ||  mMulticastSubscribers.size() > 0;
 
-        while (mClientTransports.size() > 0)
+        if (filtering)
         {
-            std::size_t count = RCF_MIN(MaxTransportsToSendOn, mClientTransports.size());
-            std::size_t pos = mClientTransports.size() - count;
-            mClientTransportsSending.assign(mClientTransports.begin() + pos, mClientTransports.end());
-            mClientTransports.resize(pos);
+            setAsideTransports(messageKey);
+        }
 
-            doSendOnTransports(lock, mClientTransportsSending, data, timeoutMs);
+        if (mGroupTransportPtr)
+        {
+            sendOnGroup(data, messageKey);
+        }
 
-            mClientTransportsTemp.insert(
-                mClientTransportsTemp.end(),
-                mClientTransportsSending.begin(),
-                mClientTransportsSending.end());
+        std::size_t transportsInitial = mClientTransports.size();
+
+        if (mQueueLimit > 0)
+        {
+            sendOnQueues(message, messageKey);
         }
+        else
+        {
+            std::size_t MaxTransportsToSendOn = globals().getSimultaneousPublishLimit();
+            if (MaxTransportsToSendOn <= 0)
+            {
+                MaxTransportsToSendOn = mClientTransports.size();
+            }
 
-        mClientTransports = mClientTransportsTemp;
+            mClientTransportsTemp.reserve(mClientTransports.size());
+            mClientTransportsTemp.resize(0);
 
-        clientStub.onSendCompleted();
+            mClientTransportsSending.reserve(MaxTransportsToSendOn);
+            mClientTransportsSending.resize(0);
+
+            while (mClientTransports.size() > 0)
+            {
+                std::size_t count = RCF_MIN(MaxTransportsToSendOn, mClientTransports.size());
+                std::size_t pos = mClientTransports.size() - count;
+                mClientTransportsSending.assign(mClientTransports.begin() + pos, mClientTransports.end());
+                mClientTransports.resize(pos);
+
+                doSendOnTransports(lock, mClientTransportsSending, data, timeoutMs);
+
+                mClientTransportsTemp.insert(
+                    mClientTransportsTemp.end(),
+                    mClientTransportsSending.begin(),
+                    mClientTransportsSending.end());
+            }
+
+            mClientTransports = mClientTransportsTemp;
+        }
 
         std::size_t transportsFinal = mClientTransports.size();
 
+        if (filtering)
+        {
+            mClientTransports.insert(
+                mClientTransports.end(),
+                mUnmatchedTransports.begin(),
+                mUnmatchedTransports.end());
+
+            mUnmatchedTransports.resize(0);
+        }
+
+        if (transportsFinal < transportsInitial)
+        {
+            removeStaleEntries();
+        }
+
+        clientStub.onSendCompleted();
+
         RCF_LOG_2()
             (lengthByteBuffers(data))(transportsInitial)(transportsFinal)
             << "MulticastClientTransport::send() - exit.";
@@ -336,6 +753,533 @@ namespace RCF {
         return 1;
     }
 
+    SubscriberQueuePtr & MulticastClientTransport::getSubscriberQueue(
+        const ClientTransportUniquePtrPtr & transportPtr)
+    {
+        SubscriberQueuePtr & queuePtr = mSubscriberQueues[ transportPtr.get() ];
+        if (!queuePtr)
+        {
+            queuePtr.reset( new SubscriberQueue(transportPtr, mQueueLimit, mOverflowPolicy) );
+        }
+        return queuePtr;
+    }
+
+    void MulticastClientTransport::sendOnQueues(
+        const ByteBuffer &                  message, 
+        const std::string &                 messageKey)
+    {
+        bool needToRemove = false;
+        for (std::size_t i=0; i<mClientTransports.size(); ++i)
+        {
+            SubscriberQueuePtr & queuePtr = getSubscriberQueue(mClientTransports[i]);
+
+            bool keep = queuePtr->push(message, messageKey);
+            if (!keep)
+            {
+                ++mOverflowDisconnectCount;
+
+                RcfSessionPtr rcfSessionPtr = (*mClientTransports[i])->getRcfSession().lock();
+                if (rcfSessionPtr)
+                {
+                    RCF_LOG_2()(rcfSessionPtr->getClientAddress().string()) 
+                        << "Dropping subscription. Subscriber queue is full.";
+
+                    rcfSessionPtr->disconnect();
+                }
+            }
+
+            if (!keep || queuePtr->isFailed())
+            {
+                mClientTransports[i].reset();
+                needToRemove = true;
+            }
+        }
+
+        if (needToRemove)
+        {
+            eraseRemove(mClientTransports, ClientTransportUniquePtrPtr());
+        }
+    }
+
+    // Closes the queues and removes the filters of transports that are no longer in the transport list.
+    // Sends the message once to the multicast group, with a trailer, and keeps the datagram for retransmission.
+    void MulticastClientTransport::sendOnGroup(
+        const std::vector<ByteBuffer> &     data, 
+        const std::string &                 messageKey)
+    {
+        MulticastTrailer trailer;
+        trailer.mStreamId = mStreamId;
+        trailer.mSeq = mNextSeq;
+        trailer.mKey = messageKey;
+
+        std::shared_ptr< std::vector<char> > vecPtr( new std::vector<char>(lengthByteBuffers(data)) );
+        copyByteBuffers(data, &(*vecPtr)[0]);
+        trailer.encode(*vecPtr);
+        ByteBuffer datagram(vecPtr);
+
+        try
+        {
+            GroupSendHandler handler;
+            if (!mGroupTransportPtr->isConnected())
+            {
+                mGroupTransportPtr->connect(handler, 0);
+            }
+
+            std::vector<ByteBuffer> datagramBuffers(1, datagram);
+            mGroupTransportPtr->send(handler, datagramBuffers, 0);
+        }
+        catch (const Exception & e)
+        {
+            // Typically a message too large for a datagram. Subscribers see a gap in the sequence numbers, and 
+            // can still request the datagram from the history.
+            RCF_LOG_2()(e.getErrorMessage())(trailer.mSeq)
+                << "MulticastClientTransport::sendOnGroup() - failed to send datagram to multicast group.";
+        }
+
+        Lock lock(mHistoryMutex);
+        mHistory.push_back(datagram);
+        ++mNextSeq;
+        while (mHistory.size() > mHistoryLength)
+        {
+            mHistory.pop_front();
+        }
+    }
+
+    void MulticastClientTransport::removeStaleEntries()
+    {
+        if (mSubscriberQueues.empty() && mSubscriberFilters.empty() && mMulticastSubscribers.empty())
+        {
+            return;
+        }
+
+        std::set<ClientTransportUniquePtr *> current;
+        for (std::size_t i=0; i<mClientTransports.size(); ++i)
+        {
+            current.insert(mClientTransports[i].get());
+        }
+
+        SubscriberQueues::iterator iter = mSubscriberQueues.begin();
+        while (iter != mSubscriberQueues.end())
+        {
+            if (current.find(iter->first) == current.end())
+            {
+                iter->second->close();
+                mDroppedCount += iter->second->getDroppedCount();
+                mSubscriberQueues.erase(iter++);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+
+        TransportPtrs staleFilters;
+        SubscriberFilters::iterator filterIter;
+        for (filterIter = mSubscriberFilters.begin(); filterIter != mSubscriberFilters.end(); ++filterIter)
+        {
+            if (current.find(filterIter->first) == current.end())
+            {
+                staleFilters.push_back(filterIter->first);
+            }
+        }
+
+        for (std::size_t i=0; i<staleFilters.size(); ++i)
+        {
+            removeSubscriberFilter(staleFilters[i]);
+        }
+
+        std::unordered_set<ClientTransportUniquePtr *>::iterator multicastIter = mMulticastSubscribers.begin();
+        while (multicastIter != mMulticastSubscribers.end())
+        {
+            if (current.find(*multicastIter) == current.end())
+            {
+                multicastIter = mMulticastSubscribers.erase(multicastIter);
+            }
+            else
+            {
+                ++multicastIter;
+            }
+        }
+    }
+
+    void MulticastClientTransport::addSubscriberFilter(
+        ClientTransportUniquePtr *          pTransport, 
+        const SubscriptionFilter &          filter)
+    {
+        if (filter.isEmpty())
+        {
+            return;
+        }
+
+        mSubscriberFilters[pTransport] = filter;
+
+        const std::set<std::string> & keys = filter.getKeys();
+        std::set<std::string>::const_iterator iter;
+        for (iter = keys.begin(); iter != keys.end(); ++iter)
+        {
+            mSubscriberKeyIndex[*iter].push_back(pTransport);
+        }
+
+        if (filter.getKeyRanges().size() > 0)
+        {
+            mRangeFilteredTransports.push_back(pTransport);
+        }
+    }
+
+    void MulticastClientTransport::removeSubscriberFilter(ClientTransportUniquePtr * pTransport)
+    {
+        SubscriberFilters::iterator filterIter = mSubscriberFilters.find(pTransport);
+        if (filterIter == mSubscriberFilters.end())
+        {
+            return;
+        }
+
+        const std::set<std::string> & keys = filterIter->second.getKeys();
+        std::set<std::string>::const_iterator iter;
+        for (iter = keys.begin(); iter != keys.end(); ++iter)
+        {
+            SubscriberKeyIndex::iterator indexIter = mSubscriberKeyIndex.find(*iter);
+            RCF_ASSERT(indexIter != mSubscriberKeyIndex.end());
+            eraseRemove(indexIter->second, pTransport);
+            if (indexIter->second.empty())
+            {
+                mSubscriberKeyIndex.erase(indexIter);
+            }
+        }
+
+        if (filterIter->second.getKeyRanges().size() > 0)
+        {
+            eraseRemove(mRangeFilteredTransports, pTransport);
+        }
+
+        mSubscriberFilters.erase(filterIter);
+    }
+
+    // Moves the transports that shouldn't receive the message, from mClientTransports to mUnmatchedTransports. 
+    // Those are transports whose filter doesn't match the message key, and transports of subscribers receiving 
+    // from the multicast group.
+    void MulticastClientTransport::setAsideTransports(const std::string & messageKey)
+    {
+        mMatchedTransports.clear();
+
+        bool applyFilters = messageKey.size() > 0 && mSubscriberFilters.size() > 0;
+        if (applyFilters)
+        {
+            SubscriberKeyIndex::iterator indexIter = mSubscriberKeyIndex.find(messageKey);
+            if (indexIter != mSubscriberKeyIndex.end())
+            {
+                mMatchedTransports.insert(indexIter->second.begin(), indexIter->second.end());
+            }
+
+            for (std::size_t i=0; i<mRangeFilteredTransports.size(); ++i)
+            {
+                ClientTransportUniquePtr * pTransport = mRangeFilteredTransports[i];
+                if (mSubscriberFilters[pTransport].matches(messageKey))
+                {
+                    mMatchedTransports.insert(pTransport);
+                }
+            }
+        }
+
+        mUnmatchedTransports.resize(0);
+
+        std::size_t matchedCount = 0;
+        for (std::size_t i=0; i<mClientTransports.size(); ++i)
+        {
+            ClientTransportUniquePtr * pTransport = mClientTransports[i].get();
+            bool matched = 
+                    !applyFilters
+                ||  mSubscriberFilters.find(pTransport) == mSubscriberFilters.end()
+                ||  mMatchedTransports.find(pTransport) != mMatchedTransports.end();
+
+            if (matched && mMulticastSubscribers.size() > 0)
+            {
+                matched = mMulticastSubscribers.find(pTransport) == mMulticastSubscribers.end();
+            }
+
+            if (matched)
+            {
+                mClientTransports[matchedCount++] = mClientTransports[i];
+            }
+            else
+            {
+                mUnmatchedTransports.push_back(mClientTransports[i]);
+            }
+        }
+        mClientTransports.resize(matchedCount);
+    }
+
+    void MulticastClientTransport::setQueueLimit(std::size_t queueLimit, QueueOverflowPolicy policy)
+    {
+        Lock lock(mClientTransportsMutex);
+        mQueueLimit = queueLimit;
+        mOverflowPolicy = policy;
+    }
+
+    void MulticastClientTransport::setMessageKey(const std::string & messageKey)
+    {
+        Lock lock(mClientTransportsMutex);
+        mMessageKey = messageKey;
+    }
+
+    void MulticastClientTransport::getQueueStats(std::vector<SubscriberQueueStats> & stats)
+    {
+        Lock lock(mClientTransportsMutex);
+
+        stats.resize(0);
+        for (std::size_t i=0; i<mClientTransports.size(); ++i)
+        {
+            SubscriberQueues::iterator iter = mSubscriberQueues.find(mClientTransports[i].get());
+            if (iter != mSubscriberQueues.end())
+            {
+                stats.push_back( SubscriberQueueStats() );
+                iter->second->getStats(stats.back());
+            }
+        }
+    }
+
+    std::uint64_t MulticastClientTransport::getDroppedCount()
+    {
+        Lock lock(mClientTransportsMutex);
+
+        std::uint64_t droppedCount = mDroppedCount;
+        SubscriberQueues::iterator iter;
+        for (iter = mSubscriberQueues.begin(); iter != mSubscriberQueues.end(); ++iter)
+        {
+            droppedCount += iter->second->getDroppedCount();
+        }
+        return droppedCount;
+    }
+
+    std::uint64_t MulticastClientTransport::getOverflowDisconnectCount()
+    {
+        Lock lock(mClientTransportsMutex);
+        return mOverflowDisconnectCount;
+    }
+
+    void MulticastClientTransport::setMulticastGroup(
+        ClientTransportUniquePtr    groupTransportPtr, 
+        std::size_t                 historyLength)
+    {
+        Lock lock(mClientTransportsMutex);
+
+        mGroupTransportPtr = std::move(groupTransportPtr);
+
+        // Lets subscribers tell a restarted publisher apart from a gap in the sequence numbers.
+        std::random_device rd;
+        std::mt19937_64 gen( (std::uint64_t(rd()) << 32) ^ rd() ^ getCurrentTimeMs() );
+        mStreamId = gen();
+        mNextSeq = 1;
+
+        Lock historyLock(mHistoryMutex);
+        mHistory.clear();
+        mHistoryLength = historyLength;
+    }
+
+    bool MulticastClientTransport::hasMulticastGroup()
+    {
+        Lock lock(mClientTransportsMutex);
+        return mGroupTransportPtr.get() != NULL;
+    }
+
+    void MulticastClientTransport::getMulticastDatagrams(
+        std::uint64_t                   streamId,
+        std::uint64_t                   firstSeq,
+        std::uint64_t                   lastSeq,
+        std::vector<ByteBuffer> &       datagrams)
+    {
+        datagrams.resize(0);
+
+        Lock lock(mHistoryMutex);
+
+        // The history holds the datagrams preceding mNextSeq.
+        std::uint64_t nextSeq = mNextSeq;
+        std::uint64_t historyFirstSeq = nextSeq - mHistory.size();
+
+        if (streamId != mStreamId || lastSeq < firstSeq)
+        {
+            return;
+        }
+
+        firstSeq = RCF_MAX(firstSeq, historyFirstSeq);
+        lastSeq = RCF_MIN(lastSeq, nextSeq - 1);
+        for (std::uint64_t seq = firstSeq; seq <= lastSeq; ++seq)
+        {
+            datagrams.push_back( mHistory[static_cast<std::size_t>(seq - historyFirstSeq)] );
+        }
+    }
+
+    void MulticastClientTransport::setLastValueCacheLimit(std::size_t maxKeys, std::size_t maxBytes)
+    {
+        Lock lock(mClientTransportsMutex);
+        mLastValueLimit = maxKeys;
+        mLastValueMaxBytes = maxBytes;
+        if (mLastValueLimit == 0)
+        {
+            mLastValues.clear();
+            mLastValueIndex.clear();
+            mLastValueBytes = 0;
+        }
+    }
+
+    void MulticastClientTransport::removeLastValue(const std::string & messageKey)
+    {
+        Lock lock(mClientTransportsMutex);
+        LastValueIndex::iterator iter = mLastValueIndex.find(messageKey);
+        if (iter != mLastValueIndex.end())
+        {
+            mLastValueBytes -= iter->second->mKey.size() + iter->second->mMessage.getLength();
+            mLastValues.erase(iter->second);
+            mLastValueIndex.erase(iter);
+        }
+    }
+
+    std::size_t MulticastClientTransport::getLastValueCount()
+    {
+        Lock lock(mClientTransportsMutex);
+        return mLastValues.size();
+    }
+
+    void MulticastClientTransport::updateLastValue(const std::string & messageKey, const ByteBuffer & message)
+    {
+        LastValueIndex::iterator iter = mLastValueIndex.find(messageKey);
+        if (iter != mLastValueIndex.end())
+        {
+            LastValues::iterator valueIter = iter->second;
+            mLastValueBytes -= valueIter->mMessage.getLength();
+            valueIter->mMessage = message;
+            mLastValues.splice(mLastValues.end(), mLastValues, valueIter);
+        }
+        else
+        {
+            mLastValues.push_back( LastValue() );
+            mLastValues.back().mKey = messageKey;
+            mLastValues.back().mMessage = message;
+            mLastValueIndex[messageKey] = --mLastValues.end();
+            mLastValueBytes += messageKey.size();
+        }
+        mLastValueBytes += message.getLength();
+
+        while (
+                mLastValues.size() > 0
+            &&  (       mLastValues.size() > mLastValueLimit 
+                    ||  (mLastValueMaxBytes > 0 && mLastValueBytes > mLastValueMaxBytes)))
+        {
+            LastValue & oldest = mLastValues.front();
+            mLastValueBytes -= oldest.mKey.size() + oldest.mMessage.getLength();
+            mLastValueIndex.erase(oldest.mKey);
+            mLastValues.pop_front();
+        }
+    }
+
+    // Sends each new transport the cached messages matching its filter, oldest first. With subscriber queues the 
+    // messages are queued, otherwise they are sent before returning, and transports they can't be sent to are 
+    // reset.
+    void MulticastClientTransport::sendSnapshots(
+        Lock &                                  lock,
+        ClientTransportList &                   transports,
+        const std::vector<SubscriptionFilter> & filters,
+        const std::vector<bool> &               multicastFlags,
+        unsigned int                            timeoutMs)
+    {
+        std::vector<const LastValue *> matches;
+        std::vector<ByteBuffer> buffers;
+
+        // Unfiltered transports are all sent the full snapshot, at the same time.
+        std::vector<ByteBuffer> fullBuffers;
+        ClientTransportList unfiltered;
+
+        for (std::size_t i=0; i<transports.size(); ++i)
+        {
+            // Messages from the multicast group and from the snapshot are received on different connections, so a 
+            // cached message could overtake a newer one. Subscribers receiving from the group don't get a snapshot.
+            if (multicastFlags[i])
+            {
+                continue;
+            }
+
+            bool filtered = !filters[i].isEmpty();
+
+            matches.resize(0);
+            LastValues::const_iterator iter;
+            for (iter = mLastValues.begin(); iter != mLastValues.end(); ++iter)
+            {
+                if (!filtered || filters[i].matches(iter->mKey))
+                {
+                    matches.push_back(&*iter);
+                }
+            }
+
+            if (matches.empty())
+            {
+                continue;
+            }
+
+            if (mQueueLimit > 0)
+            {
+                SubscriberQueuePtr & queuePtr = getSubscriberQueue(transports[i]);
+                for (std::size_t j=0; j<matches.size(); ++j)
+                {
+                    queuePtr->push(matches[j]->mMessage, matches[j]->mKey, true);
+                }
+            }
+            else if (filtered)
+            {
+                buffers.resize(0);
+                for (std::size_t j=0; j<matches.size(); ++j)
+                {
+                    buffers.push_back(matches[j]->mMessage);
+                }
+
+                ClientTransportList single(1, transports[i]);
+                doSendOnTransports(lock, single, buffers, timeoutMs);
+                if (single.empty())
+                {
+                    transports[i].reset();
+                }
+            }
+            else
+            {
+                if (fullBuffers.empty())
+                {
+                    for (std::size_t j=0; j<matches.size(); ++j)
+                    {
+                        fullBuffers.push_back(matches[j]->mMessage);
+                    }
+                }
+                unfiltered.push_back(transports[i]);
+            }
+        }
+
+        if (unfiltered.size() > 0)
+        {
+            std::set<ClientTransportUniquePtr *> failed;
+            for (std::size_t i=0; i<unfiltered.size(); ++i)
+            {
+                failed.insert(unfiltered[i].get());
+            }
+
+            // Removes the transports with errors from the list.
+            doSendOnTransports(lock, unfiltered, fullBuffers, timeoutMs);
+
+            for (std::size_t i=0; i<unfiltered.size(); ++i)
+            {
+                failed.erase(unfiltered[i].get());
+            }
+
+            for (std::size_t i=0; i<transports.size(); ++i)
+            {
+                if (transports[i] && failed.find(transports[i].get()) != failed.end())
+                {
+                    transports[i].reset();
+                }
+            }
+        }
+
+        RCF_LOG_2()(transports.size())(mLastValues.size()) 
+            << "MulticastClientTransport::sendSnapshots()";
+    }
+
     int MulticastClientTransport::receive(
         ClientTransportCallback &clientStub,
         ByteBuffer &byteBuffer,
@@ -366,7 +1310,9 @@ namespace RCF {
     }
 
     void MulticastClientTransport::addTransport(
-        ClientTransportUniquePtr clientTransportUniquePtr)
+        ClientTransportUniquePtr        clientTransportUniquePtr,
+        const SubscriptionFilter &      filter,
+        bool                            multicastDelivery)
     {
         Lock lock(mAddedClientTransportsMutex);
 
@@ -374,23 +1320,53 @@ namespace RCF {
 
         mAddedClientTransports.push_back( ClientTransportUniquePtrPtr( 
             new ClientTransportUniquePtr(std::move(clientTransportUniquePtr)) ) );
+
+        mAddedFilters.push_back(filter);
+        mAddedMulticastFlags.push_back(multicastDelivery);
     }
 
-    void MulticastClientTransport::bringInNewTransports()
+    void MulticastClientTransport::bringInNewTransports(unsigned int timeoutMs)
     {
         ClientTransportList addedClientTransports;
+        std::vector<SubscriptionFilter> addedFilters;
+        std::vector<bool> addedMulticastFlags;
 
         {
             Lock lock(mAddedClientTransportsMutex);
             addedClientTransports.swap(mAddedClientTransports);
+            addedFilters.swap(mAddedFilters);
+            addedMulticastFlags.swap(mAddedMulticastFlags);
+        }
+
+        if (addedClientTransports.empty())
+        {
+            return;
         }
 
         Lock lock(mClientTransportsMutex);
 
-        std::copy(
-            addedClientTransports.begin(),
-            addedClientTransports.end(),
-            std::back_inserter(mClientTransports));
+        RCF_ASSERT(addedFilters.size() == addedClientTransports.size());
+
+        // New subscribers are sent the cached messages, before they are sent any newly published message.
+        if (mLastValues.size() > 0)
+        {
+            sendSnapshots(lock, addedClientTransports, addedFilters, addedMulticastFlags, timeoutMs);
+        }
+
+        for (std::size_t i=0; i<addedClientTransports.size(); ++i)
+        {
+            if (!addedClientTransports[i])
+            {
+                continue;
+            }
+
+            mClientTransports.push_back(addedClientTransports[i]);
+            addSubscriberFilter(addedClientTransports[i].get(), addedFilters[i]);
+            if (addedMulticastFlags[i])
+            {
+                mMulticastSubscribers.insert(addedClientTransports[i].get());
+            }
+        }
     }
 
     void MulticastClientTransport::setTransportFilters(
@@ -415,7 +1391,7 @@ namespace RCF {
 
     void MulticastClientTransport::dropIdleTransports()
     {
-        bringInNewTransports();
+        bringInNewTransports( globals().getDefaultRemoteCallTimeoutMs() );
 
         Lock lock(mClientTransportsMutex);
 
@@ -461,12 +1437,13 @@ namespace RCF {
         if (needToRemove)
         {
             eraseRemove(mClientTransports, ClientTransportUniquePtrPtr());
+            removeStaleEntries();
         }
     }
 
     void MulticastClientTransport::pingAllTransports()
     {
-        bringInNewTransports();
+        bringInNewTransports( globals().getDefaultRemoteCallTimeoutMs() );
 
         Lock lock(mClientTransportsMutex);
 
@@ -480,6 +1457,11 @@ namespace RCF {
 
         multicastTemp.mClientTransports.resize(0);
 
+        // With subscriber queues, pings are queued behind the published messages, on the same queues.
+        multicastTemp.mQueueLimit = mQueueLimit;
+        multicastTemp.mOverflowPolicy = mOverflowPolicy;
+        multicastTemp.mSubscriberQueues.clear();
+
         ClientTransportList::iterator iter;
         for (iter = mClientTransports.begin(); iter != mClientTransports.end(); ++iter)
         {
@@ -502,16 +1484,32 @@ namespace RCF {
             }
         }
 
+        if (mQueueLimit > 0)
+        {
+            for (std::size_t i=0; i<multicastTemp.mClientTransports.size(); ++i)
+            {
+                ClientTransportUniquePtr * pKey = multicastTemp.mClientTransports[i].get();
+                multicastTemp.mSubscriberQueues[pKey] = getSubscriberQueue(multicastTemp.mClientTransports[i]);
+            }
+        }
+
         I_RcfClient nullClient("", std::move(mMulticastTemp) );
         nullClient.getClientStub().ping(RCF::Oneway);
         mMulticastTemp.reset( nullClient.getClientStub().releaseTransport().release() );
         multicastTemp.mClientTransports.resize(0);
+        multicastTemp.mSubscriberQueues.clear();
     }
 
     void MulticastClientTransport::close()
     {
         Lock lock(mClientTransportsMutex);
         mClientTransports.clear();
+        removeStaleEntries();
+
+        if (mGroupTransportPtr)
+        {
+            mGroupTransportPtr->disconnect(0);
+        }
     }
 
     std::size_t MulticastClientTransport::getTransportCount()
@@ -0,0 +1,340 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#include <RCF/MulticastReceiver.hpp>
+
+#include <RCF/ByteOrdering.hpp>
+#include <RCF/ClientStub.hpp>
+#include <RCF/Endpoint.hpp>
+#include <RCF/Exception.hpp>
+#include <RCF/MethodInvocation.hpp>
+#include <RCF/MulticastClientTransport.hpp>
+#include <RCF/RcfClient.hpp>
+#include <RCF/RcfServer.hpp>
+#include <RCF/RcfSession.hpp>
+#include <RCF/ReallocBuffer.hpp>
+#include <RCF/SubscriptionService.hpp>
+#include <RCF/UdpServerTransport.hpp>
+#include <RCF/Log.hpp>
+
+#include <RCF/BsdSockets.hpp>
+
+namespace RCF {
+
+    MulticastReceiver::MulticastReceiver(
+        RcfServer &                 server,
+        const Endpoint &            groupEp,
+        RcfClientPtr                rcfClientPtr,
+        const std::string &         publisherName,
+        const SubscriptionFilter &  filter,
+        RcfClientPtr                retransmitClientPtr) :
+            mServer(server),
+            mPublisherName(publisherName),
+            mFilter(filter),
+            mRetransmitClientPtr(retransmitClientPtr),
+            mThreadPool(1),
+            mRecvBuffer(64*1024),
+            mStreamStarted(false),
+            mStreamId(0),
+            mNextSeq(0),
+            mReceivedCount(0),
+            mRecoveredCount(0),
+            mLostCount(0),
+            mDiscardedCount(0)
+    {
+        std::unique_ptr<ServerTransport> serverTransportPtr = groupEp.createServerTransport();
+        UdpServerTransport * pUdpTransport = dynamic_cast<UdpServerTransport *>(serverTransportPtr.get());
+        RCF_VERIFY(pUdpTransport, Exception(RcfError_TransportCreation));
+        serverTransportPtr.release();
+        mTransportPtr.reset(pUdpTransport);
+
+        // The transport is not added to the server, and is only used for its socket and network session.
+        mTransportPtr->setSessionManager(mServer);
+        mTransportPtr->open();
+
+        mNetworkSessionPtr.reset( new UdpNetworkSession(*mTransportPtr) );
+        mNetworkSessionPtr->mRcfSessionPtr = mServer.createSession();
+        mNetworkSessionPtr->mRcfSessionPtr->setNetworkSession(*mNetworkSessionPtr);
+        mRcfSessionPtr = mNetworkSessionPtr->mRcfSessionPtr;
+
+        // Publishers send with an empty binding name, so messages go to the default stub entry of the session.
+        mRcfSessionPtr->setDefaultStubEntryPtr(rcfClientPtr);
+
+        mThreadPool.setThreadName("RCF Multicast receiver");
+        mThreadPool.setTask( std::bind(&MulticastReceiver::cycle, this, std::placeholders::_1) );
+    }
+
+    MulticastReceiver::~MulticastReceiver()
+    {
+        RCF_DTOR_BEGIN
+            stop();
+            mRcfSessionPtr->setDefaultStubEntryPtr(RcfClientPtr());
+            mTransportPtr->close();
+        RCF_DTOR_END
+    }
+
+    void MulticastReceiver::start()
+    {
+        mThreadPool.start();
+    }
+
+    void MulticastReceiver::stop()
+    {
+        mThreadPool.stop();
+    }
+
+    void MulticastReceiver::getStats(MulticastReceiveStats & stats)
+    {
+        Lock lock(mStatsMutex);
+        stats.mReceivedCount = mReceivedCount;
+        stats.mRecoveredCount = mRecoveredCount;
+        stats.mLostCount = mLostCount;
+        stats.mDiscardedCount = mDiscardedCount;
+    }
+
+    void MulticastReceiver::setDispatchQueue(SubscriptionDispatchQueuePtr dispatchQueuePtr)
+    {
+        mRcfSessionPtr->setDispatchQueue(dispatchQueuePtr);
+    }
+
+    void MulticastReceiver::cycle(int timeoutMs)
+    {
+        int fd = mTransportPtr->mFd;
+
+        fd_set fdSet;
+        FD_ZERO(&fdSet);
+        FD_SET( static_cast<SOCKET>(fd), &fdSet);
+        timeval timeout;
+        timeout.tv_sec = timeoutMs/1000;
+        timeout.tv_usec = 1000*(timeoutMs%1000);
+
+        int ret = Platform::OS::BsdSockets::select(fd+1, &fdSet, NULL, NULL, &timeout);
+        int err = Platform::OS::BsdSockets::GetLastError();
+        if (ret == -1)
+        {
+            Exception e(RcfError_Socket, "select()", osError(err));
+            RCF_THROW(e);
+        }
+        else if (ret == 0)
+        {
+            return;
+        }
+
+        SockAddrStorage from;
+        int fromlen = sizeof(from);
+        memset(&from, 0, sizeof(from));
+
+        int len = Platform::OS::BsdSockets::recvfrom(
+            fd,
+            &mRecvBuffer[0],
+            static_cast<int>(mRecvBuffer.size()),
+            0,
+            (sockaddr *) &from,
+            &fromlen);
+
+        if (len <= 0)
+        {
+            return;
+        }
+
+        mNetworkSessionPtr->mRemoteAddress.init( (sockaddr &) from, fromlen, mTransportPtr->mIpAddress.getType() );
+        if (!mTransportPtr->isIpAllowed(mNetworkSessionPtr->mRemoteAddress))
+        {
+            return;
+        }
+
+        onDatagram(&mRecvBuffer[0], static_cast<std::size_t>(len));
+    }
+
+    bool MulticastReceiver::parseDatagram(
+        const char *        pDatagram, 
+        std::size_t         datagramLen, 
+        std::size_t &       messageLen, 
+        MulticastTrailer &  trailer)
+    {
+        if (datagramLen < 4)
+        {
+            return false;
+        }
+
+        std::uint32_t dataLength = 0;
+        memcpy(&dataLength, pDatagram, 4);
+        networkToMachineOrder(&dataLength, 4, 1);
+        if (dataLength > datagramLen - 4)
+        {
+            return false;
+        }
+
+        messageLen = 4 + dataLength;
+        return trailer.decode(pDatagram, datagramLen, messageLen);
+    }
+
+    void MulticastReceiver::onDatagram(const char * pDatagram, std::size_t datagramLen)
+    {
+        std::size_t messageLen = 0;
+        MulticastTrailer trailer;
+        if (!parseDatagram(pDatagram, datagramLen, messageLen, trailer))
+        {
+            RCF_LOG_3()(datagramLen) << "MulticastReceiver - discarding datagram without multicast trailer.";
+            Lock lock(mStatsMutex);
+            ++mDiscardedCount;
+            return;
+        }
+
+        // A new stream id means the publisher has been restarted, and we start again from the current datagram.
+        if (!mStreamStarted || trailer.mStreamId != mStreamId)
+        {
+            mStreamStarted = true;
+            mStreamId = trailer.mStreamId;
+            mNextSeq = trailer.mSeq;
+        }
+
+        if (trailer.mSeq < mNextSeq)
+        {
+            // Duplicate, or arrived after the gap it left was recovered or given up on.
+            Lock lock(mStatsMutex);
+            ++mDiscardedCount;
+            return;
+        }
+
+        if (trailer.mSeq > mNextSeq)
+        {
+            RCF_LOG_2()(mPublisherName)(mNextSeq)(trailer.mSeq) << "MulticastReceiver - gap in sequence numbers.";
+            recoverGap(mNextSeq, trailer.mSeq - 1);
+        }
+
+        {
+            Lock lock(mStatsMutex);
+            ++mReceivedCount;
+        }
+
+        mNextSeq = trailer.mSeq + 1;
+        dispatch(pDatagram, messageLen, trailer.mKey);
+    }
+
+    // Requests the missing datagrams from the publisher, and dispatches those it still has, in sequence.
+    void MulticastReceiver::recoverGap(std::uint64_t firstSeq, std::uint64_t lastSeq)
+    {
+        std::uint64_t nextSeq = firstSeq;
+        std::uint64_t recoveredCount = 0;
+
+        while (mRetransmitClientPtr && nextSeq <= lastSeq)
+        {
+            ClientStub & stub = mRetransmitClientPtr->getClientStub();
+
+            std::uint32_t maxResponseLength = static_cast<std::uint32_t>(
+                stub.getTransport().getMaxIncomingMessageLength());
+
+            OobRequestRetransmit msg(
+                stub.getRuntimeVersion(), 
+                mPublisherName, 
+                mStreamId, 
+                nextSeq, 
+                lastSeq, 
+                maxResponseLength);
+
+            try
+            {
+                ByteBuffer controlRequest;
+                msg.encodeRequest(controlRequest);
+                stub.setOutofBandRequest(controlRequest);
+
+                stub.ping(RCF::Twoway);
+
+                ByteBuffer controlResponse = stub.getOutOfBandResponse();
+                stub.setOutofBandRequest(ByteBuffer());
+                stub.setOutofBandResponse(ByteBuffer());
+                msg.decodeResponse(controlResponse);
+            }
+            catch (const Exception & e)
+            {
+                RCF_LOG_2()(mPublisherName)(e.getErrorMessage()) << "MulticastReceiver - retransmit request failed.";
+                stub.setOutofBandRequest(ByteBuffer());
+                stub.setOutofBandResponse(ByteBuffer());
+                break;
+            }
+
+            if (msg.mResponseError != RcfError_Ok_Id || msg.mDatagrams.empty())
+            {
+                break;
+            }
+
+            std::size_t dispatchedCount = 0;
+            for (std::size_t i=0; i<msg.mDatagrams.size(); ++i)
+            {
+                const ByteBuffer & datagram = msg.mDatagrams[i];
+
+                std::size_t messageLen = 0;
+                MulticastTrailer trailer;
+                if (    !parseDatagram(datagram.getPtr(), datagram.getLength(), messageLen, trailer)
+                    ||  trailer.mStreamId != mStreamId
+                    ||  trailer.mSeq < nextSeq
+                    ||  trailer.mSeq > lastSeq)
+                {
+                    continue;
+                }
+
+                // Datagrams that dropped out of the publisher history in the meantime, are lost.
+                if (trailer.mSeq > nextSeq)
+                {
+                    Lock lock(mStatsMutex);
+                    mLostCount += trailer.mSeq - nextSeq;
+                }
+
+                nextSeq = trailer.mSeq + 1;
+                ++recoveredCount;
+                ++dispatchedCount;
+                dispatch(datagram.getPtr(), messageLen, trailer.mKey);
+            }
+
+            if (dispatchedCount == 0)
+            {
+                break;
+            }
+        }
+
+        Lock lock(mStatsMutex);
+        mRecoveredCount += recoveredCount;
+        if (nextSeq <= lastSeq)
+        {
+            mLostCount += lastSeq - nextSeq + 1;
+        }
+    }
+
+    void MulticastReceiver::dispatch(const char * pDatagram, std::size_t messageLen, const std::string & key)
+    {
+        // Multicast datagrams carry every message of the publisher, so the subscription filter is applied here.
+        if (key.size() > 0 && !mFilter.isEmpty() && !mFilter.matches(key))
+        {
+            return;
+        }
+
+        ReallocBufferPtr & readVecPtr = mNetworkSessionPtr->mReadVecPtr;
+        if (readVecPtr.get() == NULL || readVecPtr.use_count() != 1)
+        {
+            readVecPtr.reset(new ReallocBuffer());
+        }
+
+        ReallocBuffer & buffer = *readVecPtr;
+        buffer.resize(messageLen);
+        memcpy(&buffer[0], pDatagram, messageLen);
+
+        mServer.onReadCompleted(mRcfSessionPtr);
+    }
+
+} // namespace RCF
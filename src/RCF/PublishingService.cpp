@@ -21,6 +21,7 @@
 #include <RCF/AsioServerTransport.hpp>
 #include <RCF/ConnectedClientTransport.hpp>
 #include <RCF/CurrentSession.hpp>
+#include <RCF/Endpoint.hpp>
 #include <RCF/MulticastClientTransport.hpp>
 #include <RCF/RcfServer.hpp>
 #include <RCF/RcfSession.hpp>
@@ -49,6 +50,65 @@ namespace RCF {
     {
         mOnSubscriberDisconnect = onSubscriberDisconnect;
     }
+
+    void PublisherParms::setSubscriberQueueLimit(std::size_t queueLimit)
+    {
+        mSubscriberQueueLimit = queueLimit;
+    }
+
+    std::size_t PublisherParms::getSubscriberQueueLimit() const
+    {
+        return mSubscriberQueueLimit;
+    }
+
+    void PublisherParms::setQueueOverflowPolicy(QueueOverflowPolicy policy)
+    {
+        mQueueOverflowPolicy = policy;
+    }
+
+    QueueOverflowPolicy PublisherParms::getQueueOverflowPolicy() const
+    {
+        return mQueueOverflowPolicy;
+    }
+
+    void PublisherParms::setMulticastEndpoint(const Endpoint & groupEp)
+    {
+        mMulticastEndpointPtr = groupEp.clone();
+    }
+
+    void PublisherParms::setMulticastHistoryLength(std::size_t historyLength)
+    {
+        mMulticastHistoryLength = historyLength;
+    }
+
+    std::size_t PublisherParms::getMulticastHistoryLength() const
+    {
+        return mMulticastHistoryLength;
+    }
+
+    void PublisherParms::setLastValueCacheLimit(std::size_t maxKeys, std::size_t maxBytes)
+    {
+        mLastValueCacheLimit = maxKeys;
+        mLastValueCacheMaxBytes = maxBytes;
+    }
+
+    std::size_t PublisherParms::getLastValueCacheLimit() const
+    {
+        return mLastValueCacheLimit;
+    }
+
+    std::size_t PublisherParms::getLastValueCacheMaxBytes() const
+    {
+        return mLastValueCacheMaxBytes;
+    }
+
+    SubscriberQueueStats::SubscriberQueueStats() :
+        mQueueDepth(0),
+        mSentCount(0),
+        mDroppedCount(0),
+        mConflatedCount(0)
+    {
+    }
     
 #ifdef _MSC_VER
 #pragma warning( push )
@@ -95,7 +155,25 @@ namespace RCF {
     std::int32_t PublishingService::RequestSubscription(
         const std::string &subscriptionName,
         std::uint32_t subToPubPingIntervalMs,
-        std::uint32_t & pubToSubPingIntervalMs)
+        std::uint32_t & pubToSubPingIntervalMs,
+        const SubscriptionFilter & filter)
+    {
+        bool multicastDelivery = false;
+
+        return RequestSubscription(
+            subscriptionName,
+            subToPubPingIntervalMs,
+            pubToSubPingIntervalMs,
+            filter,
+            multicastDelivery);
+    }
+
+    std::int32_t PublishingService::RequestSubscription(
+        const std::string &subscriptionName,
+        std::uint32_t subToPubPingIntervalMs,
+        std::uint32_t & pubToSubPingIntervalMs,
+        const SubscriptionFilter & filter,
+        bool & multicastDelivery)
     {
         PublisherPtr publisherPtr;
         std::string publisherName = subscriptionName;
@@ -141,17 +219,98 @@ namespace RCF {
 
             rcfSession.setPingTimestamp();
 
+            // Multicast delivery is only possible if the publisher has a multicast group.
+            MulticastClientTransport & multicastClientTransport = 
+                static_cast<MulticastClientTransport &>(
+                    publisherPtr->mRcfClientPtr->getClientStub().getTransport());
+
+            multicastDelivery = multicastDelivery && multicastClientTransport.hasMulticastGroup();
+
             rcfSession.addOnWriteCompletedCallback( std::bind(
                 &PublishingService::addSubscriberTransport,
                 this,
                 std::placeholders::_1,
                 publisherName,
-                clientTransportUniquePtrPtr) );
+                clientTransportUniquePtrPtr,
+                filter,
+                multicastDelivery) );
         }  
+        else
+        {
+            multicastDelivery = false;
+        }
         pubToSubPingIntervalMs = mPingIntervalMs;
         return publisherPtr ? RcfError_Ok_Id : RcfError_UnknownPublisher_Id;
     }
 
+    std::int32_t PublishingService::RequestRetransmit(
+        const std::string &         publisherName,
+        std::uint64_t               streamId,
+        std::uint64_t               firstSeq,
+        std::uint64_t               lastSeq,
+        std::uint32_t               maxResponseLength,
+        std::vector<ByteBuffer> &   datagrams)
+    {
+        PublisherPtr publisherPtr;
+
+        {
+            Lock lock(mPublishersMutex);
+            Publishers::iterator iter = mPublishers.find(publisherName);
+            if (iter != mPublishers.end())
+            {
+                publisherPtr = iter->second.lock();
+            }
+        }
+
+        if (!publisherPtr)
+        {
+            return RcfError_UnknownPublisher_Id;
+        }
+
+        // Retransmits are requested over a connection of their own, so they need the same 
+        // access check as the subscription.
+        if (publisherPtr->mParms.mOnSubscriberConnect)
+        {
+            RcfSession & rcfSession = getTlsRcfSession();
+            bool allowSubscriber = publisherPtr->mParms.mOnSubscriberConnect(rcfSession, publisherName);
+            if (!allowSubscriber)
+            {
+                return RcfError_AccessDenied_Id;
+            }
+        }
+
+        // Larger gaps are recovered over several requests.
+        const std::uint64_t MaxRetransmitCount = 256;
+        if (lastSeq >= firstSeq && lastSeq - firstSeq >= MaxRetransmitCount)
+        {
+            lastSeq = firstSeq + MaxRetransmitCount - 1;
+        }
+
+        MulticastClientTransport & multicastClientTransport = 
+            static_cast<MulticastClientTransport &>(
+                publisherPtr->mRcfClientPtr->getClientStub().getTransport());
+
+        multicastClientTransport.getMulticastDatagrams(streamId, firstSeq, lastSeq, datagrams);
+
+        // The response has to fit in what the subscriber can receive, leaving room for the headers.
+        if (maxResponseLength)
+        {
+            std::size_t maxDatagramsLength = maxResponseLength * std::size_t(8) / 10;
+            std::size_t datagramsLength = 0;
+            for (std::size_t i=0; i<datagrams.size(); ++i)
+            {
+                datagramsLength += datagrams[i].getLength() + 5;
+                if (datagramsLength > maxDatagramsLength)
+                {
+                    datagrams.resize(i);
+                    break;
+                }
+            }
+        }
+
+        return RcfError_Ok_Id;
+    }
+
     void PublishingService::onServiceAdded(RcfServer & server)
     {
         RCF_UNUSED_VARIABLE(server);
@@ -201,7 +360,9 @@ namespace RCF {
     void PublishingService::addSubscriberTransport(
         RcfSession &rcfSession,
         const std::string &publisherName,
-        ClientTransportUniquePtrPtr clientTransportUniquePtrPtr)
+        ClientTransportUniquePtrPtr clientTransportUniquePtrPtr,
+        const SubscriptionFilter & filter,
+        bool multicastDelivery)
     {
         PublisherPtr publisherPtr;
 
@@ -238,7 +399,10 @@ namespace RCF {
                 static_cast<MulticastClientTransport &>(
                     publisherPtr->mRcfClientPtr->getClientStub().getTransport());
 
-            multicastClientTransport.addTransport(std::move(*clientTransportUniquePtrPtr));
+            multicastClientTransport.addTransport(
+                std::move(*clientTransportUniquePtrPtr), 
+                filter, 
+                multicastDelivery);
         }
     }
 
@@ -333,7 +497,8 @@ namespace RCF {
     PublisherBase::PublisherBase(PublishingService & pubService, const PublisherParms & parms) : 
         mPublishingService(pubService),
         mParms(parms),
-        mClosed(false)
+        mClosed(false),
+        mMessageKeySet(false)
     {
         mTopicName = parms.getTopicName();
     }
@@ -360,6 +525,58 @@ namespace RCF {
         return transportCount;
     }
 
+    void PublisherBase::getSubscriberQueueStats(std::vector<SubscriberQueueStats> & stats)
+    {
+        ClientTransport & transport = mRcfClientPtr->getClientStub().getTransport();
+        MulticastClientTransport & multiTransport = static_cast<MulticastClientTransport &>(transport);
+        multiTransport.getQueueStats(stats);
+    }
+
+    std::uint64_t PublisherBase::getDroppedMessageCount()
+    {
+        ClientTransport & transport = mRcfClientPtr->getClientStub().getTransport();
+        MulticastClientTransport & multiTransport = static_cast<MulticastClientTransport &>(transport);
+        return multiTransport.getDroppedCount();
+    }
+
+    std::uint64_t PublisherBase::getOverflowDisconnectCount()
+    {
+        ClientTransport & transport = mRcfClientPtr->getClientStub().getTransport();
+        MulticastClientTransport & multiTransport = static_cast<MulticastClientTransport &>(transport);
+        return multiTransport.getOverflowDisconnectCount();
+    }
+
+    void PublisherBase::setMessageKey(const std::string & messageKey)
+    {
+        ClientTransport & transport = mRcfClientPtr->getClientStub().getTransport();
+        MulticastClientTransport & multiTransport = static_cast<MulticastClientTransport &>(transport);
+        multiTransport.setMessageKey(messageKey);
+
+        // The key is carried to subscribers in the request header of the message.
+        mRcfClientPtr->getClientStub().mRequest.setMessageKey(messageKey);
+        mMessageKeySet = true;
+    }
+
+    void PublisherBase::clearMessageKey()
+    {
+        mRcfClientPtr->getClientStub().mRequest.setMessageKey(std::string());
+        mMessageKeySet = false;
+    }
+
+    void PublisherBase::removeLastValue(const std::string & messageKey)
+    {
+        ClientTransport & transport = mRcfClientPtr->getClientStub().getTransport();
+        MulticastClientTransport & multiTransport = static_cast<MulticastClientTransport &>(transport);
+        multiTransport.removeLastValue(messageKey);
+    }
+
+    std::size_t PublisherBase::getLastValueCount()
+    {
+        ClientTransport & transport = mRcfClientPtr->getClientStub().getTransport();
+        MulticastClientTransport & multiTransport = static_cast<MulticastClientTransport &>(transport);
+        return multiTransport.getLastValueCount();
+    }
+
     void PublisherBase::close()
     {
         mPublishingService.closePublisher(mTopicName);
@@ -378,8 +595,25 @@ namespace RCF {
 
     void PublisherBase::init()
     {
+        MulticastClientTransport * pMulticastTransport = new MulticastClientTransport();
+
+        pMulticastTransport->setQueueLimit(
+            mParms.getSubscriberQueueLimit(), 
+            mParms.getQueueOverflowPolicy());
+
+        pMulticastTransport->setLastValueCacheLimit(
+            mParms.getLastValueCacheLimit(),
+            mParms.getLastValueCacheMaxBytes());
+
+        if (mParms.mMulticastEndpointPtr)
+        {
+            pMulticastTransport->setMulticastGroup(
+                mParms.mMulticastEndpointPtr->createClientTransport(),
+                mParms.getMulticastHistoryLength());
+        }
+
         mRcfClientPtr->getClientStub().setTransport(
-            ClientTransportUniquePtr(new MulticastClientTransport));
+            ClientTransportUniquePtr(pMulticastTransport));
 
         mRcfClientPtr->getClientStub().setRemoteCallMode(Oneway);
         mRcfClientPtr->getClientStub().setServerBindingName("");
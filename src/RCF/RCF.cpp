@@ -47,6 +47,7 @@
 #include "Log.cpp"
 #include "Marshal.cpp"
 #include "MemStream.cpp"
+#include "MessageFraming.cpp"
 #include "MethodInvocation.cpp"
 #include "ObjectPool.cpp"
 #include "PerformanceData.cpp"
@@ -63,6 +64,7 @@
 #include "ServerTransport.cpp"
 #include "Service.cpp"
 #include "SessionTimeoutService.cpp"
+#include "SubscriptionFilter.cpp"
 #include "Tchar.cpp"
 #include "ThreadLibrary.cpp"
 #include "ThreadLocalData.cpp"
@@ -124,6 +126,11 @@
 #include "PublishingService.cpp"
 #include "SubscriptionService.cpp"
 #include "SubscriptionServiceLegacy.cpp"
+#include "SubscriptionDispatcher.cpp"
+#endif
+
+#if RCF_FEATURE_PUBSUB==1 && RCF_FEATURE_UDP==1
+#include "MulticastReceiver.cpp"
 #endif
 
 
@@ -174,6 +181,7 @@ namespace RCF {
 
 #if RCF_FEATURE_SF==1
 #include "../SF/SF.cpp"
+#include "ArrayView.cpp"
 #else
 #include "../SF/Encoding.cpp"
 #endif
@@ -184,6 +192,7 @@ namespace RCF {
 #include "FileTransferService.cpp"
 #include "FileStream.cpp"
 #include "FileSystem.cpp"
+#include "FileDelta.cpp"
 #endif
 
 
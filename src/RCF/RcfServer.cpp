@@ -82,6 +82,7 @@ namespace RCF { class FileTransferService {}; }
 
 #if RCF_FEATURE_PUBSUB==1
 #include <RCF/PublishingService.hpp>
+#include <RCF/SubscriptionDispatcher.hpp>
 #include <RCF/SubscriptionService.hpp>
 #endif
 
@@ -492,6 +493,101 @@ namespace RCF {
         //rcfSessionPtr->onReadCompleted();
     }
 
+    // Request headers are normally much shorter than this.
+    static const std::size_t IncrementalHeaderLen = 1024;
+
+    bool RcfSession::decodeIncrementalRequest(
+        const ByteBuffer &          message,
+        ByteBuffer &                messageBody,
+        MemIstreamSourcePtr &       sourcePtr)
+    {
+        const char * pchBegin = message.getPtr();
+        const char * pchEnd = pchBegin + message.getLength();
+
+        const char * pchAvailable = sourcePtr->waitForData(
+            pchBegin + RCF_MIN(message.getLength(), IncrementalHeaderLen));
+
+        // Filtered requests can only be decoded once they have been fully received.
+        if (pchAvailable > pchBegin && pchBegin[0] == Descriptor_Request)
+        {
+            try
+            {
+                ByteBuffer received(message, 0, pchAvailable - pchBegin);
+                bool ok = mRequest.decodeRequest(
+                    received,
+                    messageBody,
+                    shared_from_this(),
+                    mRcfServer);
+
+                // The request body extends over the part of the request that is still to come.
+                std::size_t headerLen = messageBody.getPtr() - pchBegin;
+                messageBody = ByteBuffer(message, headerLen);
+                return ok;
+            }
+            catch(const Exception &)
+            {
+                // Header is longer than what has arrived.
+            }
+        }
+
+        // The connection may have failed before the request was fully received.
+        if (sourcePtr->waitForData(pchEnd) < pchEnd)
+        {
+            Exception e(RcfError_Decoding);
+            RCF_THROW(e);
+        }
+
+        sourcePtr.reset();
+
+        return mRequest.decodeRequest(
+            message,
+            messageBody,
+            shared_from_this(),
+            mRcfServer);
+    }
+
+    // Decodes a request that was received with chunked framing. On return, chunks holds the request body.
+    bool RcfSession::decodeChunkedRequest(
+        std::vector<ByteBuffer> &   chunks)
+    {
+        ByteBuffer messageBody;
+
+        // The header normally fits in the first chunk, and the body is then read directly from the chunks.
+        const ByteBuffer & firstChunk = chunks.front();
+        if (firstChunk.getLength() > 0 && firstChunk.getPtr()[0] == Descriptor_Request)
+        {
+            try
+            {
+                bool ok = mRequest.decodeRequest(
+                    firstChunk,
+                    messageBody,
+                    shared_from_this(),
+                    mRcfServer);
+
+                chunks.front() = messageBody;
+                return ok;
+            }
+            catch(const Exception &)
+            {
+                // Header extends past the first chunk.
+            }
+        }
+
+        // Filtered requests are decoded from a single buffer.
+        ByteBuffer message;
+        copyByteBuffers(chunks, message);
+
+        bool ok = mRequest.decodeRequest(
+            message,
+            messageBody,
+            shared_from_this(),
+            mRcfServer);
+
+        chunks.resize(0);
+        chunks.push_back(messageBody);
+        return ok;
+    }
+
     void RcfSession::onReadCompleted()
     {
         // 1. Deserialize request data
@@ -533,24 +629,105 @@ namespace RCF {
 
             ByteBuffer messageBody;
 
-            bool ok = mRequest.decodeRequest(
-                readByteBuffer,
-                messageBody,
-                shared_from_this(),
-                mRcfServer);
+            ThreadLocalCached< std::vector<ByteBuffer> > tlcReadChunks;
+            std::vector<ByteBuffer> & readChunks = tlcReadChunks.get();
+
+            ThreadLocalCached< std::vector<ByteBuffer> > tlcRawChunks;
+            std::vector<ByteBuffer> & rawChunks = tlcRawChunks.get();
+
+            bool ok = false;
+            MemIstreamSourcePtr sourcePtr = getNetworkSession().getIncrementalReadSource();
+            if (sourcePtr)
+            {
+                // The request is still being received, so decode the header from what has arrived so far.
+                ok = decodeIncrementalRequest(readByteBuffer, messageBody, sourcePtr);
+            }
+            else
+            {
+                getNetworkSession().getReadChunks(readChunks);
+                if (readChunks.size() > 1)
+                {
+
+#if RCF_FEATURE_PUBSUB==1
+
+                    // Decoding replaces the chunks with the request body, and queued requests are decoded again 
+                    // when they are dispatched, so they need the chunks as received.
+                    if (mDispatchQueuePtr)
+                    {
+                        rawChunks = readChunks;
+                    }
+
+#endif
+
+                    ok = decodeChunkedRequest(readChunks);
+                }
+                else
+                {
+                    readChunks.resize(0);
+                    ok = mRequest.decodeRequest(
+                        readByteBuffer,
+                        messageBody,
+                        shared_from_this(),
+                        mRcfServer);
+                }
+            }
 
             RCF_LOG_3()(this)(mRequest) 
                 << "RcfServer - received request.";
 
+#if RCF_FEATURE_PUBSUB==1
+
+            if (    ok 
+                &&  mDispatchQueuePtr 
+                &&  mRequest.mOneway 
+                &&  mRequest.getFnId() != -1 
+                &&  !mRequest.getClose())
+            {
+                bool readMore = queueForDispatch(readByteBuffer, rawChunks, sourcePtr);
+
+                messageBody.clear();
+                readChunks.resize(0);
+                rawChunks.resize(0);
+                readByteBuffer.clear();
+
+                // If the dispatch queue is full, it resumes reading once it has drained.
+                if (readMore)
+                {
+                    onWriteCompleted();
+                }
+                return;
+            }
+
+#endif
+
             // Setup the in stream for this remote call.
-            mIn.reset(
-                messageBody, 
-                mRequest.mSerializationProtocol, 
-                mRuntimeVersion, 
-                mArchiveVersion,
-                mRequest.mEnableSfPointerTracking);
+            if (readChunks.size() > 1)
+            {
+                mIn.reset(
+                    readChunks, 
+                    mRequest.mSerializationProtocol, 
+                    mRuntimeVersion, 
+                    mArchiveVersion,
+                    mRequest.mEnableSfPointerTracking);
+            }
+            else
+            {
+                if (readChunks.size() == 1)
+                {
+                    messageBody = readChunks.front();
+                }
+
+                mIn.reset(
+                    messageBody, 
+                    mRequest.mSerializationProtocol, 
+                    mRuntimeVersion, 
+                    mArchiveVersion,
+                    mRequest.mEnableSfPointerTracking,
+                    sourcePtr);
+            }
 
             messageBody.clear();
+            readChunks.resize(0);
             
             readByteBuffer.clear();
 
@@ -768,7 +945,7 @@ namespace RCF {
                 mArchiveVersion,
                 mEnableSfPointerTracking);
 
-            mpParameters->write(mOut);
+            mOut.writeParameters(*mpParameters, mRequest.getFnId(), mEnableSizingPass);
             clearParameters();
         }
         catch(const std::exception &e)
@@ -969,7 +1146,9 @@ namespace RCF {
         rsMsg.mResponseError = mRcfServer.mPublishingServicePtr->RequestSubscription(
             rsMsg.mPublisherName,
             rsMsg.mSubToPubPingIntervalMs,
-            rsMsg.mPubToSubPingIntervalMs);
+            rsMsg.mPubToSubPingIntervalMs,
+            rsMsg.mFilter,
+            rsMsg.mMulticastDelivery);
 
 #else
 
@@ -995,6 +1174,29 @@ namespace RCF {
         Exception e(RcfError_NotSupportedInThisBuild, "Proxy endpoints");
         RCF_THROW(e);
 
+#endif
+    }
+
+    void RcfSession::processOob_RequestRetransmit(OobMessage& msg)
+    {
+        OobRequestRetransmit & rrMsg = static_cast<OobRequestRetransmit &>(msg);
+
+#if RCF_FEATURE_PUBSUB==1
+
+        rrMsg.mResponseError = mRcfServer.mPublishingServicePtr->RequestRetransmit(
+            rrMsg.mPublisherName,
+            rrMsg.mStreamId,
+            rrMsg.mFirstSeq,
+            rrMsg.mLastSeq,
+            rrMsg.mMaxResponseLength,
+            rrMsg.mDatagrams);
+
+#else
+
+        RCF_UNUSED_VARIABLE(rrMsg);
+        Exception e(RcfError_NotSupportedInThisBuild, "Subscriptions");
+        RCF_THROW(e);
+
 #endif
     }
 
@@ -1030,6 +1232,10 @@ namespace RCF {
                     processOob_RequestProxyConnection(*msgPtr);
                     break;
 
+                case Omt_RequestRetransmit:
+                    processOob_RequestRetransmit(*msgPtr);
+                    break;
+
                 default:
                     RCF_THROW(Exception(RcfError_Decoding));
                 }
@@ -1072,10 +1278,56 @@ namespace RCF {
         RCF_UNUSED_VARIABLE(msg);
     }
 
+    void RcfSession::processOob_RequestRetransmit(OobMessage& msg)
+    {
+        RCF_UNUSED_VARIABLE(msg);
+    }
+
     void RcfSession::processOobMessages()
     {
     }
 
+#endif
+
+#if RCF_FEATURE_PUBSUB==1
+
+    void RcfSession::setDispatchQueue(SubscriptionDispatchQueuePtr dispatchQueuePtr)
+    {
+        // Held by onReadCompleted() while a request is processed. Requests processed before the queue is set, 
+        // complete before the next request is read, so they are still dispatched in order.
+        Lock lock(mStopCallInProgressMutex);
+        mDispatchQueuePtr = dispatchQueuePtr;
+    }
+
+    bool RcfSession::queueForDispatch(
+        const ByteBuffer &                  readByteBuffer, 
+        const std::vector<ByteBuffer> &     readChunks, 
+        MemIstreamSourcePtr                 sourcePtr)
+    {
+        // The network session reuses its read buffer once we return, so the message is copied.
+        ByteBuffer message;
+        if (readChunks.size() > 1)
+        {
+            copyByteBuffers(readChunks, message);
+        }
+        else
+        {
+            const char * pchBegin = readByteBuffer.getPtr();
+            const char * pchEnd = pchBegin + readByteBuffer.getLength();
+
+            // The request may still be being received.
+            if (sourcePtr && sourcePtr->waitForData(pchEnd) != pchEnd)
+            {
+                return true;
+            }
+
+            std::shared_ptr< std::vector<char> > vecPtr( new std::vector<char>(pchBegin, pchEnd) );
+            message = ByteBuffer(vecPtr);
+        }
+
+        return mDispatchQueuePtr->push(*this, message);
+    }
+
 #endif
 
     void RcfSession::callServant()
@@ -1164,6 +1416,7 @@ namespace RCF {
 
         WriteLock writeLock(mStubMapMutex);
         mStubMap[name] = rcfClientPtr;
+        ++mStubMapGeneration;
         return rcfClientPtr->getServerStubPtr();
     }
 
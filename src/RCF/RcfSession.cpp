@@ -153,6 +153,16 @@ namespace RCF {
         return mEnableNativeWstringSerialization;
     }
 
+    void RcfSession::setEnableSizingPass(bool enable)
+    {
+        mEnableSizingPass = enable;
+    }
+
+    bool RcfSession::getEnableSizingPass() const
+    {
+        return mEnableSizingPass;
+    }
+
     void RcfSession::clearParameters()
     {
         if (mpParameters)
@@ -160,8 +170,50 @@ namespace RCF {
             mpParameters->~I_Parameters();
             mpParameters = NULL;
         }
+
+#if RCF_FEATURE_PROTOBUF==1
+
+        // Nothing refers to messages on the arena once the parameters are gone.
+        if (mProtobufArenaPtr)
+        {
+            mProtobufArenaPtr->Reset();
+        }
+
+#endif
+    }
+
+#if RCF_FEATURE_PROTOBUF==1
+
+    static const std::size_t ProtobufArenaInitialBlockSize = 16*1024;
+
+    google::protobuf::Arena * RcfSession::getProtobufArena()
+    {
+        if (!mEnableProtobufArena)
+        {
+            return NULL;
+        }
+
+        if (!mProtobufArenaPtr)
+        {
+            mProtobufArenaBlock.resize(ProtobufArenaInitialBlockSize);
+
+            google::protobuf::ArenaOptions options;
+            options.initial_block = &mProtobufArenaBlock[0];
+            options.initial_block_size = mProtobufArenaBlock.size();
+            mProtobufArenaPtr.reset( new google::protobuf::Arena(options) );
+        }
+
+        return mProtobufArenaPtr.get();
     }
 
+    google::protobuf::Arena * getCurrentProtobufArena()
+    {
+        RcfSession * pSession = getTlsRcfSessionPtr();
+        return pSession ? pSession->getProtobufArena() : NULL;
+    }
+
+#endif
+
     void RcfSession::setOnDestroyCallback(OnDestroyCallback onDestroyCallback)
     {
         Lock lock(mMutex);
@@ -222,6 +274,61 @@ namespace RCF {
         mCachedStubEntryPtr = stubEntryPtr;
     }
 
+    // Limits the size of the binding table a client can build up on a session.
+    static const std::size_t MaxBindingsPerSession = 1024;
+
+    int RcfSession::getBindingId(const std::string & bindingName)
+    {
+        for (std::size_t i=0; i<mBindings.size(); ++i)
+        {
+            if (mBindings[i].mBindingName == bindingName)
+            {
+                return static_cast<int>(i+1);
+            }
+        }
+
+        if (mBindings.size() >= MaxBindingsPerSession)
+        {
+            // Client will keep using the binding name.
+            return 0;
+        }
+
+        mBindings.push_back( BindingEntry() );
+        mBindings.back().mBindingName = bindingName;
+        return static_cast<int>(mBindings.size());
+    }
+
+    bool RcfSession::getBindingName(int bindingId, std::string & bindingName)
+    {
+        if (1 <= bindingId && static_cast<std::size_t>(bindingId) <= mBindings.size())
+        {
+            bindingName = mBindings[bindingId-1].mBindingName;
+            return true;
+        }
+        return false;
+    }
+
+    RcfClientPtr RcfSession::getBoundStubEntryPtr(int bindingId)
+    {
+        if (bindingId < 1 || static_cast<std::size_t>(bindingId) > mBindings.size())
+        {
+            return RcfClientPtr();
+        }
+
+        // Look the binding up again if any servants have been bound or unbound since it was last resolved.
+        BindingEntry & entry = mBindings[bindingId-1];
+        std::uint32_t stubMapGeneration = mRcfServer.mStubMapGeneration.load();
+        if (entry.mStubMapGeneration != stubMapGeneration)
+        {
+            ReadLock readLock(mRcfServer.mStubMapMutex);
+            RcfServer::StubMap::iterator iter = mRcfServer.mStubMap.find(entry.mBindingName);
+            entry.mStubEntryPtr = iter != mRcfServer.mStubMap.end() ? iter->second : RcfClientPtr();
+            entry.mStubMapGeneration = mRcfServer.mStubMapGeneration.load();
+        }
+
+        return entry.mStubEntryPtr;
+    }
+
     void RcfSession::getMessageFilters(std::vector<FilterPtr> &filters) const
     {
         filters = mFilters;
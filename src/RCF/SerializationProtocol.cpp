@@ -19,6 +19,7 @@
 #include <RCF/SerializationProtocol.hpp>
 
 #include <RCF/Config.hpp>
+#include <RCF/Marshal.hpp>
 #include <RCF/ObjectPool.hpp>
 #include <RCF/Version.hpp>
 
@@ -68,6 +69,7 @@ namespace RCF {
 
     SerializationProtocolIn::SerializationProtocolIn() :
         mProtocol(DefaultSerializationProtocol),
+        mArchiveLength(0),
         mRuntimeVersion( RCF::getRuntimeVersion() ),
         mArchiveVersion( RCF::getArchiveVersion() )
     {
@@ -95,7 +97,17 @@ namespace RCF {
 
     static const char chZero = 0;
 
-    void SerializationProtocolIn::reset(const ByteBuffer &data, int protocol, int runtimeVersion, int archiveVersion, bool enableSfPointerTracking)
+    // SF reads the archive metadata at the start of the archive with readsome(), which only returns data that 
+    // has already been received.
+    static const std::size_t MaxArchiveMetadataLen = 16;
+
+    void SerializationProtocolIn::reset(
+        const ByteBuffer &      data, 
+        int                     protocol, 
+        int                     runtimeVersion, 
+        int                     archiveVersion, 
+        bool                    enableSfPointerTracking,
+        MemIstreamSourcePtr     sourcePtr)
     {
         mRuntimeVersion = runtimeVersion;
         mArchiveVersion = archiveVersion;
@@ -103,8 +115,22 @@ namespace RCF {
         unbindProtocol();
 
         mByteBuffer = data;
+        mChunks.resize(0);
+        mArchiveLength = mByteBuffer.getLength();
+        mSourcePtr = mByteBuffer ? sourcePtr : MemIstreamSourcePtr();
 
-        if (mByteBuffer)
+        if (mByteBuffer && mSourcePtr)
+        {
+            // The data is still arriving, and will be deserialized as it does.
+            std::size_t metadataLen = RCF_MIN(mByteBuffer.getLength(), MaxArchiveMetadataLen);
+            mSourcePtr->waitForData(mByteBuffer.getPtr() + metadataLen);
+
+            mIs.reset(
+                mByteBuffer.getPtr(),
+                mByteBuffer.getLength(),
+                mSourcePtr.get());
+        }
+        else if (mByteBuffer)
         {
             mIs.reset(
                 mByteBuffer.getPtr(),
@@ -118,6 +144,48 @@ namespace RCF {
         setSerializationProtocol(protocol);
         bindProtocol();
 
+#if RCF_FEATURE_SF==1
+        if (protocol == Sp_SfBinary)
+        {
+            mInProtocol1.getIStream().setEnablePointerTracking(enableSfPointerTracking);
+        }
+#endif
+
+    }
+
+    void SerializationProtocolIn::reset(
+        const std::vector<ByteBuffer> & chunks, 
+        int                             protocol, 
+        int                             runtimeVersion, 
+        int                             archiveVersion, 
+        bool                            enableSfPointerTracking)
+    {
+        if (chunks.size() <= 1)
+        {
+            reset(
+                chunks.empty() ? ByteBuffer() : chunks.front(), 
+                protocol, 
+                runtimeVersion, 
+                archiveVersion, 
+                enableSfPointerTracking);
+
+            return;
+        }
+
+        mRuntimeVersion = runtimeVersion;
+        mArchiveVersion = archiveVersion;
+
+        unbindProtocol();
+
+        mByteBuffer.clear();
+        mSourcePtr.reset();
+        mChunks.assign(chunks.begin(), chunks.end());
+        mArchiveLength = lengthByteBuffers(mChunks);
+        mIs.reset(mChunks);
+
+        setSerializationProtocol(protocol);
+        bindProtocol();
+
 #if RCF_FEATURE_SF==1
         if (protocol == Sp_SfBinary)
         {
@@ -129,7 +197,7 @@ namespace RCF {
 
     void SerializationProtocolIn::bindProtocol()
     {
-        std::size_t archiveLength = mByteBuffer.getLength();
+        std::size_t archiveLength = mArchiveLength;
         switch (mProtocol)
         {
         case 1: mInProtocol1.bind(mIs, archiveLength, mRuntimeVersion, mArchiveVersion, *this); break;
@@ -166,24 +234,63 @@ namespace RCF {
         {
             std::size_t pos = static_cast<std::size_t>(mIs.getReadPos());
             mIs.moveReadPos(pos+len);
-            byteBuffer = ByteBuffer(mByteBuffer, pos, len);
+
+            if (mChunks.empty())
+            {
+                byteBuffer = ByteBuffer(mByteBuffer, pos, len);
+            }
+            else
+            {
+                extractChunkSlice(byteBuffer, pos, len);
+            }
+        }
+    }
+
+    void SerializationProtocolIn::extractChunkSlice(
+        ByteBuffer &byteBuffer,
+        std::size_t pos,
+        std::size_t len)
+    {
+        RCF_VERIFY(pos + len <= mArchiveLength, Exception(RcfError_SfReadFailure));
+
+        std::size_t chunkOffset = 0;
+        for (std::size_t i=0; i<mChunks.size(); ++i)
+        {
+            const ByteBuffer & chunk = mChunks[i];
+            if (pos < chunkOffset + chunk.getLength())
+            {
+                if (pos + len <= chunkOffset + chunk.getLength())
+                {
+                    byteBuffer = ByteBuffer(chunk, pos - chunkOffset, len);
+                }
+                else
+                {
+                    // The slice crosses a chunk boundary, so it needs to be copied.
+                    std::vector<ByteBuffer> slices;
+                    sliceByteBuffers(slices, mChunks, pos, len);
+                    copyByteBuffers(slices, byteBuffer);
+                }
+                return;
+            }
+            chunkOffset += chunk.getLength();
         }
     }
 
     void SerializationProtocolIn::clearByteBuffer()
     {
         mByteBuffer = ByteBuffer();
+        mChunks.resize(0);
     }
 
     std::size_t SerializationProtocolIn::getArchiveLength()
     {
-        return mByteBuffer.getLength();
+        return mArchiveLength;
     }
 
     std::size_t SerializationProtocolIn::getRemainingArchiveLength()
     {
         std::size_t pos = static_cast<std::size_t>(mIs.getReadPos());
-        std::size_t len = mByteBuffer.getLength();
+        std::size_t len = mArchiveLength;
         RCF_ASSERT(pos <= len);
         return len - pos;
     }
@@ -202,7 +309,8 @@ namespace RCF {
         mProtocol(DefaultSerializationProtocol),
         mMargin(),
         mRuntimeVersion( RCF::getRuntimeVersion() ),
-        mArchiveVersion( RCF::getArchiveVersion() )
+        mArchiveVersion( RCF::getArchiveVersion() ),
+        mSizing(false)
     {}
 
     void SerializationProtocolOut::setSerializationProtocol(int protocol)
@@ -226,6 +334,7 @@ namespace RCF {
 
         mRuntimeVersion = runtimeVersion;
         mArchiveVersion = archiveVersion;
+        mSizing = false;
 
         unbindProtocol();
         if (!mOsPtr)
@@ -296,10 +405,79 @@ namespace RCF {
 
     void SerializationProtocolOut::insert(const ByteBuffer &byteBuffer)
     {
+        if (mSizing)
+        {
+            // Inserted buffers are sent as is, so they don't count towards the message buffer.
+            return;
+        }
+
         std::size_t streamPos = static_cast<std::size_t>(mOsPtr->tellp());
         mByteBuffers.push_back( std::make_pair(streamPos, byteBuffer));
     }
 
+    void SerializationProtocolOut::reserve(std::size_t len)
+    {
+        std::size_t pos = static_cast<std::size_t>(mOsPtr->tellp());
+        mOsPtr->reserve(pos + len);
+    }
+
+    bool SerializationProtocolOut::beginSizing()
+    {
+#if RCF_FEATURE_SF==1
+        if (mProtocol == Sp_SfBinary)
+        {
+            if (!mCountingOsPtr)
+            {
+                mCountingOsPtr.reset( new CountingOstream() );
+            }
+            mCountingOsPtr->resetCount();
+
+            mOutProtocol1.bind(*mCountingOsPtr, mRuntimeVersion, mArchiveVersion, *this);
+            mSizing = true;
+            return true;
+        }
+#endif
+
+        return false;
+    }
+
+    std::size_t SerializationProtocolOut::endSizing()
+    {
+        RCF_ASSERT(mSizing);
+        mSizing = false;
+        bindProtocol();
+        return mCountingOsPtr->getCount();
+    }
+
+    void SerializationProtocolOut::writeParameters(
+        I_Parameters & parameters, 
+        int fnId, 
+        bool enableSizing)
+    {
+        if (!enableSizing)
+        {
+            parameters.write(*this);
+            return;
+        }
+
+        std::size_t sizeHint = 0;
+        std::map<int, std::size_t>::iterator iter = mSizeHints.find(fnId);
+        if (iter != mSizeHints.end())
+        {
+            sizeHint = iter->second;
+        }
+        else if (beginSizing())
+        {
+            parameters.write(*this);
+            sizeHint = endSizing();
+        }
+
+        std::size_t startPos = static_cast<std::size_t>(mOsPtr->tellp());
+        reserve(sizeHint);
+        parameters.write(*this);
+        mSizeHints[fnId] = static_cast<std::size_t>(mOsPtr->tellp()) - startPos;
+    }
+
     void SerializationProtocolOut::extractByteBuffers()
     {
         mByteBuffers.resize(0);
@@ -39,6 +39,35 @@ namespace RCF {
     }
 
 
+#if RCF_FEATURE_PROTOBUF==1
+
+    void ServerBinding::setEnableProtobufArena(bool enable)
+    {
+        Lock lock(mMutex);
+        mEnableProtobufArena = enable;
+    }
+
+    bool ServerBinding::getEnableProtobufArena()
+    {
+        Lock lock(mMutex);
+        return mEnableProtobufArena;
+    }
+
+    void ServerBinding::setProtobufArenaOptOut(int fnId, bool optOut)
+    {
+        Lock lock(mMutex);
+        if (optOut)
+        {
+            mProtobufArenaOptOuts.insert(fnId);
+        }
+        else
+        {
+            mProtobufArenaOptOuts.erase(fnId);
+        }
+    }
+
+#endif
+
     void ServerBinding::callMethod(
         int                         fnId,
         RcfSession &                session)
@@ -55,8 +84,19 @@ namespace RCF {
                     RCF_THROW( RCF::Exception(RcfError_ServerStubAccessDenied));
                 }
             }
+
+#if RCF_FEATURE_PROTOBUF==1
+            session.mEnableProtobufArena = 
+                    mEnableProtobufArena 
+                &&  mProtobufArenaOptOuts.find(fnId) == mProtobufArenaOptOuts.end();
+#endif
         }
 
+#if RCF_FEATURE_PROTOBUF==1
+        // The arena is only for the parameters of this call.
+        ScopeGuard arenaGuard([&]() { session.mEnableProtobufArena = false; });
+#endif
+
         // No mutex here, since there is never anyone writing to mServerMethodMap.
 
         mServerMethodPtr->callMethod(fnId, session);
@@ -19,6 +19,7 @@
 #include <RCF/ServerTransport.hpp>
 
 #include <RCF/Enums.hpp>
+#include <RCF/MessageFraming.hpp>
 #include <RCF/Service.hpp>
 
 namespace RCF {
@@ -29,7 +30,9 @@ namespace RCF {
         mReadWriteMutex(),
         mMaxMessageLength(getDefaultMaxMessageLength()),
         mConnectionLimit(0),
-        mInitialNumberOfConnections(1)
+        mInitialNumberOfConnections(1),
+        mIncrementalReadThreshold(0),
+        mMessageChunkSize(DefaultMessageChunkSize)
     {}
 
     void ServerTransport::setMaxIncomingMessageLength(std::size_t maxMessageLength)
@@ -70,6 +73,31 @@ namespace RCF {
         mInitialNumberOfConnections = initialNumberOfConnections;
     }
 
+    std::size_t ServerTransport::getIncrementalReadThreshold() const
+    {
+        ReadLock readLock(mReadWriteMutex);
+        return mIncrementalReadThreshold;
+    }
+
+    void ServerTransport::setIncrementalReadThreshold(
+        std::size_t messageLength)
+    {
+        WriteLock writeLock(mReadWriteMutex);
+        mIncrementalReadThreshold = messageLength;
+    }
+
+    void ServerTransport::setMessageChunkSize(std::size_t chunkSize)
+    {
+        WriteLock writeLock(mReadWriteMutex);
+        mMessageChunkSize = chunkSize;
+    }
+
+    std::size_t ServerTransport::getMessageChunkSize() const
+    {
+        ReadLock readLock(mReadWriteMutex);
+        return mMessageChunkSize;
+    }
+
     void ServerTransport::setRpcProtocol(RpcProtocol rpcProtocol)
     {
         mRpcProtocol = rpcProtocol;
@@ -136,6 +164,16 @@ namespace RCF {
         filters.clear();
     }
 
+    MemIstreamSourcePtr NetworkSession::getIncrementalReadSource()
+    {
+        return MemIstreamSourcePtr();
+    }
+
+    void NetworkSession::getReadChunks(std::vector<ByteBuffer> & chunks)
+    {
+        chunks.resize(0);
+    }
+
     void NetworkSession::setEnableReconnect(bool enableReconnect)
     {
         mEnableReconnect = enableReconnect;
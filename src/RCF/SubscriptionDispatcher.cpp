@@ -0,0 +1,483 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#include <RCF/SubscriptionDispatcher.hpp>
+
+#include <chrono>
+
+#include <RCF/Exception.hpp>
+#include <RCF/IpAddress.hpp>
+#include <RCF/MethodInvocation.hpp>
+#include <RCF/RcfServer.hpp>
+#include <RCF/RcfSession.hpp>
+#include <RCF/ServerTransport.hpp>
+#include <RCF/SubscriptionService.hpp>
+#include <RCF/Log.hpp>
+
+namespace RCF {
+
+    // Network session that a queued message is dispatched on. It presents the message as if it had just been 
+    // read, and discards anything written, as only oneway messages are dispatched.
+    class DispatchNetworkSession : public NetworkSession
+    {
+    public:
+
+        DispatchNetworkSession(
+            ServerTransport &           transport, 
+            std::shared_ptr<IpAddress>  ipAddressPtr) :
+                mTransport(transport),
+                mIpAddressPtr(ipAddressPtr)
+        {
+        }
+
+        ByteBuffer                      mMessage;
+
+    private:
+
+        friend class SubscriptionDispatchQueue;
+
+        ServerTransport &               mTransport;
+        std::shared_ptr<IpAddress>      mIpAddressPtr;
+        NoRemoteAddress                 mNoRemoteAddress;
+
+        void postRead()
+        {
+        }
+
+        ByteBuffer getReadByteBuffer()
+        {
+            return mMessage;
+        }
+
+        void postWrite(std::vector<ByteBuffer> & byteBuffers)
+        {
+            byteBuffers.resize(0);
+        }
+
+        void postClose()
+        {
+        }
+
+        ServerTransport & getServerTransport()
+        {
+            return mTransport;
+        }
+
+        const RemoteAddress & getRemoteAddress()
+        {
+            if (mIpAddressPtr)
+            {
+                return *mIpAddressPtr;
+            }
+            return mNoRemoteAddress;
+        }
+
+        bool isConnected()
+        {
+            return true;
+        }
+
+        void setTransportFilters(const std::vector<FilterPtr> & filters)
+        {
+            RCF_UNUSED_VARIABLE(filters);
+        }
+
+        void getTransportFilters(std::vector<FilterPtr> & filters)
+        {
+            filters.clear();
+        }
+    };
+
+    // Messages of one ordering key of a subscription.
+    class DispatchStrand
+    {
+    public:
+
+        DispatchStrand(SubscriptionDispatchQueuePtr queuePtr, const std::string & key) : 
+            mQueuePtr(queuePtr), 
+            mKey(key),
+            mScheduled(false)
+        {
+        }
+
+        struct QueuedMessage
+        {
+            ByteBuffer          mMessage;
+            std::uint32_t       mQueuedAtMs;
+        };
+
+        SubscriptionDispatchQueuePtr    mQueuePtr;
+        std::string                     mKey;
+        std::deque<QueuedMessage>       mMessages;
+
+        // Set while the strand is waiting on the dispatcher, or being dispatched.
+        bool                            mScheduled;
+    };
+
+    SubscriptionDispatcher::SubscriptionDispatcher(std::size_t threadCount) : 
+        mThreadCount(threadCount),
+        mThreadPool(threadCount)
+    {
+        RCF_ASSERT(threadCount > 0);
+
+        mThreadPool.setThreadName("RCF Subscription Dispatch");
+
+        mThreadPool.setTask( std::bind(
+            &SubscriptionDispatcher::dispatchTask,
+            this));
+
+        mThreadPool.setStopFunctor( std::bind(
+            &SubscriptionDispatcher::stopDispatchTask,
+            this));
+    }
+
+    SubscriptionDispatcher::~SubscriptionDispatcher()
+    {
+        RCF_DTOR_BEGIN
+            stop();
+        RCF_DTOR_END
+    }
+
+    std::size_t SubscriptionDispatcher::getThreadCount() const
+    {
+        return mThreadCount;
+    }
+
+    void SubscriptionDispatcher::stop()
+    {
+        mThreadPool.stop();
+
+        Lock lock(mMutex);
+        mReadyStrands.clear();
+    }
+
+    void SubscriptionDispatcher::schedule(DispatchStrandPtr strandPtr)
+    {
+        Lock lock(mMutex);
+
+        // Lazy start of the thread pool.
+        if (!mThreadPool.isStarted())
+        {
+            mThreadPool.start();
+        }
+
+        mReadyStrands.push_back(strandPtr);
+        mCondition.notify_one();
+    }
+
+    void SubscriptionDispatcher::unschedule(SubscriptionDispatchQueue * pQueue)
+    {
+        Lock lock(mMutex);
+        for (std::size_t i = 0; i < mReadyStrands.size(); )
+        {
+            if (mReadyStrands[i]->mQueuePtr.get() == pQueue)
+            {
+                mReadyStrands.erase(mReadyStrands.begin() + i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    bool SubscriptionDispatcher::dispatchTask()
+    {
+        DispatchStrandPtr strandPtr;
+        SubscriptionDispatchQueuePtr queuePtr;
+
+        {
+            Lock lock(mMutex);
+            while (mReadyStrands.empty() && !mThreadPool.shouldStop())
+            {
+                using namespace std::chrono_literals;
+                mCondition.wait_for(lock, 1000ms);
+            }
+            if (mReadyStrands.empty() || mThreadPool.shouldStop())
+            {
+                return false;
+            }
+            strandPtr = mReadyStrands.front();
+            mReadyStrands.pop_front();
+            queuePtr = strandPtr->mQueuePtr;
+        }
+
+        queuePtr->dispatch(strandPtr);
+        return false;
+    }
+
+    void SubscriptionDispatcher::stopDispatchTask()
+    {
+        Lock lock(mMutex);
+        mCondition.notify_all();
+    }
+
+    SubscriptionDispatchQueue::SubscriptionDispatchQueue(
+        RcfServer &                 server,
+        SubscriptionDispatcherPtr   dispatcherPtr,
+        DispatchOrdering            ordering,
+        std::size_t                 queueLimit,
+        RcfClientPtr                rcfClientPtr) :
+            mServer(server),
+            mDispatcherPtr(dispatcherPtr),
+            mOrdering(ordering),
+            mQueueLimit(queueLimit),
+            mRcfClientPtr(rcfClientPtr),
+            mClosed(false),
+            mpServerTransport(NULL),
+            mTransportProtocol(Tp_Clear),
+            mPaused(false),
+            mQueueDepth(0),
+            mDispatchedCount(0),
+            mLastLagMs(0),
+            mMaxLagMs(0)
+    {
+    }
+
+    SubscriptionDispatchQueue::~SubscriptionDispatchQueue()
+    {
+    }
+
+    bool SubscriptionDispatchQueue::push(RcfSession & session, const ByteBuffer & message)
+    {
+        DispatchStrandPtr strandPtr;
+        bool readMore = true;
+
+        {
+            Lock lock(mMutex);
+
+            if (mClosed)
+            {
+                return true;
+            }
+
+            if (!mpServerTransport)
+            {
+                NetworkSession & networkSession = session.getNetworkSession();
+                mpServerTransport = &networkSession.getServerTransport();
+
+                const IpAddress * pIpAddress = 
+                    dynamic_cast<const IpAddress *>(&networkSession.getRemoteAddress());
+
+                if (pIpAddress)
+                {
+                    mIpAddressPtr.reset( new IpAddress(*pIpAddress) );
+                }
+
+                mTransportProtocol = session.getTransportProtocol();
+            }
+
+            // Messages without a key are ordered together.
+            std::string key;
+            if (mOrdering == Do_PerKey)
+            {
+                key = session.mRequest.getMessageKey();
+            }
+
+            DispatchStrandPtr & keyStrandPtr = mStrands[key];
+            if (!keyStrandPtr)
+            {
+                keyStrandPtr.reset( new DispatchStrand(shared_from_this(), key) );
+            }
+
+            DispatchStrand::QueuedMessage queuedMessage;
+            queuedMessage.mMessage = message;
+            queuedMessage.mQueuedAtMs = getCurrentTimeMs();
+            keyStrandPtr->mMessages.push_back(queuedMessage);
+            ++mQueueDepth;
+
+            if (!keyStrandPtr->mScheduled)
+            {
+                keyStrandPtr->mScheduled = true;
+                strandPtr = keyStrandPtr;
+            }
+
+            // Datagrams can't be held back, so multicast subscriptions are never paused.
+            if (    mQueueLimit > 0
+                &&  mQueueDepth >= mQueueLimit 
+                &&  session.getTransportType() != Tt_Udp)
+            {
+                RCF_LOG_3()(this)(mQueueDepth) << "SubscriptionDispatchQueue - queue full, pausing reads.";
+                mPaused = true;
+                mPausedNetworkSessionPtr = session.getNetworkSession().shared_from_this();
+                readMore = false;
+            }
+        }
+
+        if (strandPtr)
+        {
+            mDispatcherPtr->schedule(strandPtr);
+        }
+
+        return readMore;
+    }
+
+    DispatchNetworkSessionPtr SubscriptionDispatchQueue::createDispatchSession()
+    {
+        DispatchNetworkSessionPtr networkSessionPtr( 
+            new DispatchNetworkSession(*mpServerTransport, mIpAddressPtr) );
+
+        RcfSessionPtr rcfSessionPtr = mServer.createSession();
+        rcfSessionPtr->setNetworkSession(*networkSessionPtr);
+        rcfSessionPtr->setDefaultStubEntryPtr(mRcfClientPtr);
+        rcfSessionPtr->mTransportProtocol = mTransportProtocol;
+
+        networkSessionPtr->mRcfSessionPtr = rcfSessionPtr;
+        return networkSessionPtr;
+    }
+
+    void SubscriptionDispatchQueue::dispatch(DispatchStrandPtr strandPtr)
+    {
+        DispatchNetworkSessionPtr networkSessionPtr;
+        NetworkSessionPtr pausedNetworkSessionPtr;
+
+        {
+            Lock lock(mMutex);
+
+            if (mClosed || strandPtr->mMessages.empty())
+            {
+                return;
+            }
+
+            DispatchStrand::QueuedMessage & queuedMessage = strandPtr->mMessages.front();
+
+            if (!mIdleSessions.empty())
+            {
+                networkSessionPtr = mIdleSessions.back();
+                mIdleSessions.pop_back();
+            }
+            else
+            {
+                networkSessionPtr = createDispatchSession();
+            }
+
+            networkSessionPtr->mMessage = queuedMessage.mMessage;
+            
+            mLastLagMs = getCurrentTimeMs() - queuedMessage.mQueuedAtMs;
+            mMaxLagMs = RCF_MAX(mMaxLagMs, mLastLagMs);
+
+            strandPtr->mMessages.pop_front();
+            --mQueueDepth;
+
+            if (mPaused && mQueueDepth <= mQueueLimit/2)
+            {
+                RCF_LOG_3()(this)(mQueueDepth) << "SubscriptionDispatchQueue - queue drained, resuming reads.";
+                mPaused = false;
+                pausedNetworkSessionPtr.swap(mPausedNetworkSessionPtr);
+            }
+
+            mDispatchingThreads.push_back( getCurrentThreadId() );
+        }
+
+        if (pausedNetworkSessionPtr)
+        {
+            RcfSessionPtr pausedSessionPtr = pausedNetworkSessionPtr->getSessionPtr();
+            if (pausedSessionPtr)
+            {
+                pausedSessionPtr->onWriteCompleted();
+            }
+        }
+
+        try
+        {
+            mServer.onReadCompleted(networkSessionPtr->mRcfSessionPtr);
+        }
+        catch(const std::exception & e)
+        {
+            RCF_LOG_1()(e.what()) << "SubscriptionDispatchQueue - exception while dispatching message.";
+        }
+
+        networkSessionPtr->mMessage.clear();
+
+        bool reschedule = false;
+
+        {
+            Lock lock(mMutex);
+
+            eraseRemove(mDispatchingThreads, getCurrentThreadId());
+            mCondition.notify_all();
+
+            ++mDispatchedCount;
+
+            if (mClosed)
+            {
+                return;
+            }
+
+            mIdleSessions.push_back(networkSessionPtr);
+
+            if (!strandPtr->mMessages.empty())
+            {
+                reschedule = true;
+            }
+            else
+            {
+                strandPtr->mScheduled = false;
+                mStrands.erase(strandPtr->mKey);
+            }
+        }
+
+        // The strand goes to the back of the ready list, so busy keys don't starve the others.
+        if (reschedule)
+        {
+            mDispatcherPtr->schedule(strandPtr);
+        }
+    }
+
+    void SubscriptionDispatchQueue::close()
+    {
+        Strands strands;
+        std::vector<DispatchNetworkSessionPtr> idleSessions;
+        NetworkSessionPtr pausedNetworkSessionPtr;
+
+        {
+            Lock lock(mMutex);
+            mClosed = true;
+            strands.swap(mStrands);
+            idleSessions.swap(mIdleSessions);
+            mQueueDepth = 0;
+            mPaused = false;
+            pausedNetworkSessionPtr.swap(mPausedNetworkSessionPtr);
+        }
+
+        // Strands hold a reference to the queue, so are released here, along with any messages they still hold.
+        mDispatcherPtr->unschedule(this);
+        strands.clear();
+
+        // Wait for messages being dispatched, unless it's being closed from within a dispatch.
+        Lock lock(mMutex);
+        ThreadId threadId = getCurrentThreadId();
+        while (     !mDispatchingThreads.empty() 
+                &&  !(mDispatchingThreads.size() == 1 && mDispatchingThreads.front() == threadId))
+        {
+            using namespace std::chrono_literals;
+            mCondition.wait_for(lock, 1000ms);
+        }
+    }
+
+    void SubscriptionDispatchQueue::getStats(SubscriptionDispatchStats & stats)
+    {
+        Lock lock(mMutex);
+        stats.mQueueDepth       = mQueueDepth;
+        stats.mDispatchedCount  = mDispatchedCount;
+        stats.mLastLagMs        = mLastLagMs;
+        stats.mMaxLagMs         = mMaxLagMs;
+        stats.mReadPaused       = mPaused;
+    }
+
+} // namespace RCF
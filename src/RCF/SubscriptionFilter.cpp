@@ -0,0 +1,117 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#include <RCF/SubscriptionFilter.hpp>
+
+#include <RCF/Exception.hpp>
+
+#include <SF/Encoding.hpp>
+
+namespace RCF {
+
+    void SubscriptionFilter::addKey(const std::string & key)
+    {
+        mKeys.insert(key);
+    }
+
+    void SubscriptionFilter::addKeyRange(const std::string & firstKey, const std::string & lastKey)
+    {
+        RCF_ASSERT(firstKey <= lastKey);
+        mKeyRanges.push_back( std::make_pair(firstKey, lastKey) );
+    }
+
+    bool SubscriptionFilter::isEmpty() const
+    {
+        return mKeys.empty() && mKeyRanges.empty();
+    }
+
+    bool SubscriptionFilter::matches(const std::string & key) const
+    {
+        if (isEmpty() || mKeys.find(key) != mKeys.end())
+        {
+            return true;
+        }
+
+        for (std::size_t i=0; i<mKeyRanges.size(); ++i)
+        {
+            if (mKeyRanges[i].first <= key && key <= mKeyRanges[i].second)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    const std::set<std::string> & SubscriptionFilter::getKeys() const
+    {
+        return mKeys;
+    }
+
+    const std::vector< std::pair<std::string, std::string> > & SubscriptionFilter::getKeyRanges() const
+    {
+        return mKeyRanges;
+    }
+
+    void SubscriptionFilter::encode(std::vector<char> & vec, std::size_t & pos) const
+    {
+        SF::encodeInt(static_cast<int>(mKeys.size()), vec, pos);
+        std::set<std::string>::const_iterator iter;
+        for (iter = mKeys.begin(); iter != mKeys.end(); ++iter)
+        {
+            SF::encodeString(*iter, vec, pos);
+        }
+
+        SF::encodeInt(static_cast<int>(mKeyRanges.size()), vec, pos);
+        for (std::size_t i=0; i<mKeyRanges.size(); ++i)
+        {
+            SF::encodeString(mKeyRanges[i].first, vec, pos);
+            SF::encodeString(mKeyRanges[i].second, vec, pos);
+        }
+    }
+
+    void SubscriptionFilter::decode(const ByteBuffer & buffer, std::size_t & pos)
+    {
+        mKeys.clear();
+        mKeyRanges.clear();
+
+        // Each string takes at least one byte, which bounds the counts.
+        std::uint32_t keyCount = 0;
+        SF::decodeInt(keyCount, buffer, pos);
+        RCF_VERIFY(keyCount <= buffer.getLength() - pos, Exception(RcfError_Decoding));
+        for (std::uint32_t i=0; i<keyCount; ++i)
+        {
+            std::string key;
+            SF::decodeString(key, buffer, pos);
+            mKeys.insert(key);
+        }
+
+        std::uint32_t rangeCount = 0;
+        SF::decodeInt(rangeCount, buffer, pos);
+        RCF_VERIFY(rangeCount <= buffer.getLength() - pos, Exception(RcfError_Decoding));
+        for (std::uint32_t i=0; i<rangeCount; ++i)
+        {
+            std::string firstKey;
+            std::string lastKey;
+            SF::decodeString(firstKey, buffer, pos);
+            SF::decodeString(lastKey, buffer, pos);
+            mKeyRanges.push_back( std::make_pair(firstKey, lastKey) );
+        }
+    }
+
+} // namespace RCF
@@ -28,14 +28,37 @@
 #include <RCF/ClientTransport.hpp>
 #include <RCF/Endpoint.hpp>
 #include <RCF/Future.hpp>
+#include <RCF/MulticastReceiver.hpp>
 #include <RCF/RcfClient.hpp>
 #include <RCF/RcfServer.hpp>
 #include <RCF/RcfSession.hpp>
+#include <RCF/SubscriptionDispatcher.hpp>
 #include <RCF/Log.hpp>
 
 namespace RCF {
 
-    SubscriptionParms::SubscriptionParms() : mClientStub("")
+    MulticastReceiveStats::MulticastReceiveStats() :
+        mReceivedCount(0),
+        mRecoveredCount(0),
+        mLostCount(0),
+        mDiscardedCount(0)
+    {
+    }
+
+    SubscriptionDispatchStats::SubscriptionDispatchStats() :
+        mQueueDepth(0),
+        mDispatchedCount(0),
+        mLastLagMs(0),
+        mMaxLagMs(0),
+        mReadPaused(false)
+    {
+    }
+
+    SubscriptionParms::SubscriptionParms() : 
+        mClientStub(""), 
+        mMulticastRetransmit(true),
+        mDispatchOrdering(Do_PerSubscription),
+        mDispatchQueueLimit(1000)
     {
     }
 
@@ -70,6 +93,39 @@ namespace RCF {
         mOnAsyncSubscribeCompleted = onAsyncSubscribeCompleted;
     }
 
+    void SubscriptionParms::setFilter(const SubscriptionFilter & filter)
+    {
+        mFilter = filter;
+    }
+
+    const SubscriptionFilter & SubscriptionParms::getFilter() const
+    {
+        return mFilter;
+    }
+
+    void SubscriptionParms::setMulticastEndpoint(const Endpoint & groupEp)
+    {
+        mMulticastEndpointPtr = groupEp.clone();
+    }
+
+    void SubscriptionParms::setMulticastRetransmit(bool enable)
+    {
+        mMulticastRetransmit = enable;
+    }
+
+    void SubscriptionParms::setDispatcher(
+        SubscriptionDispatcherPtr   dispatcherPtr, 
+        DispatchOrdering            ordering)
+    {
+        mDispatcherPtr = dispatcherPtr;
+        mDispatchOrdering = ordering;
+    }
+
+    void SubscriptionParms::setDispatchQueueLimit(std::size_t queueLimit)
+    {
+        mDispatchQueueLimit = queueLimit;
+    }
+
     Subscription::~Subscription()
     {
         RCF_DTOR_BEGIN
@@ -114,6 +170,9 @@ namespace RCF {
     {
         RCF_ASSERT(mThisWeakPtr != SubscriptionWeakPtr());
 
+        MulticastReceiverPtr multicastReceiverPtr;
+        SubscriptionDispatchQueuePtr dispatchQueuePtr;
+
         {
             RecursiveLock lock(mMutex);
 
@@ -143,6 +202,9 @@ namespace RCF {
             }
 
             mRcfSessionWeakPtr.reset();
+
+            multicastReceiverPtr.swap(mMulticastReceiverPtr);
+            dispatchQueuePtr.swap(mDispatchQueuePtr);
             
             if ( mConnectionPtr )
             {
@@ -152,9 +214,73 @@ namespace RCF {
             mClosed = true;
         }
 
+        // Stopping the receiver waits for any message being dispatched from the multicast group, and is done 
+        // without holding the lock, as the dispatch may call into this subscription.
+        multicastReceiverPtr.reset();
+
+        // Likewise, closing the dispatch queue waits for messages being dispatched on the dispatcher.
+        if (dispatchQueuePtr)
+        {
+            dispatchQueuePtr->close();
+        }
+
         mSubscriptionService.closeSubscription(mThisWeakPtr);
     }
 
+    bool Subscription::isMulticastDelivery()
+    {
+        RecursiveLock lock(mMutex);
+        return mMulticastReceiverPtr.get() != NULL;
+    }
+
+    void Subscription::getMulticastReceiveStats(MulticastReceiveStats & stats)
+    {
+        RecursiveLock lock(mMutex);
+        stats = MulticastReceiveStats();
+
+#if RCF_FEATURE_UDP==1
+        if (mMulticastReceiverPtr)
+        {
+            mMulticastReceiverPtr->getStats(stats);
+        }
+#endif
+    }
+
+    void Subscription::getDispatchStats(SubscriptionDispatchStats & stats)
+    {
+        RecursiveLock lock(mMutex);
+        stats = SubscriptionDispatchStats();
+        if (mDispatchQueuePtr)
+        {
+            mDispatchQueuePtr->getStats(stats);
+        }
+    }
+
+    void Subscription::setDispatchQueue(SubscriptionDispatchQueuePtr dispatchQueuePtr)
+    {
+        RecursiveLock lock(mMutex);
+
+        if (mClosed)
+        {
+            return;
+        }
+
+        mDispatchQueuePtr = dispatchQueuePtr;
+
+        RcfSessionPtr rcfSessionPtr(mRcfSessionWeakPtr.lock());
+        if (rcfSessionPtr)
+        {
+            rcfSessionPtr->setDispatchQueue(dispatchQueuePtr);
+        }
+
+#if RCF_FEATURE_UDP==1
+        if (mMulticastReceiverPtr)
+        {
+            mMulticastReceiverPtr->setDispatchQueue(dispatchQueuePtr);
+        }
+#endif
+    }
+
     RcfSessionPtr Subscription::getRcfSessionPtr()
     {
         RecursiveLock lock(mMutex);
@@ -203,7 +329,8 @@ namespace RCF {
         RcfClientPtr                        rcfClientPtr,
         OnSubscriptionDisconnect            onDisconnect,
         std::uint32_t                     pubToSubPingIntervalMs,
-        bool                                pingsEnabled)
+        bool                                pingsEnabled,
+        MulticastReceiverPtr                multicastReceiverPtr)
     {
         if ( ret != RcfError_Ok_Id )
         {
@@ -266,6 +393,8 @@ namespace RCF {
 
         subscriptionPtr->mPublisherSupportsPubSubPings = pingsEnabled;
 
+        subscriptionPtr->mMulticastReceiverPtr = multicastReceiverPtr;
+
         Lock lock(mSubscriptionsMutex);
         mSubscriptions.insert(subscriptionPtr);
 
@@ -276,9 +405,11 @@ namespace RCF {
     std::int32_t SubscriptionService::doRequestSubscription(
         ClientStub &            clientStubOrig, 
         const std::string &     publisherName,
+        const SubscriptionFilter & filter,
         std::uint32_t subToPubPingIntervalMs, 
         std::uint32_t &       pubToSubPingIntervalMs,
-        bool &                  pingsEnabled)
+        bool &                  pingsEnabled,
+        bool &                  multicastDelivery)
     {
         I_RcfClient client("", clientStubOrig);
         ClientStub & clientStub = client.getClientStub();
@@ -290,7 +421,9 @@ namespace RCF {
         OobRequestSubscription msg(
             clientStubOrig.getRuntimeVersion(), 
             publisherName, 
-            subToPubPingIntervalMs);
+            subToPubPingIntervalMs,
+            filter,
+            multicastDelivery);
 
         ByteBuffer controlRequest;
         msg.encodeRequest(controlRequest);
@@ -306,6 +439,7 @@ namespace RCF {
 
         std::int32_t ret = msg.mResponseError;
         pubToSubPingIntervalMs = msg.mPubToSubPingIntervalMs;
+        multicastDelivery = msg.mMulticastDelivery;
 
         clientStubOrig.setTransport( client.getClientStub().releaseTransport() );
 
@@ -350,6 +484,8 @@ namespace RCF {
         // First round trip, to do version negotiation with the server.
         clientStub.ping();
 
+        MulticastReceiverPtr multicastReceiverPtr;
+
         if ( clientStub.getRuntimeVersion() <= 11 )
         {
             ret = doRequestSubscription_Legacy(
@@ -361,12 +497,24 @@ namespace RCF {
         }
         else
         {
+            // The receiver is started before subscribing, so no message published after the subscription is 
+            // established, is missed.
+            multicastReceiverPtr = createMulticastReceiver(rcfClientPtr, parms, publisherName);
+            bool multicastDelivery = multicastReceiverPtr.get() != NULL;
+
             ret = doRequestSubscription(
                 clientStub,
                 publisherName,
+                parms.mFilter,
                 subToPubPingIntervalMs,
                 pubToSubPingIntervalMs,
-                pingsEnabled);
+                pingsEnabled,
+                multicastDelivery);
+
+            if (!multicastDelivery)
+            {
+                multicastReceiverPtr.reset();
+            }
         }
 
         SubscriptionPtr subscriptionPtr = onRequestSubscriptionCompleted(
@@ -376,7 +524,14 @@ namespace RCF {
             rcfClientPtr,
             onDisconnect,
             pubToSubPingIntervalMs,
-            pingsEnabled);
+            pingsEnabled,
+            multicastReceiverPtr);
+
+        SubscriptionDispatchQueuePtr dispatchQueuePtr = createDispatchQueue(rcfClientPtr, parms);
+        if (dispatchQueuePtr)
+        {
+            subscriptionPtr->setDispatchQueue(dispatchQueuePtr);
+        }
 
         return subscriptionPtr;
     }
@@ -390,7 +545,8 @@ namespace RCF {
         OnSubscriptionDisconnect        onDisconnect,
         OnAsyncSubscribeCompleted       onCompletion,
         std::uint32_t                 incomingPingIntervalMs,
-        bool                            pingsEnabled)
+        bool                            pingsEnabled,
+        MulticastReceiverPtr            multicastReceiverPtr)
     {
         SubscriptionPtr subscriptionPtr;
 
@@ -408,7 +564,8 @@ namespace RCF {
                 rcfClientPtr,
                 onDisconnect,
                 incomingPingIntervalMs,
-                pingsEnabled);
+                pingsEnabled,
+                multicastReceiverPtr);
         }
 
         onCompletion(subscriptionPtr, ePtr);
@@ -420,7 +577,8 @@ namespace RCF {
         const std::string &             publisherName,
         RcfClientPtr                    rcfClientPtr,
         OnSubscriptionDisconnect        onDisconnect,
-        OnAsyncSubscribeCompleted       onCompletion)
+        OnAsyncSubscribeCompleted       onCompletion,
+        MulticastReceiverPtr            multicastReceiverPtr)
     {
         bool pingsEnabled = true;
 
@@ -440,6 +598,11 @@ namespace RCF {
 
             ret = msg.mResponseError; 
             pubToSubPingIntervalMs = msg.mPubToSubPingIntervalMs;
+
+            if (!msg.mMulticastDelivery)
+            {
+                multicastReceiverPtr.reset();
+            }
         }
 
         createSubscriptionImplEnd(
@@ -451,14 +614,16 @@ namespace RCF {
             onDisconnect, 
             onCompletion, 
             pubToSubPingIntervalMs, 
-            pingsEnabled);
+            pingsEnabled,
+            multicastReceiverPtr);
     }
 
     void SubscriptionService::doRequestSubscriptionAsync(
         ClientStub &            clientStubOrig, 
         const std::string &     publisherName,
         RcfClientPtr            rcfClientPtr,
-        const SubscriptionParms & parms)
+        const SubscriptionParms & parms,
+        OnAsyncSubscribeCompleted onCompletion)
     {
         RcfClientPtr requestClientPtr( new I_RcfClient("", clientStubOrig) );
         requestClientPtr->getClientStub().setTransport( clientStubOrig.releaseTransport() );
@@ -472,12 +637,16 @@ namespace RCF {
             subToPubPingIntervalMs = 0;
         }
 
+        MulticastReceiverPtr multicastReceiverPtr = createMulticastReceiver(rcfClientPtr, parms, publisherName);
+
         // Set OOB request.
 
         OobRequestSubscription msg(
             clientStubOrig.getRuntimeVersion(), 
             publisherName, 
-            subToPubPingIntervalMs);
+            subToPubPingIntervalMs,
+            parms.mFilter,
+            multicastReceiverPtr.get() != NULL);
 
         ByteBuffer controlRequest;
         msg.encodeRequest(controlRequest);
@@ -492,7 +661,83 @@ namespace RCF {
             publisherName,
             rcfClientPtr,
             parms.mOnDisconnect,
-            parms.mOnAsyncSubscribeCompleted )));
+            onCompletion,
+            multicastReceiverPtr )));
+    }
+
+    MulticastReceiverPtr SubscriptionService::createMulticastReceiver(
+        RcfClientPtr                rcfClientPtr,
+        const SubscriptionParms &   parms,
+        const std::string &         publisherName)
+    {
+        MulticastReceiverPtr multicastReceiverPtr;
+
+        if (!parms.mMulticastEndpointPtr)
+        {
+            return multicastReceiverPtr;
+        }
+
+#if RCF_FEATURE_UDP==1
+
+        // Retransmit requests go on a connection of their own, to the publisher endpoint.
+        RcfClientPtr retransmitClientPtr;
+        if (parms.mMulticastRetransmit && parms.mClientStub.getEndpoint())
+        {
+            retransmitClientPtr.reset( new I_RcfClient("", parms.mClientStub) );
+        }
+
+        multicastReceiverPtr.reset( new MulticastReceiver(
+            *mpServer,
+            *parms.mMulticastEndpointPtr,
+            rcfClientPtr,
+            publisherName,
+            parms.mFilter,
+            retransmitClientPtr) );
+
+        multicastReceiverPtr->start();
+
+#else
+
+        RCF_UNUSED_VARIABLE(rcfClientPtr);
+        RCF_UNUSED_VARIABLE(publisherName);
+        RCF_THROW( Exception(RcfError_NotSupportedInThisBuild, "UDP multicast subscriptions") );
+
+#endif
+
+        return multicastReceiverPtr;
+    }
+
+    SubscriptionDispatchQueuePtr SubscriptionService::createDispatchQueue(
+        RcfClientPtr                rcfClientPtr,
+        const SubscriptionParms &   parms)
+    {
+        SubscriptionDispatchQueuePtr dispatchQueuePtr;
+
+        if (parms.mDispatcherPtr)
+        {
+            dispatchQueuePtr.reset( new SubscriptionDispatchQueue(
+                *mpServer,
+                parms.mDispatcherPtr,
+                parms.mDispatchOrdering,
+                parms.mDispatchQueueLimit,
+                rcfClientPtr) );
+        }
+
+        return dispatchQueuePtr;
+    }
+
+    void SubscriptionService::onAsyncSubscribeCompleted(
+        SubscriptionPtr                 subscriptionPtr,
+        ExceptionPtr                    ePtr,
+        SubscriptionDispatchQueuePtr    dispatchQueuePtr,
+        OnAsyncSubscribeCompleted       onCompletion)
+    {
+        if (subscriptionPtr)
+        {
+            subscriptionPtr->setDispatchQueue(dispatchQueuePtr);
+        }
+
+        onCompletion(subscriptionPtr, ePtr);
     }
 
     void SubscriptionService::createSubscriptionImplBegin(
@@ -512,13 +757,27 @@ namespace RCF {
         
         RCF_ASSERT(onCompletion);
 
+        // The dispatch queue is attached to the subscription before the completion callback is called.
+        SubscriptionDispatchQueuePtr dispatchQueuePtr = createDispatchQueue(rcfClientPtr, parms);
+        if (dispatchQueuePtr)
+        {
+            onCompletion = std::bind(
+                &SubscriptionService::onAsyncSubscribeCompleted,
+                this,
+                std::placeholders::_1,
+                std::placeholders::_2,
+                dispatchQueuePtr,
+                onCompletion);
+        }
+
         if ( clientStub.getRuntimeVersion() <= 11 )
         {
             doRequestSubscriptionAsync_Legacy(
                 clientStub,
                 publisherName,
                 rcfClientPtr,
-                parms);
+                parms,
+                onCompletion);
         }
         else
         {
@@ -526,7 +785,8 @@ namespace RCF {
                 clientStub, 
                 publisherName, 
                 rcfClientPtr,
-                parms);
+                parms,
+                onCompletion);
         }
     }
 
@@ -47,12 +47,14 @@ namespace RCF
         ClientStub &                    clientStubOrig,
         const std::string &             publisherName,
         RcfClientPtr                    rcfClientPtr,
-        const SubscriptionParms &       parms)
+        const SubscriptionParms &       parms,
+        OnAsyncSubscribeCompleted       onCompletion)
     {
         RCF_UNUSED_VARIABLE(clientStubOrig);
         RCF_UNUSED_VARIABLE(publisherName);
         RCF_UNUSED_VARIABLE(rcfClientPtr);
         RCF_UNUSED_VARIABLE(parms);
+        RCF_UNUSED_VARIABLE(onCompletion);
 
         RCF_THROW(Exception(
             RcfError_NotSupportedInThisBuild, "Legacy subscription request"));
@@ -180,7 +182,8 @@ namespace RCF
         ClientStub &            clientStubOrig,
         const std::string &     publisherName,
         RcfClientPtr            rcfClientPtr,
-        const SubscriptionParms & parms)
+        const SubscriptionParms & parms,
+        OnAsyncSubscribeCompleted onCompletion)
     {
         typedef RcfClient<I_RequestSubscription> AsyncClient;
         typedef std::shared_ptr<AsyncClient> AsyncClientPtr;
@@ -211,7 +214,7 @@ namespace RCF
                     publisherName,
                     rcfClientPtr,
                     parms.mOnDisconnect,
-                    parms.mOnAsyncSubscribeCompleted,
+                    onCompletion,
                     incomingPingIntervalMs,
                     pingsEnabled)),
 
@@ -231,7 +234,7 @@ namespace RCF
                     publisherName,
                     rcfClientPtr,
                     parms.mOnDisconnect,
-                    parms.mOnAsyncSubscribeCompleted,
+                    onCompletion,
                     incomingPingIntervalMs,
                     pingsEnabled)),
 
@@ -160,6 +160,9 @@ namespace RCF {
 #endif
 
     // returns -2 for timeout, -1 for error, otherwise number of bytes sent (> 0)
+    // Maximum number of buffers passed to a single send call.
+    static const std::size_t MaxSendBuffers = 64;
+
     int timedSend(
         I_PollingFunctor &pollingFunctor,
         int &err,
@@ -184,6 +187,12 @@ namespace RCF {
                 bytesSent,
                 bytesToSend);
 
+            // Messages with chunked framing can consist of more buffers than a single call can send.
+            if (wsabufs.size() > MaxSendBuffers)
+            {
+                wsabufs.resize(MaxSendBuffers);
+            }
+
             int count = 0;
             int myErr = 0;
 
@@ -27,7 +27,7 @@ namespace RCF {
 
     // Runtime versioning.
 
-    const std::uint32_t gRuntimeVersionInherent = 13;
+    const std::uint32_t gRuntimeVersionInherent = 14;
 
     std::uint32_t gRuntimeVersionDefault = gRuntimeVersionInherent;
 
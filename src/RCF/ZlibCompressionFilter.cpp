@@ -147,6 +147,82 @@ namespace RCF {
         }
     }
 
+    bool zlibCompress(const ByteBuffer & data, ByteBuffer & compressed, std::size_t maxLength)
+    {
+        ZlibDll & zlibDll = globals().getZlibDll();
+
+        z_stream cstream;
+        memset(&cstream, 0, sizeof(cstream));
+        int zErr = zlibDll.pfn_deflateInit_(&cstream, Z_BEST_SPEED, ZLIB_VERSION, sizeof(cstream));
+
+        RCF_VERIFY(
+            zErr == Z_OK,
+            Exception(RcfError_Zlib, "deflateInit()", zlibError(zErr)));
+
+        ByteBuffer buffer(maxLength);
+        cstream.next_in = (Bytef*) data.getPtr();
+        cstream.avail_in = static_cast<uInt>(data.getLength());
+        cstream.next_out = (Bytef*) buffer.getPtr();
+        cstream.avail_out = static_cast<uInt>(buffer.getLength());
+
+        zErr = zlibDll.pfn_deflate(&cstream, Z_FINISH);
+        std::size_t compressedLength = cstream.total_out;
+        zlibDll.pfn_deflateEnd(&cstream);
+
+        // If the output buffer fills up first, deflate() returns Z_OK or Z_BUF_ERROR.
+        RCF_VERIFY(
+            zErr == Z_STREAM_END || zErr == Z_OK || zErr == Z_BUF_ERROR,
+            Exception(RcfError_Zlib, "deflate()", zlibError(zErr)));
+
+        if (zErr != Z_STREAM_END)
+        {
+            return false;
+        }
+
+        compressed = ByteBuffer(buffer, 0, compressedLength);
+        return true;
+    }
+
+    void zlibDecompress(const ByteBuffer & compressed, ByteBuffer & data, std::size_t length)
+    {
+        ZlibDll & zlibDll = globals().getZlibDll();
+
+        z_stream dstream;
+        memset(&dstream, 0, sizeof(dstream));
+        int zErr = zlibDll.pfn_inflateInit_(&dstream, ZLIB_VERSION, sizeof(dstream));
+
+        RCF_VERIFY(
+            zErr == Z_OK,
+            Exception(RcfError_Zlib, "inflateInit()", zlibError(zErr)));
+
+        // Deflate can't do better than about 1032:1, so anything claiming more is corrupt, 
+        // and is rejected before allocating for it.
+        const std::size_t MaxCompressionRatio = 1032;
+        if (length > compressed.getLength() * MaxCompressionRatio)
+        {
+            zlibDll.pfn_inflateEnd(&dstream);
+            Exception e(RcfError_ZlibInflate, "Invalid decompressed length.");
+            RCF_THROW(e);
+        }
+
+        ByteBuffer buffer(length);
+        dstream.next_in = (Bytef*) compressed.getPtr();
+        dstream.avail_in = static_cast<uInt>(compressed.getLength());
+        dstream.next_out = (Bytef*) buffer.getPtr();
+        dstream.avail_out = static_cast<uInt>(buffer.getLength());
+
+        zErr = zlibDll.pfn_inflate(&dstream, Z_FINISH);
+        std::size_t decompressedLength = dstream.total_out;
+        zlibDll.pfn_inflateEnd(&dstream);
+
+        // Anything other than a complete stream of the expected length, is corrupt.
+        RCF_VERIFY(
+            zErr == Z_STREAM_END && decompressedLength == length,
+            Exception(RcfError_ZlibInflate, zlibError(zErr)));
+
+        data = buffer;
+    }
+
     class ZlibCompressionReadFilter
     {
     public:
@@ -0,0 +1,451 @@
+
+//******************************************************************************
+// RCF - Remote Call Framework
+//
+// Copyright (c) 2005 - 2020, Delta V Software. All rights reserved.
+// http://www.deltavsoft.com
+//
+// RCF is distributed under dual licenses - closed source or GPL.
+// Consult your particular license for conditions of use.
+//
+// If you have not purchased a commercial license, you are using RCF
+// under GPL terms.
+//
+// Version: 3.2
+// Contact: support <at> deltavsoft.com
+//
+//******************************************************************************
+
+#include <SF/MappedBinaryStream.hpp>
+
+#include <climits>
+
+#include <RCF/BsdSockets.hpp>
+#include <RCF/Exception.hpp>
+
+#ifdef RCF_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SF {
+
+    static void throwFileError(const RCF::ErrorMsg & msg, const RCF::Path & filePath)
+    {
+        std::string errorString = Platform::OS::GetErrorString();
+        RCF_THROW(RCF::Exception(msg, filePath.string(), errorString));
+    }
+
+    // MappedFile
+
+    MappedFile::MappedFile() :
+        mWrite(false),
+        mpData(NULL),
+        mSize(0),
+#ifdef RCF_WINDOWS
+        mhFile(NULL),
+        mhMapping(NULL)
+#else
+        mFd(-1)
+#endif
+    {
+    }
+
+    MappedFile::~MappedFile()
+    {
+        RCF_DTOR_BEGIN
+            close(mSize);
+        RCF_DTOR_END
+    }
+
+    bool MappedFile::isOpen() const
+    {
+#ifdef RCF_WINDOWS
+        return mhFile != NULL;
+#else
+        return mFd != -1;
+#endif
+    }
+
+    char * MappedFile::getPtr() const
+    {
+        return mpData;
+    }
+
+    std::uint64_t MappedFile::getSize() const
+    {
+        return mSize;
+    }
+
+    void MappedFile::openRead(const RCF::Path & filePath)
+    {
+        close();
+
+        mFilePath = filePath;
+        mWrite = false;
+
+#ifdef RCF_WINDOWS
+
+        HANDLE hFile = CreateFileW(
+            filePath.wstring().c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            NULL,
+            OPEN_EXISTING,
+            FILE_FLAG_SEQUENTIAL_SCAN,
+            NULL);
+
+        if (hFile == INVALID_HANDLE_VALUE)
+        {
+            throwFileError(RCF::RcfError_FileOpen, mFilePath);
+        }
+        mhFile = hFile;
+
+        LARGE_INTEGER fileSize = {0};
+        if (!GetFileSizeEx(hFile, &fileSize))
+        {
+            throwFileError(RCF::RcfError_FileRead, mFilePath);
+        }
+        mSize = static_cast<std::uint64_t>(fileSize.QuadPart);
+
+#else
+
+        mFd = ::open(filePath.string().c_str(), O_RDONLY);
+        if (mFd == -1)
+        {
+            throwFileError(RCF::RcfError_FileOpen, mFilePath);
+        }
+
+        struct stat st;
+        if (fstat(mFd, &st) != 0)
+        {
+            throwFileError(RCF::RcfError_FileRead, mFilePath);
+        }
+        mSize = static_cast<std::uint64_t>(st.st_size);
+
+#endif
+
+        map();
+    }
+
+    void MappedFile::openWrite(const RCF::Path & filePath, std::uint64_t initialSize)
+    {
+        close();
+
+        mFilePath = filePath;
+        mWrite = true;
+
+#ifdef RCF_WINDOWS
+
+        HANDLE hFile = CreateFileW(
+            filePath.wstring().c_str(),
+            GENERIC_READ | GENERIC_WRITE,
+            0,
+            NULL,
+            CREATE_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL,
+            NULL);
+
+        if (hFile == INVALID_HANDLE_VALUE)
+        {
+            throwFileError(RCF::RcfError_FileOpen, mFilePath);
+        }
+        mhFile = hFile;
+
+#else
+
+        mFd = ::open(filePath.string().c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+        if (mFd == -1)
+        {
+            throwFileError(RCF::RcfError_FileOpen, mFilePath);
+        }
+
+#endif
+
+        resize(initialSize);
+    }
+
+    void MappedFile::resize(std::uint64_t newSize)
+    {
+        RCF_ASSERT(isOpen() && mWrite);
+
+        unmap();
+        if (!setFileSize(newSize))
+        {
+            throwFileError(RCF::RcfError_FileWrite, mFilePath);
+        }
+        mSize = newSize;
+        map();
+    }
+
+    void MappedFile::close(std::uint64_t finalSize)
+    {
+        if (!isOpen())
+        {
+            return;
+        }
+
+        unmap();
+
+        bool ok = !mWrite || setFileSize(finalSize);
+        int err = Platform::OS::BsdSockets::GetLastError();
+
+#ifdef RCF_WINDOWS
+        CloseHandle(mhFile);
+        mhFile = NULL;
+#else
+        ::close(mFd);
+        mFd = -1;
+#endif
+
+        mSize = 0;
+
+        if (!ok)
+        {
+            RCF_THROW(RCF::Exception(
+                RCF::RcfError_FileWrite, 
+                mFilePath.string(), 
+                Platform::OS::GetErrorString(err)));
+        }
+    }
+
+    void MappedFile::map()
+    {
+        RCF_ASSERT(!mpData);
+
+        if (mSize == 0)
+        {
+            return;
+        }
+
+        if (mSize > std::uint64_t(std::size_t(-1)))
+        {
+            RCF_THROW(RCF::Exception(
+                RCF::RcfError_FileOpen, 
+                mFilePath.string(), 
+                "File is too large to map into the address space."));
+        }
+
+#ifdef RCF_WINDOWS
+
+        HANDLE hMapping = CreateFileMappingW(
+            mhFile,
+            NULL,
+            mWrite ? PAGE_READWRITE : PAGE_READONLY,
+            static_cast<DWORD>(mSize >> 32),
+            static_cast<DWORD>(mSize & 0xFFFFFFFF),
+            NULL);
+
+        if (!hMapping)
+        {
+            throwFileError(RCF::RcfError_FileOpen, mFilePath);
+        }
+        mhMapping = hMapping;
+
+        void * pv = MapViewOfFile(hMapping, mWrite ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+        if (!pv)
+        {
+            throwFileError(RCF::RcfError_FileOpen, mFilePath);
+        }
+        mpData = static_cast<char *>(pv);
+
+#else
+
+        void * pv = mmap(
+            NULL, 
+            static_cast<std::size_t>(mSize), 
+            mWrite ? PROT_READ | PROT_WRITE : PROT_READ, 
+            MAP_SHARED, 
+            mFd, 
+            0);
+
+        if (pv == MAP_FAILED)
+        {
+            throwFileError(RCF::RcfError_FileOpen, mFilePath);
+        }
+        mpData = static_cast<char *>(pv);
+
+        // Archives are read and written front to back. This is only a hint, so failures are ignored.
+        madvise(pv, static_cast<std::size_t>(mSize), MADV_SEQUENTIAL);
+
+#endif
+
+    }
+
+    void MappedFile::unmap()
+    {
+
+#ifdef RCF_WINDOWS
+
+        if (mpData)
+        {
+            UnmapViewOfFile(mpData);
+        }
+        if (mhMapping)
+        {
+            CloseHandle(mhMapping);
+            mhMapping = NULL;
+        }
+
+#else
+
+        if (mpData)
+        {
+            munmap(mpData, static_cast<std::size_t>(mSize));
+        }
+
+#endif
+
+        mpData = NULL;
+    }
+
+    bool MappedFile::setFileSize(std::uint64_t size)
+    {
+
+#ifdef RCF_WINDOWS
+
+        LARGE_INTEGER pos = {0};
+        pos.QuadPart = static_cast<LONGLONG>(size);
+        return 
+                SetFilePointerEx(mhFile, pos, NULL, FILE_BEGIN) 
+            &&  SetEndOfFile(mhFile);
+
+#else
+
+        return ftruncate(mFd, static_cast<off_t>(size)) == 0;
+
+#endif
+
+    }
+
+    // MappedOstreamBuf
+
+    MappedOstreamBuf::MappedOstreamBuf(MappedFile & file) : mFile(file)
+    {
+    }
+
+    void MappedOstreamBuf::reset()
+    {
+        setPutArea(0);
+    }
+
+    std::uint64_t MappedOstreamBuf::getWritePos() const
+    {
+        return static_cast<std::uint64_t>(pptr() - pbase());
+    }
+
+    void MappedOstreamBuf::setPutArea(std::uint64_t pos)
+    {
+        char * pBegin = mFile.getPtr();
+        char * pEnd = pBegin + static_cast<std::size_t>(mFile.getSize());
+        setp(pBegin, pEnd);
+
+        // pbump() takes an int, so large positions are applied in steps.
+        while (pos > 0)
+        {
+            int step = static_cast<int>( RCF_MIN(pos, std::uint64_t(INT_MAX)) );
+            pbump(step);
+            pos -= step;
+        }
+    }
+
+    MappedOstreamBuf::int_type MappedOstreamBuf::overflow(int_type ch)
+    {
+        if (traits_type::eq_int_type(ch, traits_type::eof()))
+        {
+            return traits_type::not_eof(ch);
+        }
+
+        // Double the file, and map it again.
+        std::uint64_t pos = getWritePos();
+        std::uint64_t newSize = RCF_MAX(2*mFile.getSize(), pos + 4096);
+        mFile.resize(newSize);
+        setPutArea(pos);
+
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+        return ch;
+    }
+
+    MappedOstreamBuf::pos_type MappedOstreamBuf::seekoff(
+        off_type                    off, 
+        std::ios_base::seekdir      dir,
+        std::ios_base::openmode     mode)
+    {
+        if (off == 0 && dir == std::ios::cur && (mode & std::ios::out))
+        {
+            return pos_type( static_cast<off_type>(getWritePos()) );
+        }
+        return pos_type(-1);
+    }
+
+    // IMappedBinaryStream
+
+    IMappedBinaryStream::IMappedBinaryStream(const RCF::Path & filePath)
+    {
+        mFile.openRead(filePath);
+
+        std::size_t fileSize = static_cast<std::size_t>(mFile.getSize());
+        mIs.reset(mFile.getPtr(), fileSize);
+        setIs(mIs, fileSize);
+    }
+
+    IMappedBinaryStream::~IMappedBinaryStream()
+    {
+    }
+
+    void IMappedBinaryStream::close()
+    {
+        mIs.reset(NULL, 0);
+        mFile.close();
+    }
+
+    std::uint64_t IMappedBinaryStream::getFileSize() const
+    {
+        return mFile.getSize();
+    }
+
+    // OMappedBinaryStream
+
+    OMappedBinaryStream::OMappedBinaryStream(
+        const RCF::Path &   filePath, 
+        std::uint64_t       initialSize) :
+            mBuf(mFile),
+            mOs(&mBuf),
+            mBytesWritten(0)
+    {
+        // Report file errors from the stream buffer, rather than just failing the write.
+        mOs.exceptions(std::ios::badbit);
+
+        mFile.openWrite(filePath, initialSize);
+        mBuf.reset();
+        setOs(mOs);
+    }
+
+    OMappedBinaryStream::~OMappedBinaryStream()
+    {
+        RCF_DTOR_BEGIN
+            close();
+        RCF_DTOR_END
+    }
+
+    void OMappedBinaryStream::close()
+    {
+        if (mFile.isOpen())
+        {
+            mBytesWritten = mBuf.getWritePos();
+            mFile.close(mBytesWritten);
+            mBuf.reset();
+        }
+    }
+
+    std::uint64_t OMappedBinaryStream::getBytesWritten() const
+    {
+        return mFile.isOpen() ? mBuf.getWritePos() : mBytesWritten;
+    }
+
+} // namespace SF
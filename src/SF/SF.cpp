@@ -21,6 +21,7 @@
 #include "bitset.cpp"
 #include "Encoding.cpp"
 #include "I_Stream.cpp"
+#include "MappedBinaryStream.cpp"
 #include "Registry.cpp"
 #include "Serializer.cpp"
 #include "Stream.cpp"
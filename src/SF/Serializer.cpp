@@ -49,7 +49,29 @@ namespace SF {
             if (    ar.isFlagSet(Archive::POINTER) 
                 ||  (!ar.isFlagSet(Archive::PARENT) && isDerived()))
             {
-                if (pNode->type.length() > 0)
+                if (pNode->typeId != 0)
+                {
+                    // Interned type name. Resolve the serializer once per type and archive.
+                    ar.setFlag(Archive::POLYMORPHIC, true );
+                    TypeNameContextRead & ctx = ar.getIstream()->getTypeNameContext();
+                    I_SerializerPolymorphic * pSerializer = ctx.querySerializer(pNode->typeId, getTypeInfo());
+                    if (pSerializer)
+                    {
+                        setSerializerPolymorphic(pSerializer);
+                    }
+                    else
+                    {
+                        std::string derivedTypeName;
+                        ctx.query(pNode->typeId, derivedTypeName);
+                        pSerializer = getSerializerPolymorphic(derivedTypeName);
+                        ctx.addSerializer(pNode->typeId, getTypeInfo(), pSerializer);
+                    }
+                    ar.getIstream()->getLocalStorage().setNode(pNode);
+                    ar.setFlag(Archive::NODE_ALREADY_READ);
+                    invokeSerializerPolymorphic(ar);
+                    return;
+                }
+                else if (pNode->type.length() > 0)
                 {
                     ar.setFlag(Archive::POLYMORPHIC, true );
                     std::string derivedTypeName = pNode->type.cpp_str();
@@ -129,7 +151,21 @@ namespace SF {
 
         if (ar.isFlagSet(Archive::POLYMORPHIC))
         {
-            in.type.assign(getTypeName());
+            OStream & os = *ar.getOstream();
+            if (os.getRuntimeVersion() >= 14)
+            {
+                // Only the first occurrence of the type in the archive carries the type name.
+                bool isNew = false;
+                in.typeId = os.getTypeNameContext().add(getTypeInfo(), isNew);
+                if (isNew)
+                {
+                    in.type.assign(getTypeName());
+                }
+            }
+            else
+            {
+                in.type.assign(getTypeName());
+            }
         }
 
         bool bPointer = ar.isFlagSet(Archive::POINTER);
@@ -52,29 +52,22 @@ namespace SF {
     void ContextRead::add(UInt32 nid, const ObjectId &id)
     {
         RCF_ASSERT(mEnabled);
-        if (mNidToIdMap.get() == NULL)
-        {
-            mNidToIdMap.reset( new std::map<UInt32, ObjectId>());
-        }
-        (*mNidToIdMap)[nid] = id;
+        mNidToIdMap[nid] = id;
     }
 
     void ContextRead::add(void *ptr, const std::type_info &objType, void *pObj)
     {
         RCF_ASSERT(mEnabled);
-        if (mTypeToObjMap.get() == NULL)
-        {
-            mTypeToObjMap.reset( new std::map<std::string, std::map< void *, void * > >() );
-        }
-        (*mTypeToObjMap)[ objType.name() ][ ptr ] = pObj;
+        mTypeToObjMap[ TypedPtr(ptr, &objType) ] = pObj;
     }
 
     bool ContextRead::query(UInt32 nid, ObjectId &id)
     {
         RCF_ASSERT(mEnabled);
-        if (mNidToIdMap.get() && mNidToIdMap->find( nid ) != mNidToIdMap->end())
+        ObjectId * pId = mNidToIdMap.find(nid);
+        if (pId)
         {
-            id = (*mNidToIdMap)[ nid ];
+            id = *pId;
             return true;
         }
         else
@@ -86,10 +79,10 @@ namespace SF {
     bool ContextRead::query(void *ptr, const std::type_info &objType, void *&pObj)
     {
         RCF_ASSERT(mEnabled);
-        if (mTypeToObjMap.get() &&
-            (*mTypeToObjMap)[ objType.name() ].find(ptr) != (*mTypeToObjMap)[ objType.name() ].end() )
+        void ** ppObj = mTypeToObjMap.find( TypedPtr(ptr, &objType) );
+        if (ppObj)
         {
-            pObj = (*mTypeToObjMap)[ objType.name() ][ ptr ];
+            pObj = *ppObj;
             return true;
         }
         else
@@ -100,14 +93,8 @@ namespace SF {
 
     void ContextRead::clear()
     {
-        if (mNidToIdMap.get())
-        {
-            mNidToIdMap->clear();
-        }
-        if (mTypeToObjMap.get())
-        {
-            mTypeToObjMap->clear();
-        }
+        mNidToIdMap.clear();
+        mTypeToObjMap.clear();
     }
 
     // ContextWrite
@@ -123,10 +110,6 @@ namespace SF {
     void ContextWrite::setEnabled(bool enabled)
     {
         mEnabled = enabled;
-        if (mEnabled && mIdToNidMap.get() == NULL)
-        {
-            mIdToNidMap.reset( new std::map<ObjectId, UInt32>());
-        }
     }
 
     bool ContextWrite::getEnabled() const
@@ -138,36 +121,168 @@ namespace SF {
     {
         if (mEnabled)
         {
-            if (mIdToNidMap->find( id ) != mIdToNidMap->end())
+            bool inserted = false;
+            nid = mIdToNidMap.insert( TypedPtr(id.first, id.second), mCurrentId, inserted);
+            if (inserted)
             {
-                nid = (*mIdToNidMap)[ id ];
+                ++mCurrentId;
             }
-            else
+        }
+    }
+
+    bool ContextWrite::query(const ObjectId &id, UInt32 &nid)
+    {
+        if (mEnabled)
+        {
+            UInt32 * pNid = mIdToNidMap.find( TypedPtr(id.first, id.second) );
+            if (pNid)
             {
-                nid = (*mIdToNidMap)[ id ] = mCurrentId++;
+                nid = *pNid;
+                return true;
             }
         }
+        return false;
     }
-    bool ContextWrite::query(const ObjectId &id, UInt32 &nid)
+
+    void ContextWrite::clear()
     {
-        if ( mEnabled && mIdToNidMap->find( id ) != mIdToNidMap->end() )
+        mIdToNidMap.clear();
+        mCurrentId = 1;
+    }
+
+    // TypeNameContextRead
+
+    TypeNameContextRead::TypeNameContextRead() : mEntryCount(0)
+    {}
+
+    TypeNameContextRead::~TypeNameContextRead()
+    {}
+
+    TypeNameContextRead::Entry * TypeNameContextRead::getEntry(UInt32 typeId)
+    {
+        if (typeId == 0 || typeId > mEntryCount)
         {
-            nid = (*mIdToNidMap)[ id ];
-            return true;
+            RCF::Exception e(RCF::RcfError_SfDataFormat);
+            RCF_THROW(e);
         }
-        else
+        return &mEntries[typeId-1];
+    }
+
+    void TypeNameContextRead::add(UInt32 typeId, const std::string & typeName)
+    {
+        // Type id's are allocated sequentially by the writer.
+        if (typeId != mEntryCount + 1)
+        {
+            RCF::Exception e(RCF::RcfError_SfDataFormat);
+            RCF_THROW(e);
+        }
+
+        // Entries are recycled across archives, to avoid reallocating.
+        if (mEntryCount == mEntries.size())
+        {
+            mEntries.resize(mEntryCount + 1);
+        }
+
+        Entry & entry = mEntries[mEntryCount++];
+        entry.mTypeName = typeName;
+        entry.mSerializers.clear();
+        entry.mpAnySerializer = NULL;
+    }
+
+    bool TypeNameContextRead::contains(UInt32 typeId) const
+    {
+        return 0 < typeId && typeId <= mEntryCount;
+    }
+
+    bool TypeNameContextRead::query(UInt32 typeId, std::string & typeName)
+    {
+        if (typeId == 0 || typeId > mEntryCount)
         {
             return false;
         }
+        typeName = mEntries[typeId-1].mTypeName;
+        return true;
     }
 
-    void ContextWrite::clear()
+    void TypeNameContextRead::addSerializer(
+        UInt32                      typeId, 
+        const std::type_info &      baseType, 
+        I_SerializerPolymorphic *   pSerializer)
+    {
+        Entry * pEntry = getEntry(typeId);
+        pEntry->mSerializers.push_back( std::make_pair(&baseType, pSerializer) );
+    }
+
+    I_SerializerPolymorphic * TypeNameContextRead::querySerializer(
+        UInt32                      typeId, 
+        const std::type_info &      baseType)
     {
-        if (mIdToNidMap.get())
+        Entry * pEntry = getEntry(typeId);
+        for (std::size_t i=0; i<pEntry->mSerializers.size(); ++i)
         {
-            mIdToNidMap->clear();
+            if (*pEntry->mSerializers[i].first == baseType)
+            {
+                return pEntry->mSerializers[i].second;
+            }
         }
-        mCurrentId = 1;
+        return NULL;
+    }
+
+    void TypeNameContextRead::addAnySerializer(UInt32 typeId, I_SerializerAny * pSerializer)
+    {
+        getEntry(typeId)->mpAnySerializer = pSerializer;
+    }
+
+    I_SerializerAny * TypeNameContextRead::queryAnySerializer(UInt32 typeId)
+    {
+        return getEntry(typeId)->mpAnySerializer;
+    }
+
+    void TypeNameContextRead::clear()
+    {
+        mEntryCount = 0;
+    }
+
+    // TypeNameContextWrite
+
+    TypeNameContextWrite::TypeNameContextWrite()
+    {}
+
+    TypeNameContextWrite::~TypeNameContextWrite()
+    {}
+
+    UInt32 TypeNameContextWrite::add(const std::type_info & type, bool & isNew)
+    {
+        // Archives typically contain only a handful of distinct polymorphic types.
+        for (std::size_t i=0; i<mTypes.size(); ++i)
+        {
+            if (*mTypes[i].first == type)
+            {
+                isNew = false;
+                return static_cast<UInt32>(i+1);
+            }
+        }
+
+        mTypes.push_back( std::make_pair(&type, (I_SerializerAny *) NULL) );
+        isNew = true;
+        return static_cast<UInt32>(mTypes.size());
+    }
+
+    void TypeNameContextWrite::addAnySerializer(UInt32 typeId, I_SerializerAny * pSerializer)
+    {
+        RCF_ASSERT(0 < typeId && typeId <= mTypes.size());
+        mTypes[typeId-1].second = pSerializer;
+    }
+
+    I_SerializerAny * TypeNameContextWrite::queryAnySerializer(UInt32 typeId)
+    {
+        RCF_ASSERT(0 < typeId && typeId <= mTypes.size());
+        return mTypes[typeId-1].second;
+    }
+
+    void TypeNameContextWrite::clear()
+    {
+        mTypes.clear();
     }
 
     // LocalStorage
@@ -282,6 +397,7 @@ namespace SF {
     void IStream::clearState() 
     { 
         getTrackingContext().clear();
+        getTypeNameContext().clear();
     }
 
     bool IStream::begin(Node &node)
@@ -323,7 +439,20 @@ namespace SF {
 #pragma warning( push )
 #pragma warning( disable : 4996 )  // warning C4996: 'std::basic_istream<_Elem,_Traits>::readsome': Function call with parameters that may be unsafe - this call relies on the caller to check that the passed values are correct. To disable this warning, use -D_SCL_SECURE_NO_WARNINGS. See documentation on how to use Visual C++ 'Checked Iterators'
 #endif
-                    std::size_t bytesRead = static_cast<std::size_t>(mpIs->readsome(buffer, BufferLen));
+                    // The metadata may straddle two chunks of a chunked message, so keep reading until 
+                    // there is no more data.
+                    std::size_t bytesRead = 0;
+                    while (bytesRead < BufferLen)
+                    {
+                        std::size_t n = static_cast<std::size_t>(
+                            mpIs->readsome(buffer + bytesRead, BufferLen - bytesRead));
+
+                        if (n == 0)
+                        {
+                            break;
+                        }
+                        bytesRead += n;
+                    }
 
 #ifdef _MSC_VER
 #pragma warning( pop )
@@ -367,6 +496,7 @@ namespace SF {
                 {
                     read_byte( byte );
                     Byte8 attrSpec = byte;
+                    const bool hasTypeId = (attrSpec & (1<<4)) ? true : false;
 
                     // id
                     if (attrSpec & 1)
@@ -381,6 +511,12 @@ namespace SF {
                         node.ref = 1;
                     }
 
+                    // type id
+                    if (hasTypeId)
+                    {
+                        read_int(node.typeId);
+                    }
+
                     // type
                     attrSpec = attrSpec >> 1;
                     if (attrSpec & 1)
@@ -389,6 +525,12 @@ namespace SF {
                         read_int(length);
                         node.type.allocate(length);
                         read(node.type.get(), length );
+
+                        if (hasTypeId)
+                        {
+                            // First occurrence of this type in the archive.
+                            mTypeNameContextRead.add(node.typeId, node.type.cpp_str());
+                        }
                     }
 
                     // label
@@ -551,6 +693,11 @@ namespace SF {
     {
         return mContextRead;
     }
+
+    TypeNameContextRead & IStream::getTypeNameContext()
+    {
+        return mTypeNameContextRead;
+    }
     
     LocalStorage & IStream::getLocalStorage() 
     { 
@@ -630,6 +777,7 @@ namespace SF {
     void OStream::clearState() 
     { 
         getTrackingContext().clear(); 
+        getTypeNameContext().clear();
 
         mArchiveMetadataWritten = false;
     }
@@ -685,6 +833,10 @@ namespace SF {
         {
             attrSpec |= 1<<3;
         }
+        if (node.typeId != 0)
+        {
+            attrSpec |= 1<<4;
+        }
 
         write_byte( attrSpec );
 
@@ -692,6 +844,10 @@ namespace SF {
         {
             write_int(node.id);
         }
+        if (node.typeId != 0)
+        {
+            write_int(node.typeId);
+        }
         if (!node.type.empty())
         {
             write(node.type.get(), node.type.length());
@@ -836,6 +992,11 @@ namespace SF {
     { 
         return mContextWrite; 
     }
+
+    TypeNameContextWrite & OStream::getTypeNameContext()
+    {
+        return mTypeNameContextWrite;
+    }
     
     LocalStorage & OStream::getLocalStorage() 
     { 